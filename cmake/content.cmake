@@ -5,3 +5,25 @@ function(copy_content_directory CONTENT_DIR)
         ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/$<CONFIG>/${CONTENT_DIR}
     )
 endfunction(copy_content_directory CONTENT_DIR)
+
+# Packs content and the compiled shaders into one archive next to the executable, the shaders have to be built first.
+# Shaders use LZ4 as they're needed before anything is drawn, DDS textures use Zstd as they're most of the size.
+# The archive is only repacked when a content file, the shader manifest or the packer changed.
+function(pack_content_archive CONTENT_DIR SHADER_DIR)
+    set(ARCHIVE_PATH ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/$<CONFIG>/${CONTENT_DIR}.pak)
+    # The shader compiler writes the manifest on every run and runs whenever a shader changed, so it covers every .spv
+    set(SHADER_MANIFEST ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/$<CONFIG>/${SHADER_DIR}/shaders.manifest)
+    file(GLOB_RECURSE CONTENT_FILES CONFIGURE_DEPENDS "${CMAKE_CURRENT_SOURCE_DIR}/${CONTENT_DIR}/*")
+    get_property(SHADER_TARGETS GLOBAL PROPERTY COCOA_SHADER_TARGETS)
+
+    add_custom_command(OUTPUT ${ARCHIVE_PATH}
+        COMMAND $<TARGET_FILE:CocoaArchivePacker> ${ARCHIVE_PATH}
+        --compress .spv=lz4 --compress .dds=zstd
+        ${CONTENT_DIR}=${CMAKE_CURRENT_SOURCE_DIR}/${CONTENT_DIR}
+        ${SHADER_DIR}=${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/$<CONFIG>/${SHADER_DIR}
+        DEPENDS ${CONTENT_FILES} ${SHADER_MANIFEST} CocoaArchivePacker
+        COMMENT "Packing ${CONTENT_DIR} and ${SHADER_DIR} into ${ARCHIVE_PATH}"
+    )
+    add_custom_target(pack_content_${CONTENT_DIR} ALL DEPENDS ${ARCHIVE_PATH})
+    add_dependencies(pack_content_${CONTENT_DIR} ${SHADER_TARGETS})
+endfunction(pack_content_archive CONTENT_DIR SHADER_DIR)
@@ -1,27 +1,21 @@
 find_program(GLSLANG_VALIDATOR glslangValidator REQUIRED)
-function(compile_glsl_to_spirv NAME FILE_PATH OUTPUT_DIR)
-    set(SHADER_SOURCE_PATH ${CMAKE_CURRENT_SOURCE_DIR}/${FILE_PATH})
-    set(SHADER_DIST_PATH ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/$<CONFIG>/${FILE_PATH}.spv)
-    cmake_path(GET SHADER_DIST_PATH PARENT_PATH SHADER_DIST_DIR)
-
-    add_custom_target(compile_glsl_to_spirv_${NAME} ALL
-        COMMAND ${CMAKE_COMMAND} -E make_directory ${SHADER_DIST_DIR}
-        COMMAND ${CMAKE_COMMAND} -E echo "Making directory for ${NAME} at ${SHADER_DIST_PATH}"
-        COMMAND ${GLSLANG_VALIDATOR} -V ${SHADER_SOURCE_PATH} -o ${SHADER_DIST_PATH}
-        COMMENT "Compiling ${SHADER_SOURCE_PATH} to ${SHADER_DIST_PATH}" 
-    )
-endfunction(compile_glsl_to_spirv NAME FILE_PATH OUTPUT_DIR)
 
+# Compiles every shader under DIR_PATH, plus the permutations listed in "<shader>.permutations" files, into
+# OUTPUT_DIR next to the executable along with a shaders.manifest. The compiler only rebuilds outputs whose source,
+# includes or defines changed, and the command only runs when something in the directory did.
 function(compile_glsl_dir_to_spirv DIR_PATH OUTPUT_DIR)
     set(SHADER_SOURCE_DIR ${CMAKE_CURRENT_SOURCE_DIR}/${DIR_PATH})
-    file(GLOB_RECURSE SHADERS
-        "${SHADER_SOURCE_DIR}/*.vert"
-        "${SHADER_SOURCE_DIR}/*.frag"
-    )
+    set(SHADER_DIST_DIR ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/$<CONFIG>/${OUTPUT_DIR})
+    set(SHADER_MANIFEST ${SHADER_DIST_DIR}/shaders.manifest)
+    file(GLOB_RECURSE SHADER_FILES CONFIGURE_DEPENDS "${SHADER_SOURCE_DIR}/*")
+    string(MAKE_C_IDENTIFIER ${DIR_PATH} SHADER_TARGET_NAME)
 
-    foreach(SHADER ${SHADERS})
-        get_filename_component(SHADER_NAME ${SHADER} NAME)
-        file(RELATIVE_PATH SHADER_REL ${CMAKE_CURRENT_SOURCE_DIR} ${SHADER})
-        compile_glsl_to_spirv(${SHADER_NAME} ${SHADER_REL} ${OUTPUT_DIR}/${SHADER_NAME})
-    endforeach(SHADER ${SHADERS})
+    add_custom_command(OUTPUT ${SHADER_MANIFEST}
+        COMMAND $<TARGET_FILE:CocoaShaderCompiler> ${SHADER_SOURCE_DIR} ${SHADER_DIST_DIR}
+        --compiler ${GLSLANG_VALIDATOR}
+        DEPENDS CocoaShaderCompiler ${SHADER_FILES}
+        COMMENT "Compiling shaders in ${SHADER_SOURCE_DIR} to ${SHADER_DIST_DIR}"
+    )
+    add_custom_target(compile_glsl_to_spirv_${SHADER_TARGET_NAME} ALL DEPENDS ${SHADER_MANIFEST})
+    set_property(GLOBAL APPEND PROPERTY COCOA_SHADER_TARGETS compile_glsl_to_spirv_${SHADER_TARGET_NAME})
 endfunction(compile_glsl_dir_to_spirv DIR_PATH OUTPUT_DIR)
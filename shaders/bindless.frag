@@ -0,0 +1,21 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform texture2D textures[];
+layout(set = 0, binding = 1) uniform sampler samplers[];
+
+layout(push_constant) uniform Draw {
+    mat4 model;
+    uvec4 indices;
+} draw;
+
+// The indices come from push constants, so they're uniform across the draw and need no nonuniformEXT
+void main() {
+    const uint textureIndex = draw.indices.y;
+    const uint samplerIndex = draw.indices.z;
+    outColor = texture(sampler2D(textures[textureIndex], samplers[samplerIndex]), fragUV);
+}
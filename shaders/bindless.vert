@@ -0,0 +1,28 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) in vec2 inUV;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragUV;
+
+// Every storage buffer lives in the global table, the frame constants are found through draw.indices.w
+layout(set = 0, binding = 2) readonly buffer Frame {
+    mat4 view;
+    mat4 projection;
+} frames[];
+
+// x: object index, y: texture index, z: sampler index, w: frame buffer index
+layout(push_constant) uniform Draw {
+    mat4 model;
+    uvec4 indices;
+} draw;
+
+void main() {
+    const uint frame = draw.indices.w;
+    gl_Position = frames[frame].projection * frames[frame].view * draw.model * vec4(inPosition, 1.0);
+    fragColor = inColor;
+    fragUV = inUV;
+}
@@ -0,0 +1,39 @@
+#version 450
+
+// Quantized vertices, see Graphics::PackedVertex. The fixed function converts
+// snorm16/unorm8/half to floats, so only the normal needs decoding here
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec4 inColor;
+layout(location = 3) in vec2 inUV;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragUV;
+layout(location = 2) out vec3 fragNormal;
+
+layout(set = 0, binding = 0) uniform Frame {
+    mat4 view;
+    mat4 projection;
+} frame;
+
+// model already includes the mesh's dequantize transform
+// x: object index, y: texture index, zw: reserved
+layout(push_constant) uniform Draw {
+    mat4 model;
+    uvec4 indices;
+} draw;
+
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+void main() {
+    gl_Position = frame.projection * frame.view * draw.model * vec4(inPosition.xyz, 1.0);
+    fragColor = inColor;
+    fragUV = inUV;
+    // Left in mesh space, model carries the dequantize scale which would skew normals
+    fragNormal = DecodeOctahedral(inNormal);
+}
@@ -7,14 +7,19 @@ layout(location = 2) in vec2 inUV;
 layout(location = 0) out vec4 fragColor;
 layout(location = 1) out vec2 fragUV;
 
-layout(set = 0, binding = 0) uniform MVP {
-    mat4 model;
+layout(set = 0, binding = 0) uniform Frame {
     mat4 view;
     mat4 projection;
-} mvp;
+} frame;
+
+// x: object index, y: texture index, zw: reserved
+layout(push_constant) uniform Draw {
+    mat4 model;
+    uvec4 indices;
+} draw;
 
 void main() {
-    gl_Position = mvp.projection * mvp.view * mvp.model * vec4(inPosition, 1.0);
+    gl_Position = frame.projection * frame.view * draw.model * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragUV = inUV;
-}
\ No newline at end of file
+}
@@ -0,0 +1,210 @@
+#include "dds.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace Cocoa::Graphics {
+    namespace {
+        constexpr u32 Magic = 0x20534444; // "DDS "
+
+        constexpr u32 MakeFourCC(const char a, const char b, const char c, const char d)
+        {
+            return static_cast<u32>(a) | static_cast<u32>(b) << 8 | static_cast<u32>(c) << 16 |
+                   static_cast<u32>(d) << 24;
+        }
+
+        struct PixelFormat
+        {
+            u32 size;
+            u32 flags;
+            u32 fourCC;
+            u32 rgbBitCount;
+            u32 rMask;
+            u32 gMask;
+            u32 bMask;
+            u32 aMask;
+        };
+
+        struct Header
+        {
+            u32 size;
+            u32 flags;
+            u32 height;
+            u32 width;
+            u32 pitchOrLinearSize;
+            u32 depth;
+            u32 mipMapCount;
+            u32 reserved1[11];
+            PixelFormat pixelFormat;
+            u32 caps;
+            u32 caps2;
+            u32 caps3;
+            u32 caps4;
+            u32 reserved2;
+        };
+
+        struct HeaderDX10
+        {
+            u32 dxgiFormat;
+            u32 resourceDimension;
+            u32 miscFlag;
+            u32 arraySize;
+            u32 miscFlags2;
+        };
+
+        static_assert(sizeof(PixelFormat) == 32 && sizeof(Header) == 124 && sizeof(HeaderDX10) == 20);
+        static_assert(sizeof(u32) + sizeof(Header) + sizeof(HeaderDX10) == DDSMaxHeaderSize);
+
+        constexpr u32 FlagCaps = 0x1, FlagHeight = 0x2, FlagWidth = 0x4, FlagPixelFormat = 0x1000;
+        constexpr u32 FlagMipMapCount = 0x20000, FlagLinearSize = 0x80000;
+        constexpr u32 PixelFormatFourCC = 0x4, PixelFormatRGB = 0x40;
+        constexpr u32 CapsComplex = 0x8, CapsTexture = 0x1000, CapsMipMap = 0x400000;
+        constexpr u32 Caps2CubeMap = 0x200, Caps2Volume = 0x200000;
+        constexpr u32 DimensionTexture2D = 3;
+        constexpr u32 MiscTextureCube = 0x4;
+
+        struct DXGIFormat
+        {
+            u32 dxgi;
+            GPUColorFormat format;
+        };
+
+        constexpr DXGIFormat DXGIFormats[] = {
+            {28, GPUColorFormat::RGBA8_Unorm}, {29, GPUColorFormat::RGBA8_SRGB}, {71, GPUColorFormat::BC1_Unorm},
+            {72, GPUColorFormat::BC1_SRGB},    {77, GPUColorFormat::BC3_Unorm},  {78, GPUColorFormat::BC3_SRGB},
+            {80, GPUColorFormat::BC4_Unorm},   {83, GPUColorFormat::BC5_Unorm},  {98, GPUColorFormat::BC7_Unorm},
+            {99, GPUColorFormat::BC7_SRGB},
+        };
+
+        GPUColorFormat FromDXGI(const u32 dxgi)
+        {
+            for (const auto& entry : DXGIFormats) {
+                if (entry.dxgi == dxgi)
+                    return entry.format;
+            }
+            return GPUColorFormat::Unknown;
+        }
+
+        u32 ToDXGI(const GPUColorFormat format)
+        {
+            for (const auto& entry : DXGIFormats) {
+                if (entry.format == format)
+                    return entry.dxgi;
+            }
+            return 0;
+        }
+
+        GPUColorFormat FromLegacy(const PixelFormat& pixelFormat)
+        {
+            if (pixelFormat.flags & PixelFormatFourCC) {
+                switch (pixelFormat.fourCC) {
+                case MakeFourCC('D', 'X', 'T', '1'): return GPUColorFormat::BC1_Unorm;
+                case MakeFourCC('D', 'X', 'T', '5'): return GPUColorFormat::BC3_Unorm;
+                case MakeFourCC('A', 'T', 'I', '1'):
+                case MakeFourCC('B', 'C', '4', 'U'): return GPUColorFormat::BC4_Unorm;
+                case MakeFourCC('A', 'T', 'I', '2'):
+                case MakeFourCC('B', 'C', '5', 'U'): return GPUColorFormat::BC5_Unorm;
+                default:                             return GPUColorFormat::Unknown;
+                }
+            }
+
+            const bool rgba8 = (pixelFormat.flags & PixelFormatRGB) && pixelFormat.rgbBitCount == 32 &&
+                               pixelFormat.rMask == 0x000000FF && pixelFormat.gMask == 0x0000FF00 &&
+                               pixelFormat.bMask == 0x00FF0000 && pixelFormat.aMask == 0xFF000000;
+            return rgba8 ? GPUColorFormat::RGBA8_Unorm : GPUColorFormat::Unknown;
+        }
+    } // namespace
+
+    std::optional<DDSHeader> ParseDDSHeader(const std::span<const u8> file)
+    {
+        u32 magic = 0;
+        Header header{};
+        if (file.size() < sizeof(magic) + sizeof(header))
+            return std::nullopt;
+        std::memcpy(&magic, file.data(), sizeof(magic));
+        std::memcpy(&header, file.data() + sizeof(magic), sizeof(header));
+        if (magic != Magic || header.size != sizeof(Header) || header.pixelFormat.size != sizeof(PixelFormat))
+            return std::nullopt;
+        if (header.caps2 & (Caps2CubeMap | Caps2Volume) || header.width == 0 || header.height == 0)
+            return std::nullopt;
+
+        DDSHeader texture;
+        texture.dataOffset = sizeof(magic) + sizeof(header);
+        const bool dx10Header = (header.pixelFormat.flags & PixelFormatFourCC) &&
+                                header.pixelFormat.fourCC == MakeFourCC('D', 'X', '1', '0');
+        if (dx10Header) {
+            HeaderDX10 dx10{};
+            if (file.size() < texture.dataOffset + sizeof(dx10))
+                return std::nullopt;
+            std::memcpy(&dx10, file.data() + texture.dataOffset, sizeof(dx10));
+            texture.dataOffset += sizeof(dx10);
+            if (dx10.resourceDimension != DimensionTexture2D || dx10.arraySize != 1 ||
+                dx10.miscFlag & MiscTextureCube)
+                return std::nullopt;
+            texture.format = FromDXGI(dx10.dxgiFormat);
+        } else {
+            texture.format = FromLegacy(header.pixelFormat);
+        }
+        if (texture.format == GPUColorFormat::Unknown)
+            return std::nullopt;
+
+        const u32 levels = header.flags & FlagMipMapCount ? std::max(header.mipMapCount, 1u) : 1;
+        texture.layout = GetMipChainLayout(header.width, header.height, levels, texture.format);
+        if (texture.layout.levels.size() != levels)
+            return std::nullopt;
+        return texture;
+    }
+
+    std::optional<DDSTexture> ParseDDS(const std::span<const u8> file)
+    {
+        auto header = ParseDDSHeader(file);
+        if (!header || file.size() < header->dataOffset + header->layout.size)
+            return std::nullopt;
+
+        DDSTexture texture;
+        texture.format = header->format;
+        texture.layout = std::move(header->layout);
+        const auto data = file.subspan(header->dataOffset, texture.layout.size);
+        texture.data.assign(data.begin(), data.end());
+        return texture;
+    }
+
+    bool WriteDDS(const std::filesystem::path& path, const DDSTexture& texture)
+    {
+        const u32 dxgi = ToDXGI(texture.format);
+        if (dxgi == 0 || texture.layout.levels.empty() || texture.data.size() < texture.layout.size)
+            return false;
+
+        const auto& base = texture.layout.levels.front();
+        const auto levels = static_cast<u32>(texture.layout.levels.size());
+
+        Header header{};
+        header.size = sizeof(Header);
+        header.flags = FlagCaps | FlagHeight | FlagWidth | FlagPixelFormat | FlagMipMapCount | FlagLinearSize;
+        header.height = base.height;
+        header.width = base.width;
+        header.pitchOrLinearSize = static_cast<u32>(GetTextureLevelSize(texture.format, base.width, base.height));
+        header.mipMapCount = levels;
+        header.pixelFormat.size = sizeof(PixelFormat);
+        header.pixelFormat.flags = PixelFormatFourCC;
+        header.pixelFormat.fourCC = MakeFourCC('D', 'X', '1', '0');
+        header.caps = CapsTexture | (levels > 1 ? CapsComplex | CapsMipMap : 0);
+
+        HeaderDX10 dx10{};
+        dx10.dxgiFormat = dxgi;
+        dx10.resourceDimension = DimensionTexture2D;
+        dx10.arraySize = 1;
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        file.write(reinterpret_cast<const char*>(&Magic), sizeof(Magic));
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(&dx10), sizeof(dx10));
+        file.write(
+            reinterpret_cast<const char*>(texture.data.data()), static_cast<std::streamsize>(texture.layout.size)
+        );
+        return static_cast<bool>(file);
+    }
+} // namespace Cocoa::Graphics
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "mip_generator.h"
+
+namespace Cocoa::Graphics {
+    /// @brief A single 2D texture with its mip chain, as stored in a DDS file
+    struct DDSTexture
+    {
+        GPUColorFormat format = GPUColorFormat::Unknown;
+        MipChainLayout layout;
+        std::vector<u8> data;
+    };
+
+    /// @brief Where the mip chain of a DDS file starts and how it's laid out
+    struct DDSHeader
+    {
+        GPUColorFormat format = GPUColorFormat::Unknown;
+        MipChainLayout layout;
+        usize dataOffset = 0;
+    };
+
+    /// @brief Largest header a DDS file can have, reading this many bytes is always enough for ParseDDSHeader
+    constexpr usize DDSMaxHeaderSize = 148;
+
+    /// @brief Reads only the header, so the data can be streamed straight to where it's needed afterwards
+    /// @note Doesn't check that the file is long enough to hold the data
+    std::optional<DDSHeader> ParseDDSHeader(std::span<const u8> file);
+
+    /// @brief Reads a 2D texture in RGBA8 or one of the BC formats, from either a DX10 or a legacy FourCC header
+    /// @return Nothing when the file is malformed or holds something else, e.g. a cube map or an unsupported format
+    std::optional<DDSTexture> ParseDDS(std::span<const u8> file);
+
+    /// @brief Writes a texture with a DX10 header so the format, including sRGB, survives the round trip
+    bool WriteDDS(const std::filesystem::path& path, const DDSTexture& texture);
+} // namespace Cocoa::Graphics
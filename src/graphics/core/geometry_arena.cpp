@@ -0,0 +1,144 @@
+#include "geometry_arena.h"
+
+#include <cstring>
+
+namespace Cocoa::Graphics {
+    GeometryArena::GeometryArena(RenderDevice& device, const GeometryArenaDesc& desc)
+        : _device(device), _vertices(desc.vertexCapacity), _indices(desc.indexCapacity),
+          _vertexStride(desc.vertexStride), _indexFormat(desc.indexFormat)
+    {
+        _vertexBuffer = _device.CreateBuffer({
+            .usage = GPUBufferUsage::Vertex | GPUBufferUsage::TransferDst,
+            .access = GPUMemoryAccess::GPUOnly,
+            .size = static_cast<u64>(desc.vertexCapacity) * desc.vertexStride,
+        });
+        _indexBuffer = _device.CreateBuffer({
+            .usage = GPUBufferUsage::Index | GPUBufferUsage::TransferDst,
+            .access = GPUMemoryAccess::GPUOnly,
+            .size = desc.indexCapacity * GetIndexSize(),
+        });
+    }
+
+    GeometryArena::~GeometryArena()
+    {
+        _device.DestroyBuffer(_indexBuffer);
+        _device.DestroyBuffer(_vertexBuffer);
+    }
+
+    GeometryRange GeometryArena::Upload(const MeshData& mesh)
+    {
+        return Upload(
+            mesh.vertices.data(), static_cast<u32>(mesh.vertices.size()), sizeof(Vertex), mesh.indices, mesh.lods
+        );
+    }
+
+    GeometryRange GeometryArena::Upload(const PackedMeshData& mesh)
+    {
+        return Upload(
+            mesh.vertices.data(), static_cast<u32>(mesh.vertices.size()), sizeof(PackedVertex), mesh.indices,
+            mesh.lods
+        );
+    }
+
+    GeometryRange GeometryArena::Upload(
+        const void* vertices, const u32 vertexCount, const u32 vertexStride, const std::span<const u32> indices,
+        const std::span<const MeshLOD> lods
+    )
+    {
+        if (vertexStride != _vertexStride) {
+            PANIC("Mesh vertex stride %u doesn't match the arena's %u", vertexStride, _vertexStride);
+        }
+        if (_indexFormat == GPUIndexFormat::Uint16 && vertexCount > 65536) {
+            PANIC("A mesh with %u vertices needs an arena with 32-bit indices", vertexCount);
+        }
+
+        const auto indexCount = static_cast<u32>(indices.size());
+        if (vertexCount == 0)
+            return {};
+
+        const auto firstVertex = _vertices.Allocate(vertexCount);
+        const auto firstIndex = indexCount > 0 ? _indices.Allocate(indexCount) : std::optional<u64>(0);
+        if (!firstVertex || !firstIndex) {
+            PANIC("Geometry arena is out of space for a mesh with %u vertices and %u indices", vertexCount, indexCount);
+        }
+
+        GeometryRange range{};
+        range.firstVertex = static_cast<u32>(*firstVertex);
+        range.vertexCount = vertexCount;
+        range.firstIndex = static_cast<u32>(*firstIndex);
+        range.indexCount = lods.empty() ? indexCount : lods.front().indexCount;
+        range.allocatedIndexCount = indexCount;
+
+        // Vertices and indices share one staging buffer and one submission
+        const u64 vertexBytes = static_cast<u64>(vertexCount) * vertexStride;
+        const u64 indexBytes = indexCount * GetIndexSize();
+        std::vector<std::byte> staging(vertexBytes + indexBytes);
+        std::memcpy(staging.data(), vertices, vertexBytes);
+        if (_indexFormat == GPUIndexFormat::Uint16) {
+            const auto narrowIndices = reinterpret_cast<uint16_t*>(staging.data() + vertexBytes);
+            for (u32 i = 0; i < indexCount; i++) {
+                narrowIndices[i] = static_cast<uint16_t>(indices[i]);
+            }
+        } else {
+            std::memcpy(staging.data() + vertexBytes, indices.data(), indexBytes);
+        }
+
+        auto stagingBuffer = _device.CreateBuffer({
+            .usage = GPUBufferUsage::TransferSrc,
+            .access = GPUMemoryAccess::CPUToGPU,
+            .size = staging.size(),
+            .mapped = staging.data(),
+        });
+        _device.EncodeImmediateCommands(
+            [&](RenderEncoder* encoder) {
+                encoder->CopyBufferToBuffer(
+                    stagingBuffer, _vertexBuffer, vertexBytes, 0, static_cast<u64>(range.firstVertex) * vertexStride
+                );
+                if (indexBytes > 0) {
+                    encoder->CopyBufferToBuffer(
+                        stagingBuffer, _indexBuffer, indexBytes, vertexBytes,
+                        range.firstIndex * GetIndexSize()
+                    );
+                }
+            },
+            {}
+        );
+        _device.DestroyBuffer(stagingBuffer);
+
+        return range;
+    }
+
+    void GeometryArena::Free(GeometryRange& range)
+    {
+        if (!range.IsValid())
+            return;
+
+        _vertices.Free(range.firstVertex, range.vertexCount);
+        _indices.Free(range.firstIndex, range.allocatedIndexCount);
+        range = {};
+    }
+
+    void GeometryArena::Bind(RenderEncoder* encoder)
+    {
+        encoder->SetVertexBuffer(_vertexBuffer);
+        encoder->SetIndexBuffer(_indexBuffer, 0, _indexFormat);
+    }
+
+    void GeometryArena::Draw(
+        RenderEncoder* encoder, const GeometryRange& range, const u32 instanceCount, const u32 firstInstance
+    )
+    {
+        if (range.indexCount > 0) {
+            encoder->DrawIndexed(
+                range.indexCount, instanceCount, range.firstIndex, static_cast<i32>(range.firstVertex), firstInstance
+            );
+        } else {
+            encoder->Draw(range.vertexCount, instanceCount, range.firstVertex, firstInstance);
+        }
+    }
+
+    u64 GeometryArena::GetIndexSize() const
+    {
+        return _indexFormat == GPUIndexFormat::Uint16 ? sizeof(uint16_t) : sizeof(u32);
+    }
+} // namespace Cocoa::Graphics
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <span>
+
+#include "range_allocator.h"
+#include "render_device.h"
+
+namespace Cocoa::Graphics {
+    struct GeometryArenaDesc
+    {
+        u32 vertexCapacity = 1 << 20;
+        u32 indexCapacity = 1 << 22;
+        /// @brief sizeof(Vertex) or sizeof(PackedVertex), an arena holds only one kind
+        u32 vertexStride = sizeof(Vertex);
+        /// @brief Uint16 halves index memory but limits each mesh to 65536 vertices
+        GPUIndexFormat indexFormat = GPUIndexFormat::Uint16;
+    };
+
+    /// @brief Where a mesh lives inside a GeometryArena, in vertices and indices rather than bytes
+    struct GeometryRange
+    {
+        u32 firstVertex = 0;
+        u32 vertexCount = 0;
+        u32 firstIndex = 0;
+        /// @brief Indices of the full detail mesh, the LODs follow them
+        u32 indexCount = 0;
+        /// @brief Indices reserved for the mesh including every LOD
+        u32 allocatedIndexCount = 0;
+
+        [[nodiscard]] bool IsValid() const { return vertexCount != 0; }
+
+        /// @return The range drawing one of the mesh's LODs
+        [[nodiscard]] GeometryRange ForLOD(const MeshLOD& lod) const
+        {
+            GeometryRange range = *this;
+            range.firstIndex = firstIndex + lod.firstIndex;
+            range.indexCount = lod.indexCount;
+            return range;
+        }
+    };
+
+    /// @brief Keeps the geometry of many meshes in one vertex buffer and one index buffer
+    /// @note Both buffers are bound once and every mesh is drawn with its own base vertex and first index
+    class GeometryArena
+    {
+      public:
+        explicit GeometryArena(RenderDevice& device, const GeometryArenaDesc& desc = {});
+        ~GeometryArena();
+
+        GeometryArena(const GeometryArena&) = delete;
+        GeometryArena& operator=(const GeometryArena&) = delete;
+
+        /// @brief Copies a mesh into the arena, waiting for the copy to finish
+        /// @note Indices stay relative to the mesh's first vertex and are converted to the arena's index format
+        GeometryRange Upload(const MeshData& mesh);
+        GeometryRange Upload(const PackedMeshData& mesh);
+
+        /// @brief Returns the mesh's space to the arena
+        /// @note The space is reused by the next Upload, so frames still drawing the mesh must have finished
+        void Free(GeometryRange& range);
+
+        /// @brief Binds the arena's vertex and index buffers, once is enough for every mesh in it
+        void Bind(RenderEncoder* encoder);
+
+        void Draw(RenderEncoder* encoder, const GeometryRange& range, u32 instanceCount = 1, u32 firstInstance = 0);
+
+        [[nodiscard]] GPUBufferHandle& GetVertexBuffer() { return _vertexBuffer; }
+        [[nodiscard]] GPUBufferHandle& GetIndexBuffer() { return _indexBuffer; }
+        [[nodiscard]] const RangeAllocator& GetVertexAllocator() const { return _vertices; }
+        [[nodiscard]] const RangeAllocator& GetIndexAllocator() const { return _indices; }
+
+      private:
+        RenderDevice& _device;
+        GPUBufferHandle _vertexBuffer;
+        GPUBufferHandle _indexBuffer;
+        RangeAllocator _vertices;
+        RangeAllocator _indices;
+        u32 _vertexStride;
+        GPUIndexFormat _indexFormat;
+
+        GeometryRange Upload(
+            const void* vertices, u32 vertexCount, u32 vertexStride, std::span<const u32> indices,
+            std::span<const MeshLOD> lods
+        );
+        [[nodiscard]] u64 GetIndexSize() const;
+    };
+} // namespace Cocoa::Graphics
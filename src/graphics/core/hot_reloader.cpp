@@ -0,0 +1,158 @@
+#include "hot_reloader.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ranges>
+
+#include "../../macros.h"
+
+namespace Cocoa::Graphics {
+    HotReloader::HotReloader(RenderDevice& device, const HotReloaderDesc& desc)
+        : _device(device), _shaderDirectory(std::filesystem::weakly_canonical(desc.shaderDirectory)),
+          _shaderManifest(LoadShaderManifest(desc.shaderManifest)), _shaderCompiler(desc.shaderCompiler),
+          _watcher(desc.directories), _compiler(1)
+    {
+        if (!_shaderManifest) {
+            PUSH_WARN("Failed to load %s, shaders won't be reloaded", desc.shaderManifest.string().c_str());
+        }
+    }
+
+    HotReloader::~HotReloader() { _compiler.WaitForIdle(); }
+
+    void HotReloader::WatchShader(
+        const GFXShaderModuleHandle module, const std::string_view source, const std::vector<std::string>& defines
+    )
+    {
+        const auto permutation = _shaderManifest ? _shaderManifest->Find(source, defines) : nullptr;
+        if (!permutation) {
+            PUSH_WARN(
+                "Can't watch shader %.*s, the build didn't compile that permutation", static_cast<int>(source.size()),
+                source.data()
+            );
+            return;
+        }
+
+        // The watcher reports canonical paths, so those are what changes are matched against
+        auto& shader = _shaders.emplace_back();
+        shader.module = module;
+        shader.source = std::filesystem::weakly_canonical(_shaderDirectory / permutation->source);
+        shader.output = std::filesystem::weakly_canonical(permutation->path);
+        shader.defines = permutation->defines;
+    }
+
+    void HotReloader::WatchPipeline(const GFXRenderPipelineHandle pipeline, const GFXPipelineDesc& desc)
+    {
+        WatchedPipeline watched{.pipeline = pipeline, .modules = {}};
+        for (const auto& module : desc.shaders | std::views::values) {
+            watched.modules.push_back(module);
+        }
+        _pipelines.push_back(std::move(watched));
+    }
+
+    void HotReloader::WatchTexture(
+        const std::filesystem::path& path, TextureLoader& loader, std::function<void(LoadedTexture)> onReload
+    )
+    {
+        _textures.push_back({
+            .path = std::filesystem::weakly_canonical(path),
+            .loader = &loader,
+            .onReload = std::move(onReload),
+            .ticket = std::nullopt,
+        });
+    }
+
+    void HotReloader::Update()
+    {
+        for (const auto& path : _watcher.Poll()) {
+            for (auto& shader : _shaders) {
+                if (shader.source != path)
+                    continue;
+                if (shader.compile.valid()) {
+                    shader.dirty = true;
+                } else {
+                    StartCompile(shader);
+                }
+            }
+            // A texture changing again before its reload finished waits for it, its texture is handed over first
+            for (auto& texture : _textures) {
+                if (texture.path != path)
+                    continue;
+                if (texture.ticket) {
+                    texture.dirty = true;
+                } else {
+                    texture.ticket = texture.loader->Load(path);
+                }
+            }
+        }
+
+        std::vector<GFXShaderModuleHandle> reloaded;
+        for (auto& shader : _shaders) {
+            if (!shader.compile.valid())
+                continue;
+            if (shader.compile.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                continue;
+
+            // A shader that doesn't compile keeps its previous version, the compiler already printed why
+            if (shader.compile.get()) {
+                try {
+                    _device.ReloadShaderModule(shader.module, {.shaderPath = shader.output.string(), .code = {}});
+                    reloaded.push_back(shader.module);
+                    PUSH_INFO("Reloaded shader %s", shader.source.string().c_str());
+                } catch (const std::exception&) {
+                    PUSH_WARN("Failed to reload shader %s", shader.source.string().c_str());
+                }
+            }
+            if (shader.dirty) {
+                shader.dirty = false;
+                StartCompile(shader);
+            }
+        }
+
+        for (auto& [pipeline, modules] : _pipelines) {
+            const bool affected = std::ranges::any_of(modules, [&](const GFXShaderModuleHandle& module) {
+                return std::ranges::find(reloaded, module) != reloaded.end();
+            });
+            if (affected) {
+                _device.RebuildRenderPipeline(pipeline);
+            }
+        }
+
+        for (auto& texture : _textures) {
+            if (!texture.ticket)
+                continue;
+
+            const auto state = texture.loader->GetState(*texture.ticket);
+            if (state == TextureLoadState::Ready) {
+                texture.onReload(texture.loader->GetTexture(*texture.ticket));
+                texture.ticket.reset();
+            } else if (state == TextureLoadState::Failed) {
+                texture.ticket.reset();
+            }
+            if (!texture.ticket && texture.dirty) {
+                texture.dirty = false;
+                texture.ticket = texture.loader->Load(texture.path);
+            }
+        }
+    }
+
+    void HotReloader::StartCompile(WatchedShader& shader)
+    {
+        // Same arguments as CocoaShaderCompiler, so the reloaded module matches what the build produced
+        auto quote = [](const std::string& text) { return "\"" + text + "\""; };
+        std::string command = quote(_shaderCompiler) + " -V --quiet -I" + quote(_shaderDirectory.string());
+        for (const auto& define : shader.defines) {
+            command += " -D" + quote(define);
+        }
+        command += " " + quote(shader.source.string()) + " -o " + quote(shader.output.string());
+#ifdef _WIN32
+        // cmd /c strips the first and last quote of the line, which would break a quoted compiler path
+        command = quote(command);
+#endif
+
+        shader.compile = _compiler.Submit([command = std::move(command), output = shader.output] {
+            std::error_code error;
+            std::filesystem::create_directories(output.parent_path(), error);
+            return std::system(command.c_str()) == 0;
+        });
+    }
+} // namespace Cocoa::Graphics
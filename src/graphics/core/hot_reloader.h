@@ -0,0 +1,102 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../tools/file_watcher.h"
+#include "../../tools/thread_pool.h"
+#include "render_device.h"
+#include "shader_manifest.h"
+#include "texture_loader.h"
+
+namespace Cocoa::Graphics {
+    struct HotReloaderDesc
+    {
+        /// @brief Watched recursively, usually the shader sources and the content directory
+        std::vector<std::filesystem::path> directories;
+        /// @brief Root of the GLSL sources, the manifest's source paths and includes are relative to it
+        std::filesystem::path shaderDirectory;
+        /// @brief The shaders.manifest the build wrote, it maps each permutation to its defines and output
+        std::filesystem::path shaderManifest;
+        /// @brief Called with the same arguments CocoaShaderCompiler uses, "-V --quiet -I<shaderDirectory>", a "-D"
+        /// per define of the permutation, then "<source> -o <output>"
+        std::string shaderCompiler = "glslangValidator";
+    };
+
+    /// @brief Recompiles shaders and reloads textures while the game runs, so edits show up without a restart
+    /// @note Only the assets whose files changed are rebuilt. Compiles and decodes run in the background and are
+    /// applied in Update, which is meant to be called between frames.
+    class HotReloader
+    {
+      public:
+        HotReloader(RenderDevice& device, const HotReloaderDesc& desc);
+        ~HotReloader();
+
+        HotReloader(const HotReloader&) = delete;
+        HotReloader& operator=(const HotReloader&) = delete;
+
+        /// @brief Recompiles a permutation from the manifest and reloads module from it whenever its source changes
+        /// @param source Path relative to the shader directory, as stored in the manifest
+        /// @note Only edits to the source itself are noticed, not to the files it includes
+        void WatchShader(
+            GFXShaderModuleHandle module, std::string_view source, const std::vector<std::string>& defines = {}
+        );
+
+        /// @brief Rebuilds pipeline in place whenever one of the shaders in desc is reloaded
+        void WatchPipeline(GFXRenderPipelineHandle pipeline, const GFXPipelineDesc& desc);
+
+        /// @brief Loads path again through loader whenever it changes, onReload gets the new texture
+        /// @note The loader still has to be flushed by its owner, the previous texture is the callback's to destroy
+        void WatchTexture(
+            const std::filesystem::path& path, TextureLoader& loader, std::function<void(LoadedTexture)> onReload
+        );
+
+        /// @brief Starts work for changed files and swaps in whatever finished since the last call
+        void Update();
+
+      private:
+        struct WatchedShader
+        {
+            GFXShaderModuleHandle module;
+            std::filesystem::path source;
+            std::filesystem::path output;
+            std::vector<std::string> defines;
+            std::future<bool> compile;
+            /// @brief Changed again while compiling, so it's compiled once more afterwards
+            bool dirty = false;
+        };
+
+        struct WatchedPipeline
+        {
+            GFXRenderPipelineHandle pipeline;
+            std::vector<GFXShaderModuleHandle> modules;
+        };
+
+        struct WatchedTexture
+        {
+            std::filesystem::path path;
+            TextureLoader* loader;
+            std::function<void(LoadedTexture)> onReload;
+            std::optional<TextureLoadTicket> ticket;
+            /// @brief Changed again while loading, so it's loaded once more after the current load is handed over
+            bool dirty = false;
+        };
+
+        RenderDevice& _device;
+        std::filesystem::path _shaderDirectory;
+        std::optional<ShaderManifest> _shaderManifest;
+        std::string _shaderCompiler;
+        std::vector<WatchedShader> _shaders;
+        std::vector<WatchedPipeline> _pipelines;
+        std::vector<WatchedTexture> _textures;
+        Tools::FileWatcher _watcher;
+        Tools::ThreadPool _compiler;
+
+        void StartCompile(WatchedShader& shader);
+    };
+} // namespace Cocoa::Graphics
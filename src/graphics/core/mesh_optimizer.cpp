@@ -0,0 +1,474 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+#include "../../macros.h"
+
+namespace Cocoa::Graphics {
+    namespace {
+        constexpr u32 OverdrawGridSize = 256;
+
+        /// @brief FIFO cache made of per-vertex timestamps, a vertex is cached while fewer than size misses followed it
+        class FifoCache
+        {
+          public:
+            FifoCache(const u32 vertexCount, const u32 size) : _timestamps(vertexCount, 0), _size(size) {}
+
+            /// @return True on a miss
+            bool Access(const u32 vertex)
+            {
+                if (_time - _timestamps[vertex] < _size)
+                    return false;
+                _timestamps[vertex] = _time++;
+                return true;
+            }
+
+            void Reset() { _time += _size + 1; }
+
+          private:
+            std::vector<u32> _timestamps;
+            u32 _size;
+            // Starting past the size makes every vertex a miss at first
+            u32 _time = std::numeric_limits<u32>::max() / 2;
+        };
+
+        struct VertexHash
+        {
+            const std::vector<Vertex>* vertices;
+
+            usize operator()(const u32 index) const
+            {
+                // FNV-1a over the raw bytes, Vertex is all floats so there is no padding to skip
+                const auto bytes = reinterpret_cast<const unsigned char*>(&(*vertices)[index]);
+                u64 hash = 14695981039346656037ull;
+                for (usize i = 0; i < sizeof(Vertex); i++) {
+                    hash = (hash ^ bytes[i]) * 1099511628211ull;
+                }
+                return static_cast<usize>(hash);
+            }
+        };
+
+        struct VertexEqual
+        {
+            const std::vector<Vertex>* vertices;
+
+            bool operator()(const u32 a, const u32 b) const
+            {
+                return std::memcmp(&(*vertices)[a], &(*vertices)[b], sizeof(Vertex)) == 0;
+            }
+        };
+
+        void DeduplicateVertices(MeshData& mesh)
+        {
+            const auto vertexCount = static_cast<u32>(mesh.vertices.size());
+            std::unordered_map<u32, u32, VertexHash, VertexEqual> unique(
+                vertexCount, VertexHash{&mesh.vertices}, VertexEqual{&mesh.vertices}
+            );
+
+            std::vector<u32> remap(vertexCount);
+            std::vector<Vertex> vertices;
+            vertices.reserve(vertexCount);
+            for (u32 i = 0; i < vertexCount; i++) {
+                const auto [entry, inserted] = unique.emplace(i, static_cast<u32>(vertices.size()));
+                if (inserted) {
+                    vertices.push_back(mesh.vertices[i]);
+                }
+                remap[i] = entry->second;
+            }
+
+            for (auto& index : mesh.indices) {
+                index = remap[index];
+            }
+            mesh.vertices = std::move(vertices);
+        }
+
+        /// @brief Tipsify (Sander et al. 2007), fans around recently used vertices so they are still cached
+        /// @param deadEnds Filled with the output triangle at which the walk had to jump somewhere unrelated
+        std::vector<u32> OptimizeVertexCache(
+            const std::span<const u32> indices, const u32 vertexCount, const u32 cacheSize, std::vector<u32>& deadEnds
+        )
+        {
+            const auto triangleCount = static_cast<u32>(indices.size() / 3);
+
+            // Triangles around each vertex, stored as one flat array with offsets
+            std::vector<u32> liveTriangles(vertexCount, 0);
+            for (const auto index : indices) {
+                liveTriangles[index]++;
+            }
+            std::vector<u32> adjacencyOffsets(vertexCount + 1, 0);
+            std::inclusive_scan(liveTriangles.begin(), liveTriangles.end(), adjacencyOffsets.begin() + 1);
+            std::vector<u32> adjacency(indices.size());
+            std::vector<u32> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (u32 i = 0; i < indices.size(); i++) {
+                adjacency[fill[indices[i]]++] = i / 3;
+            }
+
+            std::vector<u32> cacheTimestamps(vertexCount, 0);
+            std::vector<bool> emitted(triangleCount, false);
+            std::vector<u32> deadEndStack;
+            std::vector<u32> candidates;
+            std::vector<u32> result;
+            result.reserve(indices.size());
+
+            u32 timestamp = cacheSize + 1;
+            u32 cursor = 0;
+            auto skipDeadEnd = [&]() -> u32 {
+                while (!deadEndStack.empty()) {
+                    const auto vertex = deadEndStack.back();
+                    deadEndStack.pop_back();
+                    if (liveTriangles[vertex] > 0)
+                        return vertex;
+                }
+                for (; cursor < vertexCount; cursor++) {
+                    if (liveTriangles[cursor] > 0)
+                        return cursor;
+                }
+                return u32Max;
+            };
+
+            u32 fanning = skipDeadEnd();
+            deadEnds.push_back(0);
+            while (fanning != u32Max) {
+                candidates.clear();
+                for (u32 i = adjacencyOffsets[fanning]; i < adjacencyOffsets[fanning + 1]; i++) {
+                    const auto triangle = adjacency[i];
+                    if (emitted[triangle])
+                        continue;
+
+                    for (u32 corner = 0; corner < 3; corner++) {
+                        const auto vertex = indices[triangle * 3 + corner];
+                        result.push_back(vertex);
+                        deadEndStack.push_back(vertex);
+                        candidates.push_back(vertex);
+                        liveTriangles[vertex]--;
+                        if (timestamp - cacheTimestamps[vertex] > cacheSize) {
+                            cacheTimestamps[vertex] = timestamp++;
+                        }
+                    }
+                    emitted[triangle] = true;
+                }
+
+                // Prefer the candidate that stays in the cache while its remaining triangles are emitted
+                u32 next = u32Max;
+                i64 bestPriority = -1;
+                for (const auto vertex : candidates) {
+                    if (liveTriangles[vertex] == 0)
+                        continue;
+
+                    i64 priority = 0;
+                    const i64 age = timestamp - cacheTimestamps[vertex];
+                    if (age + 2 * static_cast<i64>(liveTriangles[vertex]) <= cacheSize) {
+                        priority = age;
+                    }
+                    if (priority > bestPriority) {
+                        bestPriority = priority;
+                        next = vertex;
+                    }
+                }
+
+                if (next == u32Max) {
+                    next = skipDeadEnd();
+                    deadEnds.push_back(static_cast<u32>(result.size() / 3));
+                }
+                fanning = next;
+            }
+            return result;
+        }
+
+        /// @brief Splits the cache-ordered triangles into clusters that can be drawn in any order
+        /// @note Clusters start at Tipsify's dead ends, and are split further wherever the cache has already
+        /// warmed up to within the threshold of the cluster's overall efficiency
+        std::vector<u32> BuildClusters(
+            const std::span<const u32> indices, const u32 vertexCount, const std::span<const u32> deadEnds,
+            const MeshOptimizeDesc& desc
+        )
+        {
+            const auto triangleCount = static_cast<u32>(indices.size() / 3);
+            FifoCache cache(vertexCount, desc.cacheSize);
+            auto triangleMisses = [&](const u32 triangle) {
+                u32 misses = 0;
+                for (u32 corner = 0; corner < 3; corner++) {
+                    misses += cache.Access(indices[triangle * 3 + corner]);
+                }
+                return misses;
+            };
+
+            std::vector<u32> clusters;
+            for (usize i = 0; i < deadEnds.size(); i++) {
+                const auto start = deadEnds[i];
+                const auto end = i + 1 < deadEnds.size() ? deadEnds[i + 1] : triangleCount;
+                if (start >= end)
+                    continue;
+
+                cache.Reset();
+                u32 clusterMisses = 0;
+                for (u32 triangle = start; triangle < end; triangle++) {
+                    clusterMisses += triangleMisses(triangle);
+                }
+                const f32 targetAcmr = static_cast<f32>(clusterMisses) / static_cast<f32>(end - start) *
+                                       desc.overdrawThreshold;
+
+                cache.Reset();
+                clusters.push_back(start);
+                u32 misses = 0;
+                u32 clusterStart = start;
+                for (u32 triangle = start; triangle < end; triangle++) {
+                    misses += triangleMisses(triangle);
+                    const auto triangles = static_cast<f32>(triangle - clusterStart + 1);
+                    if (triangle + 1 < end && static_cast<f32>(misses) / triangles <= targetAcmr) {
+                        clusterStart = triangle + 1;
+                        clusters.push_back(clusterStart);
+                        misses = 0;
+                        cache.Reset();
+                    }
+                }
+            }
+            return clusters;
+        }
+
+        /// @brief Draws clusters facing away from the mesh center first, they are the most likely to hide the rest
+        std::vector<u32> OptimizeOverdraw(
+            const MeshData& mesh, const std::span<const u32> indices, const std::span<const u32> clusters
+        )
+        {
+            const auto triangleCount = static_cast<u32>(indices.size() / 3);
+            auto position = [&](const u32 index) {
+                const auto& pos = mesh.vertices[index].pos;
+                return Math::Vector3(pos[0], pos[1], pos[2]);
+            };
+
+            struct Cluster
+            {
+                u32 start;
+                u32 end;
+                Math::Vector3 centroid;
+                Math::Vector3 normal;
+                f32 area = 0;
+            };
+
+            std::vector<Cluster> sortedClusters;
+            Math::Vector3 meshCentroid;
+            f32 meshArea = 0;
+            for (usize i = 0; i < clusters.size(); i++) {
+                auto& cluster = sortedClusters.emplace_back();
+                cluster.start = clusters[i];
+                cluster.end = i + 1 < clusters.size() ? clusters[i + 1] : triangleCount;
+
+                for (u32 triangle = cluster.start; triangle < cluster.end; triangle++) {
+                    const auto a = position(indices[triangle * 3 + 0]);
+                    const auto b = position(indices[triangle * 3 + 1]);
+                    const auto c = position(indices[triangle * 3 + 2]);
+
+                    // The cross product's length is twice the area, so summing it weights by area
+                    const auto normal = (b - a).Cross(c - a);
+                    const f32 area = normal.Length();
+                    cluster.centroid += (a + b + c) * (area / 3.0f);
+                    cluster.normal += normal;
+                    cluster.area += area;
+                }
+
+                meshCentroid += cluster.centroid;
+                meshArea += cluster.area;
+                if (cluster.area > 0) {
+                    cluster.centroid = cluster.centroid / cluster.area;
+                }
+            }
+            if (meshArea > 0) {
+                meshCentroid = meshCentroid / meshArea;
+            }
+
+            std::vector<f32> sortKeys;
+            sortKeys.reserve(sortedClusters.size());
+            for (const auto& cluster : sortedClusters) {
+                sortKeys.push_back((cluster.centroid - meshCentroid).Dot(cluster.normal.Normalize()));
+            }
+            std::vector<u32> order(sortedClusters.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::ranges::stable_sort(order, [&](const u32 a, const u32 b) { return sortKeys[a] > sortKeys[b]; });
+
+            std::vector<u32> result;
+            result.reserve(indices.size());
+            for (const auto clusterIndex : order) {
+                const auto& cluster = sortedClusters[clusterIndex];
+                result.insert(result.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3);
+            }
+            return result;
+        }
+
+        /// @brief Renumbers vertices in the order the indices first reach them, so fetches walk memory forwards
+        void OptimizeVertexFetch(MeshData& mesh)
+        {
+            std::vector<u32> remap(mesh.vertices.size(), u32Max);
+            std::vector<Vertex> vertices;
+            vertices.reserve(mesh.vertices.size());
+            for (auto& index : mesh.indices) {
+                if (remap[index] == u32Max) {
+                    remap[index] = static_cast<u32>(vertices.size());
+                    vertices.push_back(mesh.vertices[index]);
+                }
+                index = remap[index];
+            }
+
+            // Vertices no triangle uses are dropped
+            mesh.vertices = std::move(vertices);
+        }
+
+        void Rasterize(
+            const std::array<f32, 3>& a, const std::array<f32, 3>& b, const std::array<f32, 3>& c,
+            std::vector<f32>& depth, u32& shaded
+        )
+        {
+            // Counter-clockwise is front facing, matching the default pipeline state
+            const f32 area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+            if (area <= 0)
+                return;
+
+            const auto minX = static_cast<u32>(std::max(0.0f, std::floor(std::min({a[0], b[0], c[0]}))));
+            const auto minY = static_cast<u32>(std::max(0.0f, std::floor(std::min({a[1], b[1], c[1]}))));
+            const auto maxX = std::min(OverdrawGridSize - 1, static_cast<u32>(std::max({a[0], b[0], c[0]})));
+            const auto maxY = std::min(OverdrawGridSize - 1, static_cast<u32>(std::max({a[1], b[1], c[1]})));
+
+            auto edge = [](const std::array<f32, 3>& from, const std::array<f32, 3>& to, const f32 x, const f32 y) {
+                return (to[0] - from[0]) * (y - from[1]) - (to[1] - from[1]) * (x - from[0]);
+            };
+
+            for (u32 y = minY; y <= maxY; y++) {
+                for (u32 x = minX; x <= maxX; x++) {
+                    const f32 px = static_cast<f32>(x) + 0.5f;
+                    const f32 py = static_cast<f32>(y) + 0.5f;
+                    const f32 wa = edge(b, c, px, py);
+                    const f32 wb = edge(c, a, px, py);
+                    const f32 wc = edge(a, b, px, py);
+                    if (wa < 0 || wb < 0 || wc < 0)
+                        continue;
+
+                    const f32 z = (wa * a[2] + wb * b[2] + wc * c[2]) / area;
+                    auto& stored = depth[y * OverdrawGridSize + x];
+                    if (z < stored) {
+                        stored = z;
+                        shaded++;
+                    }
+                }
+            }
+        }
+    } // namespace
+
+    MeshOptimizeStats OptimizeMesh(MeshData& mesh, const MeshOptimizeDesc& desc)
+    {
+        // Vertices are kept by the triangles using them, without indices every vertex would be dropped
+        if (mesh.indices.empty()) {
+            PANIC("Only indexed meshes can be optimized");
+        }
+        if (mesh.indices.size() % 3 != 0) {
+            PANIC("Mesh index count %zu is not a multiple of 3", mesh.indices.size());
+        }
+        if (!mesh.lods.empty()) {
+            PANIC("Meshes have to be optimized before their LODs are generated");
+        }
+
+        MeshOptimizeStats stats{};
+        stats.verticesBefore = static_cast<u32>(mesh.vertices.size());
+        stats.cacheBefore = AnalyzeVertexCache(mesh.indices, stats.verticesBefore, desc.cacheSize);
+        stats.overdrawBefore = AnalyzeOverdraw(mesh);
+
+        DeduplicateVertices(mesh);
+
+        const auto vertexCount = static_cast<u32>(mesh.vertices.size());
+        std::vector<u32> deadEnds;
+        const auto cacheOrder = OptimizeVertexCache(mesh.indices, vertexCount, desc.cacheSize, deadEnds);
+        if (desc.overdrawThreshold > 1.0f) {
+            const auto clusters = BuildClusters(cacheOrder, vertexCount, deadEnds, desc);
+            mesh.indices = OptimizeOverdraw(mesh, cacheOrder, clusters);
+        } else {
+            mesh.indices = cacheOrder;
+        }
+
+        OptimizeVertexFetch(mesh);
+        mesh.indexFormat = mesh.vertices.size() > 65536 ? GPUIndexFormat::Uint32 : GPUIndexFormat::Uint16;
+
+        stats.verticesAfter = static_cast<u32>(mesh.vertices.size());
+        stats.cacheAfter = AnalyzeVertexCache(mesh.indices, stats.verticesAfter, desc.cacheSize);
+        stats.overdrawAfter = AnalyzeOverdraw(mesh);
+        return stats;
+    }
+
+    void OptimizeIndexOrder(std::vector<u32>& indices, const u32 vertexCount, const u32 cacheSize)
+    {
+        std::vector<u32> deadEnds;
+        indices = OptimizeVertexCache(indices, vertexCount, cacheSize, deadEnds);
+    }
+
+    MeshCacheStats AnalyzeVertexCache(const std::span<const u32> indices, const u32 vertexCount, const u32 cacheSize)
+    {
+        if (indices.empty() || vertexCount == 0)
+            return {};
+
+        FifoCache cache(vertexCount, cacheSize);
+        u32 misses = 0;
+        for (const auto index : indices) {
+            misses += cache.Access(index);
+        }
+
+        MeshCacheStats stats{};
+        stats.acmr = static_cast<f32>(misses) / static_cast<f32>(indices.size() / 3);
+        stats.atvr = static_cast<f32>(misses) / static_cast<f32>(vertexCount);
+        return stats;
+    }
+
+    MeshOverdrawStats AnalyzeOverdraw(const MeshData& mesh)
+    {
+        MeshOverdrawStats stats{};
+        if (mesh.vertices.empty() || mesh.indices.empty())
+            return stats;
+
+        std::array<f32, 3> min;
+        std::array<f32, 3> max;
+        min.fill(std::numeric_limits<f32>::max());
+        max.fill(std::numeric_limits<f32>::lowest());
+        for (const auto& vertex : mesh.vertices) {
+            for (int i = 0; i < 3; i++) {
+                min[i] = std::min(min[i], vertex.pos[i]);
+                max[i] = std::max(max[i], vertex.pos[i]);
+            }
+        }
+        const f32 extent = std::max({max[0] - min[0], max[1] - min[1], max[2] - min[2], 1e-6f});
+        const f32 scale = static_cast<f32>(OverdrawGridSize) / extent;
+
+        std::vector<f32> depth(OverdrawGridSize * OverdrawGridSize);
+        for (int axis = 0; axis < 3; axis++) {
+            for (const f32 direction : {1.0f, -1.0f}) {
+                std::ranges::fill(depth, std::numeric_limits<f32>::max());
+
+                // The other two axes form the image plane, swapped depending on the side we look from so
+                // triangles facing the viewer always come out counter-clockwise
+                const int u = direction > 0 ? (axis + 2) % 3 : (axis + 1) % 3;
+                const int v = direction > 0 ? (axis + 1) % 3 : (axis + 2) % 3;
+                auto project = [&](const u32 index) {
+                    const auto& pos = mesh.vertices[index].pos;
+                    return std::array{
+                        (pos[u] - min[u]) * scale, (pos[v] - min[v]) * scale, (pos[axis] - min[axis]) * direction
+                    };
+                };
+
+                for (usize i = 0; i + 2 < mesh.indices.size(); i += 3) {
+                    Rasterize(
+                        project(mesh.indices[i]), project(mesh.indices[i + 1]), project(mesh.indices[i + 2]), depth,
+                        stats.pixelsShaded
+                    );
+                }
+                stats.pixelsCovered += static_cast<u32>(std::ranges::count_if(depth, [](const f32 z) {
+                    return z != std::numeric_limits<f32>::max();
+                }));
+            }
+        }
+
+        stats.overdraw = stats.pixelsCovered > 0
+                             ? static_cast<f32>(stats.pixelsShaded) / static_cast<f32>(stats.pixelsCovered)
+                             : 0.0f;
+        return stats;
+    }
+} // namespace Cocoa::Graphics
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <span>
+
+#include "../utils/types.h"
+
+namespace Cocoa::Graphics {
+    struct MeshOptimizeDesc
+    {
+        /// @brief Post-transform cache size to optimize for, 16 is a safe guess for current GPUs
+        u32 cacheSize = 16;
+        /// @brief How much worse the vertex cache may get in exchange for less overdraw, 1 disables the trade
+        f32 overdrawThreshold = 1.05f;
+    };
+
+    struct MeshCacheStats
+    {
+        /// @brief Average cache misses per triangle, 0.5 is the ideal for a regular grid and 3 the worst
+        f32 acmr = 0;
+        /// @brief Average cache misses per vertex, 1 means every vertex is transformed exactly once
+        f32 atvr = 0;
+    };
+
+    struct MeshOverdrawStats
+    {
+        u32 pixelsCovered = 0;
+        u32 pixelsShaded = 0;
+        /// @brief Shaded over covered pixels, 1 means nothing is drawn twice
+        f32 overdraw = 0;
+    };
+
+    struct MeshOptimizeStats
+    {
+        u32 verticesBefore = 0;
+        u32 verticesAfter = 0;
+        MeshCacheStats cacheBefore;
+        MeshCacheStats cacheAfter;
+        MeshOverdrawStats overdrawBefore;
+        MeshOverdrawStats overdrawAfter;
+    };
+
+    /// @brief Prepares a mesh for drawing, meant to run once on load or offline
+    /// @note Merges identical vertices, orders triangles for the vertex cache and then for overdraw, orders vertices
+    /// by first use and switches to 32-bit indices when the mesh has too many vertices for 16 bits. The mesh has to be
+    /// indexed.
+    MeshOptimizeStats OptimizeMesh(MeshData& mesh, const MeshOptimizeDesc& desc = {});
+
+    /// @brief Reorders triangles for the vertex cache only, e.g. for index lists produced after OptimizeMesh
+    void OptimizeIndexOrder(std::vector<u32>& indices, u32 vertexCount, u32 cacheSize = 16);
+
+    /// @brief Simulates a FIFO post-transform cache over the indices
+    MeshCacheStats AnalyzeVertexCache(std::span<const u32> indices, u32 vertexCount, u32 cacheSize = 16);
+
+    /// @brief Rasterizes the mesh from the six axis directions in software and counts how often pixels are shaded
+    MeshOverdrawStats AnalyzeOverdraw(const MeshData& mesh);
+} // namespace Cocoa::Graphics
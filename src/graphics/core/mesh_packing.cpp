@@ -0,0 +1,70 @@
+#include "mesh_packing.h"
+
+#include <cstddef>
+#include <limits>
+
+#include "../../macros.h"
+#include "../utils/vertex_packing.h"
+
+namespace Cocoa::Graphics {
+    PackedMeshData PackMesh(const MeshData& mesh, const std::span<const std::array<f32, 3>> normals)
+    {
+        if (!normals.empty() && normals.size() != mesh.vertices.size()) {
+            PANIC("Mesh has %zu vertices but %zu normals", mesh.vertices.size(), normals.size());
+        }
+
+        PackedMeshData packed{};
+        packed.indices = mesh.indices;
+        packed.indexFormat = mesh.indexFormat;
+        packed.lods = mesh.lods;
+        if (mesh.vertices.empty())
+            return packed;
+
+        std::array<f32, 3> min;
+        std::array<f32, 3> max;
+        min.fill(std::numeric_limits<f32>::max());
+        max.fill(std::numeric_limits<f32>::lowest());
+        for (const auto& vertex : mesh.vertices) {
+            for (int i = 0; i < 3; i++) {
+                min[i] = std::min(min[i], vertex.pos[i]);
+                max[i] = std::max(max[i], vertex.pos[i]);
+            }
+        }
+
+        // A flat axis would divide by zero, any non-zero extent maps it to 0 just as well
+        std::array<f32, 3> inverseExtent{};
+        for (int i = 0; i < 3; i++) {
+            packed.positionCenter[i] = (min[i] + max[i]) * 0.5f;
+            packed.positionExtent[i] = std::max((max[i] - min[i]) * 0.5f, 1e-6f);
+            inverseExtent[i] = 1.0f / packed.positionExtent[i];
+        }
+
+        packed.vertices.reserve(mesh.vertices.size());
+        for (usize v = 0; v < mesh.vertices.size(); v++) {
+            const auto& vertex = mesh.vertices[v];
+
+            PackedVertex packedVertex{};
+            for (int i = 0; i < 3; i++) {
+                packedVertex.pos[i] = PackSnorm16((vertex.pos[i] - packed.positionCenter[i]) * inverseExtent[i]);
+            }
+            packedVertex.pos[3] = PackSnorm16(1.0f);
+            packedVertex.normal = PackOctahedral(normals.empty() ? std::array<f32, 3>{0, 0, 1} : normals[v]);
+            for (int i = 0; i < 4; i++) {
+                packedVertex.col[i] = PackUnorm8(vertex.col[i]);
+            }
+            packedVertex.uv = {FloatToHalf(vertex.uv[0]), FloatToHalf(vertex.uv[1])};
+            packed.vertices.push_back(packedVertex);
+        }
+        return packed;
+    }
+
+    GFXPipelineVertexBinding GetPackedVertexBinding(const u32 binding)
+    {
+        GFXPipelineVertexBinding vertexBinding{.binding = binding, .stride = sizeof(PackedVertex), .attributes = {}};
+        vertexBinding.Attribute(GPUColorFormat::RGBA16_Snorm, offsetof(PackedVertex, pos))
+            .Attribute(GPUColorFormat::RG16_Snorm, offsetof(PackedVertex, normal))
+            .Attribute(GPUColorFormat::RGBA8_Unorm, offsetof(PackedVertex, col))
+            .Attribute(GPUColorFormat::RG16_Float, offsetof(PackedVertex, uv));
+        return vertexBinding;
+    }
+} // namespace Cocoa::Graphics
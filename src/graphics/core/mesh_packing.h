@@ -0,0 +1,16 @@
+#pragma once
+
+#include <span>
+
+#include "../utils/descriptors.h"
+#include "../utils/types.h"
+
+namespace Cocoa::Graphics {
+    /// @brief Quantizes a mesh into PackedVertex, positions are stored relative to the mesh bounds
+    /// @param normals One normal per vertex, when empty every vertex gets +Z
+    /// @note Multiply the model matrix by PackedMeshData::GetDequantizeTransform when drawing the result
+    PackedMeshData PackMesh(const MeshData& mesh, std::span<const std::array<f32, 3>> normals = {});
+
+    /// @brief The vertex layout shaders/packed.vert expects, attributes at locations 0 to 3
+    GFXPipelineVertexBinding GetPackedVertexBinding(u32 binding = 0);
+} // namespace Cocoa::Graphics
@@ -0,0 +1,294 @@
+#include "mesh_simplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+#include "../../macros.h"
+#include "mesh_optimizer.h"
+
+namespace Cocoa::Graphics {
+    namespace {
+        /// @brief Sum of squared distances to a set of planes, weighted by the area each plane came from
+        struct Quadric
+        {
+            // Symmetric 3x3 part, the plane offset terms and the constant
+            f32 xx = 0, yy = 0, zz = 0, xy = 0, xz = 0, yz = 0;
+            f32 xw = 0, yw = 0, zw = 0, ww = 0;
+            f32 weight = 0;
+
+            static Quadric FromPlane(const Math::Vector3& normal, const f32 distance, const f32 weight)
+            {
+                Quadric q;
+                q.xx = normal.x * normal.x * weight;
+                q.yy = normal.y * normal.y * weight;
+                q.zz = normal.z * normal.z * weight;
+                q.xy = normal.x * normal.y * weight;
+                q.xz = normal.x * normal.z * weight;
+                q.yz = normal.y * normal.z * weight;
+                q.xw = normal.x * distance * weight;
+                q.yw = normal.y * distance * weight;
+                q.zw = normal.z * distance * weight;
+                q.ww = distance * distance * weight;
+                q.weight = weight;
+                return q;
+            }
+
+            Quadric& operator+=(const Quadric& other)
+            {
+                xx += other.xx;
+                yy += other.yy;
+                zz += other.zz;
+                xy += other.xy;
+                xz += other.xz;
+                yz += other.yz;
+                xw += other.xw;
+                yw += other.yw;
+                zw += other.zw;
+                ww += other.ww;
+                weight += other.weight;
+                return *this;
+            }
+
+            /// @return The mean squared distance of p to the planes
+            [[nodiscard]] f32 Evaluate(const Math::Vector3& p) const
+            {
+                const f32 error = p.x * p.x * xx + p.y * p.y * yy + p.z * p.z * zz +
+                                  2.0f * (p.x * p.y * xy + p.x * p.z * xz + p.y * p.z * yz) +
+                                  2.0f * (p.x * xw + p.y * yw + p.z * zw) + ww;
+                return weight > 0 ? std::max(error / weight, 0.0f) : 0.0f;
+            }
+        };
+
+        struct Collapse
+        {
+            u32 from;
+            u32 to;
+            f32 error;
+        };
+
+        Math::Vector3 Position(const std::vector<Vertex>& vertices, const u32 index)
+        {
+            const auto& pos = vertices[index].pos;
+            return Math::Vector3(pos[0], pos[1], pos[2]);
+        }
+
+        u64 EdgeKey(const u32 a, const u32 b) { return static_cast<u64>(a) << 32 | b; }
+    } // namespace
+
+    std::vector<u32> SimplifyMesh(
+        const std::vector<Vertex>& vertices, const std::span<const u32> indices, const u32 targetIndexCount,
+        const f32 targetError, f32* resultError
+    )
+    {
+        if (indices.size() % 3 != 0) {
+            PANIC("Mesh index count %zu is not a multiple of 3", indices.size());
+        }
+        const auto vertexCount = static_cast<u32>(vertices.size());
+
+        // Vertices that only differ in color or UV share a position, collapses are tracked per position
+        struct PositionHash
+        {
+            usize operator()(const std::array<f32, 3>& p) const
+            {
+                u32 bits[3];
+                std::memcpy(bits, p.data(), sizeof(bits));
+                return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+            }
+        };
+        std::unordered_map<std::array<f32, 3>, u32, PositionHash> positionIds;
+        std::vector<u32> positionOf(vertexCount);
+        std::vector<u32> wedgeCount;
+        for (u32 i = 0; i < vertexCount; i++) {
+            const auto [entry, inserted] = positionIds.emplace(vertices[i].pos, static_cast<u32>(wedgeCount.size()));
+            if (inserted) {
+                wedgeCount.push_back(0);
+            }
+            positionOf[i] = entry->second;
+            wedgeCount[entry->second]++;
+        }
+        const auto positionCount = static_cast<u32>(wedgeCount.size());
+
+        // An edge used in only one direction lies on an open border, moving its ends would open holes
+        std::unordered_map<u64, u32> directedEdges;
+        for (usize i = 0; i < indices.size(); i += 3) {
+            for (u32 corner = 0; corner < 3; corner++) {
+                const auto a = positionOf[indices[i + corner]];
+                const auto b = positionOf[indices[i + (corner + 1) % 3]];
+                directedEdges[EdgeKey(a, b)]++;
+            }
+        }
+        std::vector<bool> border(positionCount, false);
+        for (const auto& [key, count] : directedEdges) {
+            const auto a = static_cast<u32>(key >> 32);
+            const auto b = static_cast<u32>(key & 0xFFFFFFFF);
+            if (!directedEdges.contains(EdgeKey(b, a))) {
+                border[a] = true;
+                border[b] = true;
+            }
+        }
+
+        std::vector<Quadric> quadrics(positionCount);
+        for (usize i = 0; i < indices.size(); i += 3) {
+            const auto a = Position(vertices, indices[i]);
+            const auto b = Position(vertices, indices[i + 1]);
+            const auto c = Position(vertices, indices[i + 2]);
+            const auto normal = (b - a).Cross(c - a);
+            const f32 length = normal.Length();
+            if (length == 0)
+                continue;
+
+            const auto unitNormal = normal / length;
+            const auto quadric = Quadric::FromPlane(unitNormal, -unitNormal.Dot(a), length * 0.5f);
+            for (u32 corner = 0; corner < 3; corner++) {
+                quadrics[positionOf[indices[i + corner]]] += quadric;
+            }
+        }
+
+        // Seams and borders stay put, and only single wedge vertices can be collapsed onto
+        auto canMove = [&](const u32 v) { return wedgeCount[positionOf[v]] == 1 && !border[positionOf[v]]; };
+        auto canReceive = [&](const u32 v) { return wedgeCount[positionOf[v]] == 1; };
+
+        std::vector<u32> result(indices.begin(), indices.end());
+        std::vector<u32> adjacencyOffsets(vertexCount + 1);
+        std::vector<u32> adjacency;
+        std::vector<Collapse> collapses;
+        std::vector<bool> touched(vertexCount);
+        const f32 maxErrorSquared = targetError < std::sqrt(f32Max) ? targetError * targetError : f32Max;
+        f32 worstError = 0;
+
+        while (result.size() > targetIndexCount) {
+            collapses.clear();
+            for (usize i = 0; i < result.size(); i += 3) {
+                for (u32 corner = 0; corner < 3; corner++) {
+                    const auto from = result[i + corner];
+                    const auto to = result[i + (corner + 1) % 3];
+                    if (!canMove(from) || !canReceive(to) || positionOf[from] == positionOf[to])
+                        continue;
+
+                    auto quadric = quadrics[positionOf[from]];
+                    quadric += quadrics[positionOf[to]];
+                    collapses.push_back({from, to, quadric.Evaluate(Position(vertices, to))});
+                }
+            }
+            std::ranges::sort(collapses, {}, &Collapse::error);
+
+            // Triangles around each vertex, for the flip test
+            std::ranges::fill(adjacencyOffsets, 0);
+            for (const auto index : result) {
+                adjacencyOffsets[index + 1]++;
+            }
+            std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+            adjacency.resize(result.size());
+            std::vector<u32> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (u32 i = 0; i < result.size(); i++) {
+                adjacency[fill[result[i]]++] = i / 3;
+            }
+
+            auto flips = [&](const Collapse& collapse) {
+                const auto target = Position(vertices, collapse.to);
+                for (u32 i = adjacencyOffsets[collapse.from]; i < adjacencyOffsets[collapse.from + 1]; i++) {
+                    const auto triangle = adjacency[i] * 3;
+                    const u32 corners[3] = {result[triangle], result[triangle + 1], result[triangle + 2]};
+                    if (std::ranges::find(corners, collapse.to) != std::end(corners))
+                        continue;
+
+                    Math::Vector3 before[3];
+                    Math::Vector3 after[3];
+                    for (u32 corner = 0; corner < 3; corner++) {
+                        before[corner] = Position(vertices, corners[corner]);
+                        after[corner] = corners[corner] == collapse.from ? target : before[corner];
+                    }
+                    const auto normalBefore = (before[1] - before[0]).Cross(before[2] - before[0]);
+                    const auto normalAfter = (after[1] - after[0]).Cross(after[2] - after[0]);
+                    if (normalBefore.Dot(normalAfter) <= 0)
+                        return true;
+                }
+                return false;
+            };
+
+            // Each collapse removes about two triangles, stop the pass once that reaches the target
+            const auto trianglesToRemove = static_cast<u32>((result.size() - targetIndexCount) / 3);
+            u32 removedTriangles = 0;
+            std::vector<u32> remap(vertexCount);
+            std::iota(remap.begin(), remap.end(), 0);
+            std::fill(touched.begin(), touched.end(), false);
+            for (const auto& collapse : collapses) {
+                if (collapse.error > maxErrorSquared || removedTriangles >= trianglesToRemove)
+                    break;
+                if (touched[collapse.from] || touched[collapse.to] || flips(collapse))
+                    continue;
+
+                remap[collapse.from] = collapse.to;
+                quadrics[positionOf[collapse.to]] += quadrics[positionOf[collapse.from]];
+                worstError = std::max(worstError, collapse.error);
+                removedTriangles += 2;
+
+                // Neighbours are locked for the rest of the pass, their flip tests would use stale triangles
+                for (u32 i = adjacencyOffsets[collapse.from]; i < adjacencyOffsets[collapse.from + 1]; i++) {
+                    const auto triangle = adjacency[i] * 3;
+                    for (u32 corner = 0; corner < 3; corner++) {
+                        touched[result[triangle + corner]] = true;
+                    }
+                }
+            }
+            if (removedTriangles == 0)
+                break;
+
+            usize write = 0;
+            for (usize i = 0; i < result.size(); i += 3) {
+                const auto a = remap[result[i]];
+                const auto b = remap[result[i + 1]];
+                const auto c = remap[result[i + 2]];
+                if (a == b || b == c || a == c)
+                    continue;
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+            result.resize(write);
+        }
+
+        if (resultError) {
+            *resultError = std::sqrt(worstError);
+        }
+        return result;
+    }
+
+    void GenerateMeshLODs(MeshData& mesh, const MeshLODDesc& desc)
+    {
+        if (!mesh.lods.empty()) {
+            PANIC("Mesh already has LODs");
+        }
+
+        const auto baseIndexCount = static_cast<u32>(mesh.indices.size());
+        mesh.lods.push_back({.firstIndex = 0, .indexCount = baseIndexCount, .error = 0});
+
+        // Every LOD is simplified from the full detail mesh so its error is measured against the original
+        const std::vector<u32> base = mesh.indices;
+        const auto vertexCount = static_cast<u32>(mesh.vertices.size());
+        u32 previousIndexCount = baseIndexCount;
+        for (u32 i = 0; i < desc.maxLODs; i++) {
+            const auto targetTriangles = static_cast<u32>(static_cast<f32>(previousIndexCount / 3) * desc.reduction);
+            const auto targetIndexCount = targetTriangles * 3;
+            if (targetIndexCount < 3)
+                break;
+
+            f32 error = 0;
+            auto lod = SimplifyMesh(mesh.vertices, base, targetIndexCount, desc.maxError, &error);
+            if (static_cast<f32>(lod.size()) > static_cast<f32>(previousIndexCount) * (1.0f - desc.minReduction))
+                break;
+
+            OptimizeIndexOrder(lod, vertexCount);
+            mesh.lods.push_back({
+                .firstIndex = static_cast<u32>(mesh.indices.size()),
+                .indexCount = static_cast<u32>(lod.size()),
+                .error = std::max(error, mesh.lods.back().error),
+            });
+            mesh.indices.insert(mesh.indices.end(), lod.begin(), lod.end());
+            previousIndexCount = static_cast<u32>(lod.size());
+        }
+    }
+} // namespace Cocoa::Graphics
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <span>
+
+#include "../utils/types.h"
+
+namespace Cocoa::Graphics {
+    struct MeshLODDesc
+    {
+        /// @brief LODs to generate on top of the full detail mesh
+        u32 maxLODs = 4;
+        /// @brief Fraction of triangles each LOD keeps relative to the one before it
+        f32 reduction = 0.5f;
+        /// @brief Largest error, in mesh units, a LOD may have before generation stops
+        f32 maxError = f32Max;
+        /// @brief LODs that remove less than this fraction of the previous LOD's triangles are dropped
+        f32 minReduction = 0.1f;
+    };
+
+    /// @brief Collapses edges by quadric error until the target is reached, reusing the mesh's own vertices
+    /// @param targetIndexCount Stops once the result has no more indices than this
+    /// @param targetError Stops before a collapse would move the surface further than this, in mesh units
+    /// @param resultError Receives the largest error of any collapse that was made
+    /// @note Border and UV/color seam vertices are never moved so the result stays watertight where the input is
+    std::vector<u32> SimplifyMesh(
+        const std::vector<Vertex>& vertices, std::span<const u32> indices, u32 targetIndexCount, f32 targetError,
+        f32* resultError = nullptr
+    );
+
+    /// @brief Appends simplified index lists to the mesh and describes them in mesh.lods
+    /// @note Run after OptimizeMesh, every LOD shares the vertices of the full detail mesh
+    void GenerateMeshLODs(MeshData& mesh, const MeshLODDesc& desc = {});
+} // namespace Cocoa::Graphics
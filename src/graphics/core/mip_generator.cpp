@@ -0,0 +1,277 @@
+#include "mip_generator.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+#include "../../macros.h"
+#include "../utils/float4.h"
+
+namespace Cocoa::Graphics {
+    namespace {
+        constexpr u32 KaiserTaps = 8;
+        constexpr u32 LinearToSRGBSteps = 4096;
+
+        f32 SRGBToLinear(const f32 value)
+        {
+            return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+
+        f32 LinearToSRGB(const f32 value)
+        {
+            return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        }
+
+        const std::array<f32, 256>& GetSRGBDecodeTable()
+        {
+            static const auto table = [] {
+                std::array<f32, 256> result{};
+                for (u32 i = 0; i < 256; i++) {
+                    result[i] = SRGBToLinear(static_cast<f32>(i) / 255.0f);
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        const std::array<u8, LinearToSRGBSteps>& GetSRGBEncodeTable()
+        {
+            static const auto table = [] {
+                std::array<u8, LinearToSRGBSteps> result{};
+                for (u32 i = 0; i < LinearToSRGBSteps; i++) {
+                    const f32 linear = static_cast<f32>(i) / static_cast<f32>(LinearToSRGBSteps - 1);
+                    result[i] = static_cast<u8>(std::lround(LinearToSRGB(linear) * 255.0f));
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        /// @brief Weights for halving a row, sampled at -3.5 to 3.5 texels around the centre of each texel pair
+        const std::array<f32, KaiserTaps>& GetKaiserWeights()
+        {
+            static const auto weights = [] {
+                // Zeroth order modified Bessel function, the series converges fast for the alpha used here
+                auto bessel = [](const f32 x) {
+                    f32 sum = 1.0f, term = 1.0f;
+                    for (u32 k = 1; k < 16; k++) {
+                        term *= (x * 0.5f / static_cast<f32>(k)) * (x * 0.5f / static_cast<f32>(k));
+                        sum += term;
+                    }
+                    return sum;
+                };
+                constexpr f32 alpha = 4.0f;
+                constexpr f32 pi = 3.14159265358979f;
+
+                std::array<f32, KaiserTaps> result{};
+                f32 total = 0;
+                for (u32 i = 0; i < KaiserTaps; i++) {
+                    // Distance in destination texels, the window spans the whole 8 source texels
+                    const f32 x = (static_cast<f32>(i) - 3.5f) * 0.5f;
+                    const f32 sinc = std::sin(pi * x) / (pi * x);
+                    const f32 window = x / 2.0f;
+                    result[i] = sinc * bessel(alpha * std::sqrt(1.0f - window * window)) / bessel(alpha);
+                    total += result[i];
+                }
+                for (auto& weight : result) {
+                    weight /= total;
+                }
+                return result;
+            }();
+            return weights;
+        }
+
+        /// @brief Runs rows [0, rows) in chunks across the job system, or inline when there is none
+        template <typename F> void ParallelRows(Tools::JobSystem* jobs, const u32 rows, F&& function)
+        {
+            // Small levels aren't worth the hand off
+            constexpr u32 RowsPerJob = 16;
+            if (jobs) {
+                jobs->ParallelFor(rows, RowsPerJob, function);
+            } else {
+                function(0u, rows);
+            }
+        }
+
+        void Decode(const u8* src, f32* dst, const u64 texels, const bool srgb)
+        {
+            const auto& table = GetSRGBDecodeTable();
+            for (u64 i = 0; i < texels * 4; i++) {
+                const bool color = srgb && i % 4 != 3;
+                dst[i] = color ? table[src[i]] : static_cast<f32>(src[i]) / 255.0f;
+            }
+        }
+
+        void Encode(const f32* src, u8* dst, const u64 texels, const bool srgb)
+        {
+            const auto& table = GetSRGBEncodeTable();
+            alignas(16) f32 values[4];
+            for (u64 i = 0; i < texels; i++) {
+                Float4::Load(src + i * 4).Saturate().Store(values);
+                for (u32 channel = 0; channel < 4; channel++) {
+                    if (srgb && channel != 3) {
+                        const auto step = static_cast<u32>(values[channel] * (LinearToSRGBSteps - 1) + 0.5f);
+                        dst[i * 4 + channel] = table[step];
+                    } else {
+                        dst[i * 4 + channel] = static_cast<u8>(values[channel] * 255.0f + 0.5f);
+                    }
+                }
+            }
+        }
+
+        void DownsampleBox(
+            const f32* src, const u32 srcWidth, const u32 srcHeight, f32* dst, const u32 dstWidth,
+            const u32 rowBegin, const u32 rowEnd
+        )
+        {
+            // Levels are src / 2 rounded down, so odd sizes drop their last row or column. The clamps only matter once
+            // a side is down to one texel and both taps read it.
+            const auto quarter = Float4::Splat(0.25f);
+            for (u32 y = rowBegin; y < rowEnd; y++) {
+                const f32* row0 = src + static_cast<u64>(std::min(y * 2, srcHeight - 1)) * srcWidth * 4;
+                const f32* row1 = src + static_cast<u64>(std::min(y * 2 + 1, srcHeight - 1)) * srcWidth * 4;
+                for (u32 x = 0; x < dstWidth; x++) {
+                    const u32 x0 = std::min(x * 2, srcWidth - 1) * 4;
+                    const u32 x1 = std::min(x * 2 + 1, srcWidth - 1) * 4;
+                    const auto sum = Float4::Load(row0 + x0) + Float4::Load(row0 + x1) + Float4::Load(row1 + x0) +
+                                     Float4::Load(row1 + x1);
+                    (sum * quarter).Store(dst + (static_cast<u64>(y) * dstWidth + x) * 4);
+                }
+            }
+        }
+
+        /// @brief Halves the width of rows [rowBegin, rowEnd), the vertical pass then halves the height
+        void KaiserHorizontal(
+            const f32* src, const u32 srcWidth, f32* dst, const u32 dstWidth, const u32 rowBegin, const u32 rowEnd
+        )
+        {
+            const auto& weights = GetKaiserWeights();
+            for (u32 y = rowBegin; y < rowEnd; y++) {
+                const f32* srcRow = src + static_cast<u64>(y) * srcWidth * 4;
+                f32* dstRow = dst + static_cast<u64>(y) * dstWidth * 4;
+                for (u32 x = 0; x < dstWidth; x++) {
+                    auto sum = Float4::Splat(0.0f);
+                    for (u32 tap = 0; tap < KaiserTaps; tap++) {
+                        const auto sx = std::clamp(static_cast<i64>(x) * 2 - 3 + tap, i64{0}, i64{srcWidth} - 1);
+                        sum = sum + Float4::Load(srcRow + sx * 4) * Float4::Splat(weights[tap]);
+                    }
+                    sum.Store(dstRow + static_cast<u64>(x) * 4);
+                }
+            }
+        }
+
+        void KaiserVertical(
+            const f32* src, const u32 srcHeight, f32* dst, const u32 width, const u32 rowBegin, const u32 rowEnd
+        )
+        {
+            const auto& weights = GetKaiserWeights();
+            const u64 stride = static_cast<u64>(width) * 4;
+            for (u32 y = rowBegin; y < rowEnd; y++) {
+                const f32* rows[KaiserTaps];
+                for (u32 tap = 0; tap < KaiserTaps; tap++) {
+                    const auto sy = std::clamp(static_cast<i64>(y) * 2 - 3 + tap, i64{0}, i64{srcHeight} - 1);
+                    rows[tap] = src + static_cast<u64>(sy) * stride;
+                }
+                f32* dstRow = dst + static_cast<u64>(y) * stride;
+                for (u64 x = 0; x < stride; x += 4) {
+                    auto sum = Float4::Splat(0.0f);
+                    for (u32 tap = 0; tap < KaiserTaps; tap++) {
+                        sum = sum + Float4::Load(rows[tap] + x) * Float4::Splat(weights[tap]);
+                    }
+                    sum.Store(dstRow + x);
+                }
+            }
+        }
+    } // namespace
+
+    u32 GetMipLevelCount(const u32 width, const u32 height)
+    {
+        return static_cast<u32>(std::bit_width(std::max({width, height, 1u})));
+    }
+
+    MipChainLayout GetMipChainLayout(const u32 width, const u32 height, u32 levels, const GPUColorFormat format)
+    {
+        levels = levels == 0 ? GetMipLevelCount(width, height) : std::min(levels, GetMipLevelCount(width, height));
+
+        MipChainLayout layout;
+        for (u32 level = 0; level < levels; level++) {
+            const u32 levelWidth = std::max(width >> level, 1u);
+            const u32 levelHeight = std::max(height >> level, 1u);
+            layout.levels.push_back({.offset = layout.size, .width = levelWidth, .height = levelHeight});
+            layout.size += GetTextureLevelSize(format, levelWidth, levelHeight);
+        }
+        return layout;
+    }
+
+    void GenerateMips(const std::span<u8> chain, const MipChainLayout& layout, const MipGenerateDesc& desc)
+    {
+        if (chain.size() < layout.size) {
+            PANIC(
+                "Mip chain needs %llu bytes but only got %zu", static_cast<unsigned long long>(layout.size),
+                chain.size()
+            );
+        }
+        if (layout.levels.size() < 2)
+            return;
+
+        // Every level is filtered from the float copy of the one above, so rounding doesn't build up down the chain
+        const auto& base = layout.levels.front();
+        std::vector<f32> current(static_cast<u64>(base.width) * base.height * 4);
+        std::vector<f32> next;
+        std::vector<f32> scratch;
+        ParallelRows(desc.jobs, base.height, [&](const u32 begin, const u32 end) {
+            const u64 start = static_cast<u64>(begin) * base.width * 4;
+            Decode(
+                chain.data() + start, current.data() + start, static_cast<u64>(end - begin) * base.width, desc.srgb
+            );
+        });
+
+        for (usize level = 1; level < layout.levels.size(); level++) {
+            const auto& src = layout.levels[level - 1];
+            const auto& dst = layout.levels[level];
+            next.resize(static_cast<u64>(dst.width) * dst.height * 4);
+
+            if (desc.filter == MipFilter::Box) {
+                ParallelRows(desc.jobs, dst.height, [&](const u32 begin, const u32 end) {
+                    DownsampleBox(current.data(), src.width, src.height, next.data(), dst.width, begin, end);
+                });
+            } else {
+                scratch.resize(static_cast<u64>(dst.width) * src.height * 4);
+                ParallelRows(desc.jobs, src.height, [&](const u32 begin, const u32 end) {
+                    KaiserHorizontal(current.data(), src.width, scratch.data(), dst.width, begin, end);
+                });
+                ParallelRows(desc.jobs, dst.height, [&](const u32 begin, const u32 end) {
+                    KaiserVertical(scratch.data(), src.height, next.data(), dst.width, begin, end);
+                });
+            }
+
+            ParallelRows(desc.jobs, dst.height, [&](const u32 begin, const u32 end) {
+                const u64 start = static_cast<u64>(begin) * dst.width;
+                Encode(
+                    next.data() + start * 4, chain.data() + dst.offset + start * 4,
+                    static_cast<u64>(end - begin) * dst.width, desc.srgb
+                );
+            });
+            std::swap(current, next);
+        }
+    }
+
+    std::vector<GPUTextureUpload> GetMipChainUploads(
+        const GPUBufferHandle& buffer, const GPUTextureHandle& texture, const MipChainLayout& layout,
+        const u64 bufferOffset
+    )
+    {
+        std::vector<GPUTextureUpload> uploads;
+        uploads.reserve(layout.levels.size());
+        for (u32 level = 0; level < layout.levels.size(); level++) {
+            uploads.push_back({
+                .srcBuffer = buffer,
+                .dstTexture = texture,
+                .bufferOffset = bufferOffset + layout.levels[level].offset,
+                .level = level,
+            });
+        }
+        return uploads;
+    }
+} // namespace Cocoa::Graphics
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "../../tools/job_system.h"
+#include "../utils/descriptors.h"
+
+namespace Cocoa::Graphics {
+    enum class MipFilter
+    {
+        /// @brief Averages each 2x2 block, cheap but lets some aliasing through
+        Box,
+        /// @brief Kaiser windowed sinc over 8x8 texels, keeps small details sharp without ringing much
+        Kaiser
+    };
+
+    struct MipGenerateDesc
+    {
+        MipFilter filter = MipFilter::Kaiser;
+        /// @brief Color channels hold sRGB values, filtering happens on the linear values so mips don't darken
+        bool srgb = true;
+        /// @brief Splits every level's rows across the job system, mips are generated on the calling thread when null
+        Tools::JobSystem* jobs = nullptr;
+    };
+
+    struct MipLevelLayout
+    {
+        u64 offset;
+        u32 width;
+        u32 height;
+    };
+
+    /// @brief Where every level of a tightly packed mip chain sits in memory
+    struct MipChainLayout
+    {
+        std::vector<MipLevelLayout> levels;
+        u64 size = 0;
+    };
+
+    /// @return Levels in a full chain down to 1x1
+    u32 GetMipLevelCount(u32 width, u32 height);
+
+    /// @param levels 0 gives the full chain
+    /// @param format Block compressed formats round every level up to whole blocks
+    MipChainLayout GetMipChainLayout(
+        u32 width, u32 height, u32 levels = 0, GPUColorFormat format = GPUColorFormat::RGBA8_Unorm
+    );
+
+    /// @brief Fills levels 1 and up of an RGBA8 chain from level 0, which must already be in place
+    /// @param layout Layout of the chain for RGBA8_Unorm or RGBA8_SRGB
+    void GenerateMips(std::span<u8> chain, const MipChainLayout& layout, const MipGenerateDesc& desc = {});
+
+    /// @brief Uploads for every level of a chain, UploadBufferDataToTextures copies them with a single command
+    std::vector<GPUTextureUpload> GetMipChainUploads(
+        const GPUBufferHandle& buffer, const GPUTextureHandle& texture, const MipChainLayout& layout,
+        u64 bufferOffset = 0
+    );
+} // namespace Cocoa::Graphics
@@ -0,0 +1,83 @@
+#include "range_allocator.h"
+
+#include "../../macros.h"
+
+namespace Cocoa::Graphics {
+    RangeAllocator::RangeAllocator(const u64 capacity) : _capacity(capacity)
+    {
+        if (capacity > 0) {
+            InsertFree(0, capacity);
+        }
+    }
+
+    std::optional<u64> RangeAllocator::Allocate(const u64 size)
+    {
+        if (size == 0)
+            return std::nullopt;
+
+        const auto bestFit = _freeBySize.lower_bound(size);
+        if (bestFit == _freeBySize.end())
+            return std::nullopt;
+
+        const auto [rangeSize, offset] = *bestFit;
+        EraseFree(_freeByOffset.find(offset));
+        if (rangeSize > size) {
+            InsertFree(offset + size, rangeSize - size);
+        }
+
+        _used += size;
+        return offset;
+    }
+
+    void RangeAllocator::Free(u64 offset, u64 size)
+    {
+        if (size == 0)
+            return;
+        if (size > _capacity || offset > _capacity - size) {
+            PANIC("Tried to free a range outside of the allocator");
+        }
+        _used -= size;
+
+        // Merge with the free range right after this one
+        if (const auto next = _freeByOffset.find(offset + size); next != _freeByOffset.end()) {
+            size += next->second;
+            EraseFree(next);
+        }
+
+        // And with the one right before it
+        if (auto previous = _freeByOffset.lower_bound(offset); previous != _freeByOffset.begin()) {
+            --previous;
+            if (previous->first + previous->second == offset) {
+                offset = previous->first;
+                size += previous->second;
+                EraseFree(previous);
+            }
+        }
+
+        InsertFree(offset, size);
+    }
+
+    u64 RangeAllocator::GetLargestFreeRange() const
+    {
+        return _freeBySize.empty() ? 0 : _freeBySize.rbegin()->first;
+    }
+
+    void RangeAllocator::InsertFree(const u64 offset, const u64 size)
+    {
+        _freeByOffset.emplace(offset, size);
+        _freeBySize.emplace(size, offset);
+    }
+
+    void RangeAllocator::EraseFree(const std::map<u64, u64>::iterator range)
+    {
+        const auto [offset, size] = *range;
+        auto [first, last] = _freeBySize.equal_range(size);
+        for (; first != last; ++first) {
+            if (first->second == offset) {
+                _freeBySize.erase(first);
+                break;
+            }
+        }
+        _freeByOffset.erase(range);
+    }
+} // namespace Cocoa::Graphics
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <map>
+#include <optional>
+
+#include "../../common.h"
+
+namespace Cocoa::Graphics {
+    /// @brief Hands out ranges of a fixed size space, e.g. elements of a large buffer
+    /// @note Picks the smallest free range that fits and merges neighbouring ranges when they are freed
+    class RangeAllocator
+    {
+      public:
+        explicit RangeAllocator(u64 capacity);
+
+        /// @return The offset of the range, or nullopt when no free range is large enough
+        [[nodiscard]] std::optional<u64> Allocate(u64 size);
+
+        void Free(u64 offset, u64 size);
+
+        [[nodiscard]] u64 GetCapacity() const { return _capacity; }
+        [[nodiscard]] u64 GetUsed() const { return _used; }
+        [[nodiscard]] u64 GetLargestFreeRange() const;
+
+      private:
+        u64 _capacity;
+        u64 _used = 0;
+        /// @brief Free ranges keyed by offset, used to find neighbours to merge with
+        std::map<u64, u64> _freeByOffset;
+        /// @brief Free ranges keyed by size, used to find the best fit
+        std::multimap<u64, u64> _freeBySize;
+
+        void InsertFree(u64 offset, u64 size);
+        void EraseFree(std::map<u64, u64>::iterator range);
+    };
+} // namespace Cocoa::Graphics
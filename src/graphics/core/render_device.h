@@ -29,14 +29,69 @@ namespace Cocoa::Graphics {
 
         virtual GPUBindGroupHandle CreateBindGroup(const GPUBindGroupDesc& desc) = 0;
 
+        /// @brief Points the given bindings of an existing group at new resources, the others keep theirs
+        /// @note Writing every binding once goes through the layout's update template, fewer are queued one by one.
+        /// The group must not be used by a frame still in flight.
+        virtual void UpdateBindGroup(GPUBindGroupHandle& handle, const GPUBindGroupDesc& desc) = 0;
+
         virtual GPUBindGroupLayoutHandle CreateBindGroupLayout(const GPUBindGroupLayoutDesc& desc) = 0;
 
         virtual GFXRenderPipelineHandle CreateRenderPipeline(const GFXPipelineDesc& desc) = 0;
 
+        /// @brief Compiles a render pipeline on a worker thread, returning before it's ready
+        /// @param placeholder Bound by encoders while the pipeline compiles, draws are skipped when it's invalid
+        /// @note The shader modules and pipeline layout must outlive the compile
+        virtual GFXRenderPipelineHandle CreateRenderPipelineAsync(
+            const GFXPipelineDesc& desc, GFXRenderPipelineHandle placeholder = GFXRenderPipelineHandle(u64Max)
+        ) = 0;
+
+        /// @brief Gets the slot a texture view occupies in the bindless texture array
+        /// @return u32Max when bindless is disabled or the view isn't a sampled 2D view
+        [[nodiscard]] virtual u32 GetTextureViewBindlessIndex(GPUTextureViewHandle& handle) = 0;
+
+        /// @brief Gets the slot a sampler occupies in the bindless sampler array
+        [[nodiscard]] virtual u32 GetSamplerBindlessIndex(GPUSamplerHandle& handle) = 0;
+
+        /// @brief Gets the slot a storage buffer occupies in the bindless buffer array
+        [[nodiscard]] virtual u32 GetBufferBindlessIndex(GPUBufferHandle& handle) = 0;
+
+        /// @brief Gets the CPU pointer of a buffer created with host access
+        /// @return nullptr for GPUOnly buffers
+        [[nodiscard]] virtual void* GetBufferMappedData(GPUBufferHandle& handle) = 0;
+
+        /// @brief Frames the CPU may record ahead of the GPU, resources a frame used are only safe to destroy once the
+        /// device is that many frames further
+        [[nodiscard]] virtual u32 GetFramesInFlight() const = 0;
+
+        /// @brief Whether textures can use the BC formats, desktop GPUs support them but many mobile ones don't
+        [[nodiscard]] virtual bool IsBlockCompressionSupported() = 0;
+
+        /// @brief Checks whether a pipeline has finished compiling, synchronously created pipelines always are
+        /// @note A pipeline whose compile failed never becomes ready, draws with it use its placeholder or are skipped
+        [[nodiscard]] virtual bool IsRenderPipelineReady(GFXRenderPipelineHandle& handle) = 0;
+
         virtual GFXPipelineLayoutHandle CreatePipelineLayout(const GFXPipelineLayoutDesc& desc) = 0;
 
         virtual GFXShaderModuleHandle CreateShaderModule(const GFXShaderModuleDesc& desc) = 0;
 
+        /// @brief Replaces the code of a shader module, pipelines already built from it keep the old code
+        /// @note Waits for pipelines that are compiling, since they could still be reading the old module
+        virtual void ReloadShaderModule(GFXShaderModuleHandle& handle, const GFXShaderModuleDesc& desc) = 0;
+
+        /// @brief Recompiles a pipeline from its description on a worker thread, picking up reloaded shaders
+        /// @note The old pipeline stays bound until the new one is ready, and is destroyed once no frame uses it
+        virtual void RebuildRenderPipeline(GFXRenderPipelineHandle& handle) = 0;
+
+        /// @brief Allocates a block of GPU memory that several resources can be placed into
+        virtual GPUMemoryHeapHandle CreateMemoryHeap(const GPUMemoryRequirements& requirements) = 0;
+
+        /// @brief Creates a texture that lives inside a memory heap instead of owning its memory
+        /// @note Textures placed at overlapping offsets share memory, only one may be in use at a time
+        virtual GPUTextureHandle
+        CreateAliasedTexture(const GPUTextureDesc& desc, GPUMemoryHeapHandle& heap, u64 offset) = 0;
+
+        [[nodiscard]] virtual GPUMemoryRequirements GetTextureMemoryRequirements(const GPUTextureDesc& desc) = 0;
+
         virtual void DisconnectWindow(RenderWindowHandle& handle) = 0;
 
         virtual void DestroyBuffer(GPUBufferHandle& handle) = 0;
@@ -57,6 +112,15 @@ namespace Cocoa::Graphics {
 
         virtual void DestroyShaderModule(GFXShaderModuleHandle& handle) = 0;
 
+        virtual void DestroyMemoryHeap(GPUMemoryHeapHandle& handle) = 0;
+
+        /// @brief Starts compacting GPU-only vertex and index buffers
+        /// @note The work is spread over the following frames, a few buffers are moved at the start of each
+        virtual void BeginDefragmentation() = 0;
+
+        /// @brief Reports per-heap budget and usage alongside allocation totals, meant for logging
+        [[nodiscard]] virtual GPUMemoryStats GetMemoryStats() = 0;
+
         virtual void WaitForIdle() = 0;
 
         virtual std::unique_ptr<RenderEncoder> Encode(const RenderEncoderDesc& encoderDesc) = 0;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 #include "../utils/descriptors.h"
 #include "../utils/handles.h"
 #include "../utils/types.h"
@@ -9,7 +11,9 @@ namespace Cocoa::Graphics {
 
     struct RenderEncoderState
     {
-        GFXRenderPipelineHandle* currentPipeline = nullptr;
+        GFXRenderPipelineHandle currentPipeline = GFXRenderPipelineHandle(u64Max);
+        /// @brief Set while the bound pipeline is still compiling and has no placeholder to stand in
+        bool skipDraws = false;
     };
 
     class RenderEncoder
@@ -17,10 +21,31 @@ namespace Cocoa::Graphics {
       public:
         virtual ~RenderEncoder() = default;
 
-        virtual void TransitionTextureState(GPUTextureHandle& texture, GPUTextureState newState) = 0;
+        /// @brief Queues a state change for part of a texture
+        /// @note Transitions are batched and recorded right before the next command that depends on them
+        virtual void TransitionTextureState(
+            GPUTextureHandle& texture, GPUTextureState newState, const GPUTextureSubresourceRange& range = {}
+        ) = 0;
 
         virtual void UploadBufferDataToTexture(GPUBufferHandle& srcBuffer, GPUTextureHandle& dstTexture) = 0;
 
+        /// @brief Copies many buffers into textures using one barrier before and one barrier after the copies
+        virtual void UploadBufferDataToTextures(const std::vector<GPUTextureUpload>& uploads) = 0;
+
+        /// @brief Fills every mip level below the first from the one above it, for all layers
+        /// @param finalState State every level is left in afterwards
+        /// @note The texture needs TransferSrc and TransferDst usage, levels are filtered linearly when the format
+        /// supports it and with nearest sampling otherwise
+        virtual void GenerateMipmaps(
+            GPUTextureHandle& texture, GPUTextureState finalState = GPUTextureState::ShaderReadOnly
+        ) = 0;
+
+        /// @brief Copies a byte range between buffers, made visible to vertex/index reads and later copies
+        /// @note The barrier after the copy is batched with the next texture transitions
+        virtual void CopyBufferToBuffer(
+            GPUBufferHandle& srcBuffer, GPUBufferHandle& dstBuffer, u64 size, u64 srcOffset = 0, u64 dstOffset = 0
+        ) = 0;
+
         virtual void StartRenderPass(const GPUPassDesc& renderPassDescriptor) = 0;
 
         virtual void SetRenderPipeline(GFXRenderPipelineHandle& renderPipeline) = 0;
@@ -29,12 +54,36 @@ namespace Cocoa::Graphics {
 
         virtual void SetRenderArea(const RenderArea& renderArea) = 0;
 
-        virtual void SetVertexBuffer(GPUBufferHandle& vertexBuffer) = 0;
+        /// @param offset Byte offset of the first vertex, for buffers holding more than one mesh
+        virtual void SetVertexBuffer(GPUBufferHandle& vertexBuffer, u64 offset = 0) = 0;
 
-        virtual void SetIndexBuffer(GPUBufferHandle& indexBuffer) = 0;
+        /// @param offset Byte offset of the first index, for buffers holding more than one mesh
+        virtual void SetIndexBuffer(
+            GPUBufferHandle& indexBuffer, u64 offset = 0, GPUIndexFormat format = GPUIndexFormat::Uint16
+        ) = 0;
 
         virtual void SetBindGroup(GPUBindGroupHandle& bindGroup) = 0;
 
+        /// @brief Writes small per-draw data directly into the command stream
+        /// @param visibility The shader stages that read this range, must match the pipeline layout
+        /// @param data Pointer to the bytes to push
+        /// @param size Size of the data in bytes
+        /// @param offset Byte offset into the push constant block
+        virtual void SetPushConstants(GPUShaderStage visibility, const void* data, u32 size, u32 offset = 0) = 0;
+
+        template <typename T>
+            requires(!std::is_pointer_v<T>)
+        void SetPushConstants(GPUShaderStage visibility, const T& data, u32 offset = 0)
+        {
+            SetPushConstants(visibility, &data, sizeof(T), offset);
+        }
+
+        virtual void Draw(u32 vertexCount, u32 instanceCount = 1, u32 firstVertex = 0, u32 firstInstance = 0) = 0;
+
+        virtual void DrawIndexed(
+            u32 indexCount, u32 instanceCount = 1, u32 firstIndex = 0, i32 vertexOffset = 0, u32 firstInstance = 0
+        ) = 0;
+
         virtual void EndRenderPass() = 0;
 
         virtual void Stop() = 0;
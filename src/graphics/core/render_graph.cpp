@@ -0,0 +1,359 @@
+#include "render_graph.h"
+
+#include <algorithm>
+
+namespace Cocoa::Graphics {
+    namespace {
+        u64 AlignUp(const u64 value, const u64 alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+        GPUTextureAspect InferTextureAspect(const GPUTextureDesc& desc)
+        {
+            if (!std::holds_alternative<GPUDepthStencilFormat>(desc.format))
+                return GPUTextureAspect::Color;
+
+            switch (std::get<GPUDepthStencilFormat>(desc.format)) {
+            case GPUDepthStencilFormat::DepthFloat32_NoStencil:
+            case GPUDepthStencilFormat::DepthUnorm16_NoStencil: return GPUTextureAspect::Depth;
+            default:                                            break;
+            }
+            // Shaders can only sample one aspect through a view, attachments need both
+            if (desc.usage & GPUTextureUsage::ShaderUsage)
+                return GPUTextureAspect::Depth;
+            return GPUTextureAspect::Depth | GPUTextureAspect::Stencil;
+        }
+
+        GPUTextureViewType InferTextureViewType(const GPUTextureDimension dimension)
+        {
+            switch (dimension) {
+            case GPUTextureDimension::One:   return GPUTextureViewType::OneDimensional;
+            case GPUTextureDimension::Three: return GPUTextureViewType::ThreeDimensional;
+            default:                         return GPUTextureViewType::TwoDimensional;
+            }
+        }
+    } // namespace
+
+    RenderGraphResource RenderGraphBuilder::CreateTexture(const std::string& name, const GPUTextureDesc& desc)
+    {
+        auto& resource = _graph._resources.emplace_back();
+        resource.name = name;
+        resource.desc = desc;
+        resource.texture.Invalidate();
+        resource.view.Invalidate();
+        return static_cast<RenderGraphResource>(_graph._resources.size() - 1);
+    }
+
+    RenderGraphResource RenderGraphBuilder::Read(const RenderGraphResource resource, const GPUTextureState state)
+    {
+        if (resource >= _graph._resources.size()) {
+            PANIC("Pass %s reads an unknown resource", _graph._passes[_pass].name.c_str());
+        }
+        _graph._passes[_pass].reads.push_back({resource, state, _graph._resources[resource].version});
+        return resource;
+    }
+
+    RenderGraphResource RenderGraphBuilder::Write(const RenderGraphResource resource, const GPUTextureState state)
+    {
+        if (resource >= _graph._resources.size()) {
+            PANIC("Pass %s writes an unknown resource", _graph._passes[_pass].name.c_str());
+        }
+        _graph._passes[_pass].writes.push_back({resource, state, ++_graph._resources[resource].version});
+        return resource;
+    }
+
+    void RenderGraphBuilder::SideEffect() { _graph._passes[_pass].sideEffect = true; }
+
+    RenderGraph::RenderGraph(RenderDevice& device) : _device(device), _slots(device.GetFramesInFlight()) {}
+
+    RenderGraph::~RenderGraph()
+    {
+        RetireTransients();
+        for (auto& slot : _slots) {
+            DestroyRetired(slot);
+            if (slot.heap.IsValid()) {
+                _device.DestroyMemoryHeap(slot.heap);
+            }
+        }
+    }
+
+    RenderGraphResource RenderGraph::ImportTexture(
+        const std::string& name, const GPUTextureHandle texture, const GPUTextureViewHandle view,
+        const GPUTextureState finalState
+    )
+    {
+        auto& resource = _resources.emplace_back();
+        resource.name = name;
+        resource.texture = texture;
+        resource.view = view;
+        resource.finalState = finalState;
+        resource.imported = true;
+        return static_cast<RenderGraphResource>(_resources.size() - 1);
+    }
+
+    void RenderGraph::AddPass(const std::string& name, const RenderGraphSetupFun& setup, RenderGraphExecuteFun execute)
+    {
+        auto& pass = _passes.emplace_back();
+        pass.name = name;
+        pass.execute = std::move(execute);
+
+        RenderGraphBuilder builder(*this, static_cast<u32>(_passes.size() - 1));
+        setup(builder);
+        _compiled = false;
+    }
+
+    void RenderGraph::Compile()
+    {
+        RetireTransients();
+        _stats = {};
+        _stats.passes = static_cast<u32>(_passes.size());
+
+        CullPasses();
+        ComputeLifetimes();
+        PlaceTransients();
+        CreateTransients();
+        _compiled = true;
+    }
+
+    void RenderGraph::Execute(RenderEncoder* encoder)
+    {
+        if (!_compiled) {
+            Compile();
+        }
+
+        // The device waited for this frame's previous use before handing out the encoder
+        if (_retiredPending) {
+            DestroyRetired(_slots[_slot]);
+            _retiredPending = false;
+        }
+
+        for (auto& pass : _passes) {
+            if (pass.culled)
+                continue;
+
+            // The encoder drops read-only transitions to the same state and batches the rest,
+            // so every pass costs at most one barrier call
+            for (const auto& read : pass.reads) {
+                const bool alsoWritten = std::ranges::any_of(pass.writes, [&](const ResourceUsage& write) {
+                    return write.resource == read.resource;
+                });
+                if (!alsoWritten) {
+                    encoder->TransitionTextureState(_resources[read.resource].texture, read.state);
+                }
+            }
+            for (const auto& write : pass.writes) {
+                encoder->TransitionTextureState(_resources[write.resource].texture, write.state);
+            }
+
+            pass.execute(*this, encoder);
+        }
+
+        for (auto& resource : _resources) {
+            if (resource.imported && resource.finalState != GPUTextureState::Unknown) {
+                encoder->TransitionTextureState(resource.texture, resource.finalState);
+            }
+        }
+    }
+
+    void RenderGraph::Reset()
+    {
+        RetireTransients();
+        _passes.clear();
+        _resources.clear();
+        _compiled = false;
+
+        _slot = (_slot + 1) % static_cast<u32>(_slots.size());
+        _retiredPending = true;
+    }
+
+    GPUTextureHandle& RenderGraph::GetTexture(const RenderGraphResource resource)
+    {
+        return _resources[resource].texture;
+    }
+
+    GPUTextureViewHandle& RenderGraph::GetTextureView(const RenderGraphResource resource)
+    {
+        return _resources[resource].view;
+    }
+
+    void RenderGraph::CullPasses()
+    {
+        // Walk backwards so a pass is only kept when something after it reads the version it writes, a write that
+        // is overwritten before anyone reads it doesn't keep its pass alive
+        std::vector<std::vector<bool>> needed(_resources.size());
+        for (usize i = 0; i < _resources.size(); i++) {
+            needed[i].assign(_resources[i].version + 1, false);
+        }
+        for (usize i = _passes.size(); i-- > 0;) {
+            auto& pass = _passes[i];
+
+            bool live = pass.sideEffect;
+            for (const auto& write : pass.writes) {
+                live |= _resources[write.resource].imported || needed[write.resource][write.version];
+            }
+
+            pass.culled = !live;
+            if (!live) {
+                _stats.culledPasses++;
+                continue;
+            }
+
+            for (const auto& read : pass.reads) {
+                needed[read.resource][read.version] = true;
+            }
+        }
+    }
+
+    void RenderGraph::ComputeLifetimes()
+    {
+        for (u32 i = 0; i < _passes.size(); i++) {
+            const auto& pass = _passes[i];
+            if (pass.culled)
+                continue;
+
+            auto touch = [&](const ResourceUsage& usage) {
+                auto& resource = _resources[usage.resource];
+                resource.firstPass = std::min(resource.firstPass, i);
+                resource.lastPass = std::max(resource.lastPass, i);
+            };
+            std::ranges::for_each(pass.reads, touch);
+            std::ranges::for_each(pass.writes, touch);
+        }
+    }
+
+    void RenderGraph::PlaceTransients()
+    {
+        std::vector<u32> transients;
+        for (u32 i = 0; i < _resources.size(); i++) {
+            auto& resource = _resources[i];
+            if (resource.imported || resource.firstPass == u32Max)
+                continue;
+
+            resource.requirements = _device.GetTextureMemoryRequirements(resource.desc);
+            transients.push_back(i);
+            _stats.transientTextures++;
+            _stats.transientMemory += resource.requirements.size;
+        }
+
+        // Placing the largest textures first leaves the smaller ones to fill the gaps
+        std::ranges::sort(transients, [&](const u32 a, const u32 b) {
+            return _resources[a].requirements.size > _resources[b].requirements.size;
+        });
+
+        u64 heapSize = 0;
+        u64 heapAlignment = 1;
+        u32 memoryTypeBits = u32Max;
+        std::vector<u32> placed;
+        for (const auto index : transients) {
+            auto& resource = _resources[index];
+            const auto& requirements = resource.requirements;
+
+            // Textures that can't live in the same memory type as the rest get their own memory
+            if ((memoryTypeBits & requirements.memoryTypeBits) == 0) {
+                _stats.unaliasedMemory += requirements.size;
+                continue;
+            }
+
+            std::vector<std::pair<u64, u64>> occupied;
+            for (const auto other : placed) {
+                const auto& otherResource = _resources[other];
+                if (otherResource.firstPass <= resource.lastPass && resource.firstPass <= otherResource.lastPass) {
+                    occupied.emplace_back(
+                        otherResource.heapOffset, otherResource.heapOffset + otherResource.requirements.size
+                    );
+                }
+            }
+            std::ranges::sort(occupied);
+
+            u64 offset = 0;
+            for (const auto& [begin, end] : occupied) {
+                if (AlignUp(offset, requirements.alignment) + requirements.size <= begin)
+                    break;
+                offset = std::max(offset, end);
+            }
+            offset = AlignUp(offset, requirements.alignment);
+
+            resource.heapOffset = offset;
+            resource.inHeap = true;
+            memoryTypeBits &= requirements.memoryTypeBits;
+            heapAlignment = std::max(heapAlignment, requirements.alignment);
+            heapSize = std::max(heapSize, offset + requirements.size);
+            placed.push_back(index);
+        }
+        _stats.aliasedMemory += heapSize;
+
+        if (heapSize == 0)
+            return;
+
+        auto& slot = _slots[_slot];
+        const bool heapFits = slot.heap.IsValid() && slot.heapSize >= heapSize &&
+                              slot.heapMemoryTypeBits == memoryTypeBits;
+        if (!heapFits) {
+            // Textures of an earlier frame on this slot may still be placed in the old heap
+            if (slot.heap.IsValid()) {
+                slot.retiredHeaps.push_back(slot.heap);
+            }
+            slot.heap = _device.CreateMemoryHeap(
+                {.size = heapSize, .alignment = heapAlignment, .memoryTypeBits = memoryTypeBits}
+            );
+            slot.heapSize = heapSize;
+            slot.heapMemoryTypeBits = memoryTypeBits;
+        }
+    }
+
+    void RenderGraph::CreateTransients()
+    {
+        auto& heap = _slots[_slot].heap;
+        for (auto& resource : _resources) {
+            if (resource.imported || resource.firstPass == u32Max)
+                continue;
+
+            resource.texture = resource.inHeap ? _device.CreateAliasedTexture(resource.desc, heap, resource.heapOffset)
+                                               : _device.CreateTexture(resource.desc);
+
+            GPUTextureViewDesc viewDesc{};
+            viewDesc.texture = resource.texture;
+            viewDesc.type = InferTextureViewType(resource.desc.dimension);
+            viewDesc.format = resource.desc.format;
+            viewDesc.aspect = InferTextureAspect(resource.desc);
+            viewDesc.levels = resource.desc.levels;
+            viewDesc.layers = resource.desc.layers;
+            resource.view = _device.CreateTextureView(viewDesc);
+        }
+    }
+
+    void RenderGraph::RetireTransients()
+    {
+        auto& slot = _slots[_slot];
+        for (auto& resource : _resources) {
+            if (resource.imported)
+                continue;
+
+            if (resource.view.IsValid()) {
+                slot.retiredViews.push_back(resource.view);
+                resource.view.Invalidate();
+            }
+            if (resource.texture.IsValid()) {
+                slot.retiredTextures.push_back(resource.texture);
+                resource.texture.Invalidate();
+            }
+            resource.firstPass = u32Max;
+            resource.lastPass = 0;
+            resource.inHeap = false;
+        }
+    }
+
+    void RenderGraph::DestroyRetired(FrameSlot& slot)
+    {
+        for (auto& view : slot.retiredViews) {
+            _device.DestroyTextureView(view);
+        }
+        for (auto& texture : slot.retiredTextures) {
+            _device.DestroyTexture(texture);
+        }
+        for (auto& heap : slot.retiredHeaps) {
+            _device.DestroyMemoryHeap(heap);
+        }
+        slot.retiredViews.clear();
+        slot.retiredTextures.clear();
+        slot.retiredHeaps.clear();
+    }
+} // namespace Cocoa::Graphics
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "render_device.h"
+
+namespace Cocoa::Graphics {
+    using RenderGraphResource = u32;
+    constexpr RenderGraphResource InvalidRenderGraphResource = u32Max;
+
+    class RenderGraph;
+
+    struct RenderGraphStats
+    {
+        u32 passes = 0;
+        u32 culledPasses = 0;
+        u32 transientTextures = 0;
+        /// @brief Memory the transient textures would need without aliasing
+        u64 transientMemory = 0;
+        /// @brief Size of the heap the aliased transient textures share
+        u64 aliasedMemory = 0;
+        /// @brief Memory of transient textures whose memory type doesn't fit the heap, they get their own allocation
+        u64 unaliasedMemory = 0;
+    };
+
+    /// @brief Declares what a single pass reads and writes, handed to the setup function of AddPass
+    class RenderGraphBuilder
+    {
+      public:
+        /// @brief Creates a texture that only lives for the frame, its memory may be shared with other transients
+        RenderGraphResource CreateTexture(const std::string& name, const GPUTextureDesc& desc);
+
+        RenderGraphResource Read(RenderGraphResource resource, GPUTextureState state = GPUTextureState::ShaderReadOnly);
+
+        RenderGraphResource
+        Write(RenderGraphResource resource, GPUTextureState state = GPUTextureState::ColorAttachment);
+
+        /// @brief Keeps the pass alive even if nothing reads what it writes
+        void SideEffect();
+
+      private:
+        friend class RenderGraph;
+
+        RenderGraphBuilder(RenderGraph& graph, u32 pass) : _graph(graph), _pass(pass) {}
+
+        RenderGraph& _graph;
+        u32 _pass;
+    };
+
+    using RenderGraphSetupFun = std::function<void(RenderGraphBuilder& builder)>;
+    using RenderGraphExecuteFun = std::function<void(RenderGraph& graph, RenderEncoder* encoder)>;
+
+    /// @brief Records a frame as a list of passes and works out culling, state transitions and transient memory
+    /// @note Transient textures and their memory are kept per frame in flight and only destroyed once the device has
+    /// waited for that frame again, the graph itself must be destroyed after the device went idle
+    class RenderGraph
+    {
+      public:
+        explicit RenderGraph(RenderDevice& device);
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+
+        /// @brief Brings an existing texture into the graph
+        /// @param finalState The state the texture is left in after the graph runs, Unknown leaves it as is
+        /// @note Passes writing to imported textures are never culled
+        RenderGraphResource ImportTexture(
+            const std::string& name, GPUTextureHandle texture, GPUTextureViewHandle view,
+            GPUTextureState finalState = GPUTextureState::Unknown
+        );
+
+        void AddPass(const std::string& name, const RenderGraphSetupFun& setup, RenderGraphExecuteFun execute);
+
+        /// @brief Culls unused passes and places transient textures into shared memory
+        void Compile();
+
+        /// @brief Records every live pass into the encoder, transitioning resources between passes
+        /// @note The encoder has to come from the device's Encode, which waits for the frame the graph is on
+        void Execute(RenderEncoder* encoder);
+
+        /// @brief Clears all passes and transient textures so the next frame can be declared
+        /// @note Call once per encoded frame. Each frame in flight keeps its own memory heap, reused while it is large
+        /// enough, and the transients of a frame live on until the device comes back around to it
+        void Reset();
+
+        [[nodiscard]] GPUTextureHandle& GetTexture(RenderGraphResource resource);
+        [[nodiscard]] GPUTextureViewHandle& GetTextureView(RenderGraphResource resource);
+        [[nodiscard]] const RenderGraphStats& GetStats() const { return _stats; }
+
+      private:
+        friend class RenderGraphBuilder;
+
+        struct ResourceUsage
+        {
+            RenderGraphResource resource;
+            GPUTextureState state;
+            /// @brief Every write makes a new version of the resource, reads see the latest one declared before them
+            u32 version;
+        };
+
+        struct Pass
+        {
+            std::string name;
+            RenderGraphExecuteFun execute;
+            std::vector<ResourceUsage> reads;
+            std::vector<ResourceUsage> writes;
+            bool sideEffect = false;
+            bool culled = false;
+        };
+
+        struct Resource
+        {
+            std::string name;
+            GPUTextureDesc desc;
+            GPUTextureHandle texture;
+            GPUTextureViewHandle view;
+            GPUTextureState finalState = GPUTextureState::Unknown;
+            bool imported = false;
+            /// @brief Number of writes declared so far
+            u32 version = 0;
+
+            // Filled in by Compile for transient textures
+            u32 firstPass = u32Max;
+            u32 lastPass = 0;
+            GPUMemoryRequirements requirements;
+            u64 heapOffset = 0;
+            bool inHeap = false;
+        };
+
+        struct FrameSlot
+        {
+            GPUMemoryHeapHandle heap = GPUMemoryHeapHandle(u64Max);
+            u64 heapSize = 0;
+            u32 heapMemoryTypeBits = 0;
+
+            // Released while the GPU may still use them, destroyed the next time this frame is executed
+            std::vector<GPUTextureHandle> retiredTextures;
+            std::vector<GPUTextureViewHandle> retiredViews;
+            std::vector<GPUMemoryHeapHandle> retiredHeaps;
+        };
+
+        RenderDevice& _device;
+        std::vector<Pass> _passes;
+        std::vector<Resource> _resources;
+        std::vector<FrameSlot> _slots;
+        u32 _slot = 0;
+        /// @brief Set by Reset, the first Execute of a frame is where its slot's retired resources are known unused
+        bool _retiredPending = false;
+        bool _compiled = false;
+        RenderGraphStats _stats;
+
+        void CullPasses();
+        void ComputeLifetimes();
+        void PlaceTransients();
+        void CreateTransients();
+        /// @brief Hands the transients to the current frame slot, to be destroyed once the GPU is done with them
+        void RetireTransients();
+        void DestroyRetired(FrameSlot& slot);
+    };
+} // namespace Cocoa::Graphics
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+
+#include "resource_manager.h"
+
+namespace Cocoa::Graphics {
+    /// @brief Maps resource descriptions to the handle created for them so identical descriptions share a resource
+    /// @note Every Acquire/Insert adds a reference, the resource should only be destroyed once Release returns true.
+    /// Not thread-safe, it's only meant to be used from the thread creating and destroying device resources
+    template <typename Desc, typename Hash = std::hash<Desc>> class ResourceCache
+    {
+      public:
+        [[nodiscard]] std::optional<Handle> Acquire(const Desc& desc)
+        {
+            const auto entry = _entries.find(desc);
+            if (entry == _entries.end())
+                return std::nullopt;
+
+            entry->second.references++;
+            return entry->second.handle;
+        }
+
+        void Insert(const Desc& desc, const Handle handle)
+        {
+            const auto [entry, inserted] = _entries.emplace(desc, Entry{.handle = handle, .references = 1});
+            if (inserted) {
+                _owners[handle.id] = &entry->first;
+            }
+        }
+
+        /// @returns True when no one references the resource anymore (or it was never cached)
+        bool Release(const Handle& handle)
+        {
+            const auto owner = _owners.find(handle.id);
+            if (owner == _owners.end())
+                return true;
+
+            const auto entry = _entries.find(*owner->second);
+            if (--entry->second.references > 0)
+                return false;
+
+            _entries.erase(entry);
+            _owners.erase(owner);
+            return true;
+        }
+
+        [[nodiscard]] usize Size() const { return _entries.size(); }
+
+      private:
+        struct Entry
+        {
+            Handle handle;
+            u32 references;
+        };
+
+        std::unordered_map<Desc, Entry, Hash> _entries;
+        // Keys of an unordered_map keep their address across rehashes, so they can be pointed at
+        std::unordered_map<u64, const Desc*> _owners;
+    };
+} // namespace Cocoa::Graphics
@@ -15,6 +15,8 @@ namespace Cocoa::Graphics {
 
         [[nodiscard]] bool IsValid() const { return id != u64Max; }
         void Invalidate() { id = u64Max; }
+
+        bool operator==(const Handle&) const = default;
     };
 
     template <typename T> struct ResourceSlot
@@ -73,6 +75,7 @@ namespace Cocoa::Graphics {
 
             auto newGen = GetHandleGeneration(slot.id) + 1;
             slot.id = CreateHandleID(newGen, GetHandleIndex(slot.id));
+            _freedList.push_back(GetHandleIndex(slot.id));
             handle.Invalidate();
         }
 
@@ -0,0 +1,163 @@
+#include "shader_manifest.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+#include "../../macros.h"
+
+namespace Cocoa::Graphics {
+    namespace {
+        // A header line, then one line per permutation: hash, source, output and defines, separated by tabs
+        constexpr std::string_view ManifestHeader = "# Cocoa shader manifest 1";
+
+        std::vector<std::string_view> SplitFields(const std::string_view line)
+        {
+            std::vector<std::string_view> fields;
+            usize start = 0;
+            for (usize tab; (tab = line.find('\t', start)) != std::string_view::npos; start = tab + 1) {
+                fields.push_back(line.substr(start, tab - start));
+            }
+            fields.push_back(line.substr(start));
+            return fields;
+        }
+
+        /// @brief Points every permutation at where its output actually is, next to the manifest
+        void ResolvePaths(ShaderManifest& manifest, const std::string& directory)
+        {
+            if (directory.empty())
+                return;
+            for (auto& permutation : manifest.permutations) {
+                permutation.path = directory + "/" + permutation.path;
+            }
+        }
+    } // namespace
+
+    const ShaderPermutation*
+    ShaderManifest::Find(const std::string_view source, const std::vector<std::string>& defines) const
+    {
+        std::vector<std::string> sorted = defines;
+        std::ranges::sort(sorted);
+        sorted.erase(std::ranges::unique(sorted).begin(), sorted.end());
+
+        const auto permutation = std::ranges::find_if(permutations, [&](const ShaderPermutation& candidate) {
+            return candidate.source == source && candidate.defines == sorted;
+        });
+        return permutation == permutations.end() ? nullptr : &*permutation;
+    }
+
+    std::vector<std::string> ParseShaderDefines(const std::string_view defines)
+    {
+        std::vector<std::string> parsed;
+        std::istringstream stream{std::string(defines)};
+        for (std::string define; stream >> define;) {
+            parsed.push_back(std::move(define));
+        }
+        // Sorted so the same set always looks the same, whatever order it was written in
+        std::ranges::sort(parsed);
+        parsed.erase(std::ranges::unique(parsed).begin(), parsed.end());
+        return parsed;
+    }
+
+    std::optional<ShaderManifest> ParseShaderManifest(const std::string_view text)
+    {
+        ShaderManifest manifest;
+        bool headerFound = false;
+        usize start = 0;
+        while (start < text.size()) {
+            auto end = text.find('\n', start);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+            auto line = text.substr(start, end - start);
+            start = end + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+
+            if (!headerFound) {
+                if (line != ManifestHeader)
+                    return std::nullopt;
+                headerFound = true;
+                continue;
+            }
+            if (line.empty())
+                continue;
+
+            const auto fields = SplitFields(line);
+            if (fields.size() != 4)
+                return std::nullopt;
+
+            ShaderPermutation permutation;
+            const auto hashEnd = fields[0].data() + fields[0].size();
+            const auto [parsed, error] = std::from_chars(fields[0].data(), hashEnd, permutation.hash, 16);
+            if (error != std::errc() || parsed != hashEnd)
+                return std::nullopt;
+            permutation.source = fields[1];
+            permutation.path = fields[2];
+            permutation.defines = ParseShaderDefines(fields[3]);
+            manifest.permutations.push_back(std::move(permutation));
+        }
+        if (!headerFound)
+            return std::nullopt;
+        return manifest;
+    }
+
+    std::optional<ShaderManifest> LoadShaderManifest(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            PUSH_WARN("Failed to open shader manifest %s", path.string().c_str());
+            return std::nullopt;
+        }
+        std::ostringstream text;
+        text << file.rdbuf();
+
+        auto manifest = ParseShaderManifest(text.str());
+        if (!manifest) {
+            PUSH_WARN("Failed to parse shader manifest %s", path.string().c_str());
+            return std::nullopt;
+        }
+        ResolvePaths(*manifest, path.parent_path().generic_string());
+        return manifest;
+    }
+
+    std::optional<ShaderManifest> LoadShaderManifest(const Tools::Archive& archive, const std::string_view name)
+    {
+        const auto entry = archive.Find(name);
+        std::string text(entry ? entry->originalSize : 0, '\0');
+        if (!entry || !archive.Read(*entry, 0, std::span(reinterpret_cast<u8*>(text.data()), text.size()))) {
+            PUSH_WARN("Failed to read shader manifest %.*s", static_cast<int>(name.size()), name.data());
+            return std::nullopt;
+        }
+
+        auto manifest = ParseShaderManifest(text);
+        if (!manifest) {
+            PUSH_WARN("Failed to parse shader manifest %.*s", static_cast<int>(name.size()), name.data());
+            return std::nullopt;
+        }
+        const auto separator = name.rfind('/');
+        ResolvePaths(*manifest, std::string(separator == std::string_view::npos ? "" : name.substr(0, separator)));
+        return manifest;
+    }
+
+    bool WriteShaderManifest(const std::filesystem::path& path, const ShaderManifest& manifest)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        file << ManifestHeader << '\n';
+        for (const auto& [source, output, defines, hash] : manifest.permutations) {
+            char hashText[17];
+            const auto end = std::to_chars(hashText, hashText + 16, hash, 16).ptr;
+            file << std::string_view(hashText, end) << '\t' << source << '\t' << output << '\t';
+            for (usize i = 0; i < defines.size(); i++) {
+                file << (i ? " " : "") << defines[i];
+            }
+            file << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+} // namespace Cocoa::Graphics
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../tools/archive.h"
+
+namespace Cocoa::Graphics {
+    /// @brief File the shader compiler writes next to its outputs, listing every compiled permutation
+    constexpr std::string_view ShaderManifestName = "shaders.manifest";
+
+    /// @brief One shader compiled with one set of defines
+    struct ShaderPermutation
+    {
+        /// @brief Path of the GLSL source relative to the shader directory, with forward slashes
+        std::string source;
+        /// @brief Where the SPIR-V is, relative to the manifest in the file and resolved once loaded
+        std::string path;
+        /// @brief Sorted "NAME" or "NAME=VALUE" entries, as passed to the compiler
+        std::vector<std::string> defines;
+        /// @brief Hash of the source, everything it includes, the defines and the compiler, changes with the output
+        u64 hash = 0;
+    };
+
+    struct ShaderManifest
+    {
+        std::vector<ShaderPermutation> permutations;
+
+        /// @param defines In any order, duplicates are ignored
+        /// @return nullptr when that permutation of the shader wasn't compiled
+        [[nodiscard]] const ShaderPermutation*
+        Find(std::string_view source, const std::vector<std::string>& defines = {}) const;
+    };
+
+    /// @brief Splits a whitespace separated define list and puts it in the order manifests store it in
+    std::vector<std::string> ParseShaderDefines(std::string_view defines);
+
+    /// @brief Reads a manifest, paths are left relative to it
+    /// @return Nothing when the text isn't a manifest
+    std::optional<ShaderManifest> ParseShaderManifest(std::string_view text);
+
+    /// @brief Loads a manifest written by the shader compiler, paths resolve to files next to it
+    std::optional<ShaderManifest> LoadShaderManifest(const std::filesystem::path& path);
+
+    /// @brief Loads a manifest packed into an archive, paths resolve to archive names usable with Find or Map
+    std::optional<ShaderManifest> LoadShaderManifest(const Tools::Archive& archive, std::string_view name);
+
+    bool WriteShaderManifest(const std::filesystem::path& path, const ShaderManifest& manifest);
+} // namespace Cocoa::Graphics
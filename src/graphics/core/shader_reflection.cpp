@@ -0,0 +1,665 @@
+#include "shader_reflection.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+
+#include "../../macros.h"
+
+namespace Cocoa::Graphics {
+    namespace {
+        constexpr u32 SpirvMagic = 0x07230203;
+
+        // The few parts of the SPIR-V spec the declarations are read from
+        namespace Spirv {
+            constexpr u32 OpEntryPoint = 15;
+            constexpr u32 OpTypeInt = 21;
+            constexpr u32 OpTypeFloat = 22;
+            constexpr u32 OpTypeVector = 23;
+            constexpr u32 OpTypeMatrix = 24;
+            constexpr u32 OpTypeImage = 25;
+            constexpr u32 OpTypeSampler = 26;
+            constexpr u32 OpTypeSampledImage = 27;
+            constexpr u32 OpTypeArray = 28;
+            constexpr u32 OpTypeRuntimeArray = 29;
+            constexpr u32 OpTypeStruct = 30;
+            constexpr u32 OpTypePointer = 32;
+            constexpr u32 OpConstant = 43;
+            constexpr u32 OpVariable = 59;
+            constexpr u32 OpDecorate = 71;
+            constexpr u32 OpMemberDecorate = 72;
+
+            constexpr u32 DecorationBlock = 2;
+            constexpr u32 DecorationBufferBlock = 3;
+            constexpr u32 DecorationArrayStride = 6;
+            constexpr u32 DecorationMatrixStride = 7;
+            constexpr u32 DecorationBuiltIn = 11;
+            constexpr u32 DecorationLocation = 30;
+            constexpr u32 DecorationBinding = 33;
+            constexpr u32 DecorationDescriptorSet = 34;
+            constexpr u32 DecorationOffset = 35;
+
+            constexpr u32 StorageUniformConstant = 0;
+            constexpr u32 StorageInput = 1;
+            constexpr u32 StorageUniform = 2;
+            constexpr u32 StoragePushConstant = 9;
+            constexpr u32 StorageStorageBuffer = 12;
+
+            constexpr u32 ExecutionModelVertex = 0;
+            constexpr u32 ExecutionModelFragment = 4;
+
+            constexpr u32 DimBuffer = 5;
+            constexpr u32 ImageStorage = 2;
+        } // namespace Spirv
+
+        struct SpirvType
+        {
+            u32 op = 0;
+            /// @brief Operands following the result id
+            std::vector<u32> operands;
+        };
+
+        struct SpirvDecorations
+        {
+            std::optional<u32> set;
+            std::optional<u32> binding;
+            std::optional<u32> location;
+            std::optional<u32> arrayStride;
+            bool block = false;
+            bool bufferBlock = false;
+            bool builtIn = false;
+        };
+
+        struct SpirvVariable
+        {
+            u32 id;
+            u32 pointerType;
+            u32 storage;
+        };
+
+        struct SpirvModule
+        {
+            GPUShaderStage stage = GPUShaderStage::Unknown;
+            std::unordered_map<u32, SpirvType> types;
+            std::unordered_map<u32, u32> constants;
+            std::unordered_map<u32, SpirvDecorations> decorations;
+            /// @brief Keyed by struct id << 32 | member index
+            std::unordered_map<u64, u32> memberOffsets;
+            std::unordered_map<u64, u32> matrixStrides;
+            std::vector<SpirvVariable> variables;
+
+            [[nodiscard]] const SpirvType* GetType(const u32 id) const
+            {
+                const auto type = types.find(id);
+                return type == types.end() ? nullptr : &type->second;
+            }
+
+            [[nodiscard]] SpirvDecorations GetDecorations(const u32 id) const
+            {
+                const auto found = decorations.find(id);
+                return found == decorations.end() ? SpirvDecorations{} : found->second;
+            }
+        };
+
+        /// @brief Result id included, so the operands read from each type below are always there
+        u32 MinTypeOperands(const u32 opcode)
+        {
+            switch (opcode) {
+            case Spirv::OpTypeInt:
+            case Spirv::OpTypeFloat:
+            case Spirv::OpTypeRuntimeArray: return 2;
+            case Spirv::OpTypeVector:
+            case Spirv::OpTypeMatrix:
+            case Spirv::OpTypeArray:
+            case Spirv::OpTypePointer:      return 3;
+            case Spirv::OpTypeImage:        return 8;
+            default:                        return 1;
+            }
+        }
+
+        u64 MemberKey(const u32 structId, const u32 member) { return static_cast<u64>(structId) << 32 | member; }
+
+        std::optional<SpirvModule> ParseModule(const std::span<const u32> words)
+        {
+            if (words.size() < 5 || words[0] != SpirvMagic)
+                return std::nullopt;
+
+            SpirvModule module;
+            for (usize i = 5; i < words.size();) {
+                const u32 opcode = words[i] & 0xFFFF;
+                const u32 count = words[i] >> 16;
+                if (count == 0 || i + count > words.size())
+                    return std::nullopt;
+                const auto operands = words.subspan(i + 1, count - 1);
+                i += count;
+
+                switch (opcode) {
+                case Spirv::OpEntryPoint:
+                    // Modules compiled from GLSL have exactly one entry point
+                    if (module.stage == GPUShaderStage::Unknown && !operands.empty()) {
+                        if (operands[0] == Spirv::ExecutionModelVertex) {
+                            module.stage = GPUShaderStage::Vertex;
+                        } else if (operands[0] == Spirv::ExecutionModelFragment) {
+                            module.stage = GPUShaderStage::Pixel;
+                        }
+                    }
+                    break;
+                case Spirv::OpTypeInt:
+                case Spirv::OpTypeFloat:
+                case Spirv::OpTypeVector:
+                case Spirv::OpTypeMatrix:
+                case Spirv::OpTypeImage:
+                case Spirv::OpTypeSampler:
+                case Spirv::OpTypeSampledImage:
+                case Spirv::OpTypeArray:
+                case Spirv::OpTypeRuntimeArray:
+                case Spirv::OpTypeStruct:
+                case Spirv::OpTypePointer:
+                    // Types with fewer operands than their opcode needs are malformed, looking them up fails later
+                    if (operands.size() >= MinTypeOperands(opcode)) {
+                        module.types[operands[0]] = {
+                            .op = opcode,
+                            .operands = {operands.begin() + 1, operands.end()},
+                        };
+                    }
+                    break;
+                case Spirv::OpConstant:
+                    // Only array lengths are needed, which are 32-bit
+                    if (operands.size() >= 3) {
+                        module.constants[operands[1]] = operands[2];
+                    }
+                    break;
+                case Spirv::OpVariable:
+                    if (operands.size() >= 3) {
+                        module.variables.push_back({
+                            .id = operands[1],
+                            .pointerType = operands[0],
+                            .storage = operands[2],
+                        });
+                    }
+                    break;
+                case Spirv::OpDecorate: {
+                    if (operands.size() < 2)
+                        break;
+                    auto& decorations = module.decorations[operands[0]];
+                    const std::optional<u32> value = operands.size() >= 3 ? std::optional(operands[2]) : std::nullopt;
+                    switch (operands[1]) {
+                    case Spirv::DecorationBlock:         decorations.block = true; break;
+                    case Spirv::DecorationBufferBlock:   decorations.bufferBlock = true; break;
+                    case Spirv::DecorationBuiltIn:       decorations.builtIn = true; break;
+                    case Spirv::DecorationArrayStride:   decorations.arrayStride = value; break;
+                    case Spirv::DecorationLocation:      decorations.location = value; break;
+                    case Spirv::DecorationBinding:       decorations.binding = value; break;
+                    case Spirv::DecorationDescriptorSet: decorations.set = value; break;
+                    default:                             break;
+                    }
+                    break;
+                }
+                case Spirv::OpMemberDecorate:
+                    if (operands.size() < 4)
+                        break;
+                    if (operands[2] == Spirv::DecorationOffset) {
+                        module.memberOffsets[MemberKey(operands[0], operands[1])] = operands[3];
+                    } else if (operands[2] == Spirv::DecorationMatrixStride) {
+                        module.matrixStrides[MemberKey(operands[0], operands[1])] = operands[3];
+                    }
+                    break;
+                default: break;
+                }
+            }
+            return module;
+        }
+
+        /// @brief Bytes a type takes up in a block, following the offsets and strides the compiler decorated it with
+        std::optional<u32> GetTypeSize(const SpirvModule& module, const u32 typeId, const u32 matrixStride = 0)
+        {
+            const auto type = module.GetType(typeId);
+            if (!type)
+                return std::nullopt;
+
+            const auto& operands = type->operands;
+            switch (type->op) {
+            case Spirv::OpTypeInt:
+            case Spirv::OpTypeFloat: return operands[0] / 8;
+            case Spirv::OpTypeVector: {
+                const auto component = GetTypeSize(module, operands[0]);
+                return component ? std::optional(*component * operands[1]) : std::nullopt;
+            }
+            case Spirv::OpTypeMatrix: {
+                const auto column = GetTypeSize(module, operands[0]);
+                if (!column)
+                    return std::nullopt;
+                return (matrixStride ? matrixStride : *column) * operands[1];
+            }
+            case Spirv::OpTypeArray: {
+                const auto length = module.constants.find(operands[1]);
+                const auto element = GetTypeSize(module, operands[0], matrixStride);
+                if (length == module.constants.end() || !element)
+                    return std::nullopt;
+                return module.GetDecorations(typeId).arrayStride.value_or(*element) * length->second;
+            }
+            case Spirv::OpTypeStruct: {
+                u32 size = 0;
+                for (u32 member = 0; member < operands.size(); member++) {
+                    const auto offset = module.memberOffsets.find(MemberKey(typeId, member));
+                    const auto stride = module.matrixStrides.find(MemberKey(typeId, member));
+                    const auto memberSize = GetTypeSize(
+                        module, operands[member], stride == module.matrixStrides.end() ? 0 : stride->second
+                    );
+                    if (offset == module.memberOffsets.end() || !memberSize)
+                        return std::nullopt;
+                    size = std::max(size, offset->second + *memberSize);
+                }
+                return size;
+            }
+            default: return std::nullopt;
+            }
+        }
+
+        /// @brief Where the first member of a block starts, push constant blocks may skip ranges used by other stages
+        u32 GetFirstMemberOffset(const SpirvModule& module, const u32 structId)
+        {
+            u32 first = u32Max;
+            for (const auto& [key, offset] : module.memberOffsets) {
+                if (key >> 32 == structId) {
+                    first = std::min(first, offset);
+                }
+            }
+            return first == u32Max ? 0 : first;
+        }
+
+        std::optional<GPUBindGroupType> GetBindGroupType(const SpirvModule& module, const u32 typeId, const u32 storage)
+        {
+            const auto type = module.GetType(typeId);
+            if (!type)
+                return std::nullopt;
+
+            switch (type->op) {
+            case Spirv::OpTypeImage:
+                // Texel buffers and storage images have no bind group type yet
+                if (type->operands[1] == Spirv::DimBuffer || type->operands[5] == Spirv::ImageStorage)
+                    return std::nullopt;
+                return GPUBindGroupType::Texture;
+            case Spirv::OpTypeSampler: return GPUBindGroupType::Sampler;
+            case Spirv::OpTypeStruct:  break;
+            default:                   return std::nullopt;
+            }
+
+            // Older SPIR-V marks storage buffers as BufferBlock structs in the Uniform storage class
+            const auto decorations = module.GetDecorations(typeId);
+            if (storage == Spirv::StorageStorageBuffer || (storage == Spirv::StorageUniform && decorations.bufferBlock))
+                return GPUBindGroupType::StorageBuffer;
+            if (storage == Spirv::StorageUniform && decorations.block)
+                return GPUBindGroupType::UniformBuffer;
+            return std::nullopt;
+        }
+
+        std::optional<GPUColorFormat> GetVertexInputFormat(const SpirvModule& module, const u32 typeId)
+        {
+            const auto type = module.GetType(typeId);
+            if (!type)
+                return std::nullopt;
+
+            u32 components = 1;
+            const SpirvType* component = type;
+            if (type->op == Spirv::OpTypeVector) {
+                components = type->operands[1];
+                component = module.GetType(type->operands[0]);
+            }
+            if (!component || component->op != Spirv::OpTypeFloat || component->operands[0] != 32)
+                return std::nullopt;
+
+            constexpr std::array Formats = {
+                GPUColorFormat::R32_Float,
+                GPUColorFormat::RG32_Float,
+                GPUColorFormat::RGB32_Float,
+                GPUColorFormat::RGBA32_Float,
+            };
+            return components <= Formats.size() ? std::optional(Formats[components - 1]) : std::nullopt;
+        }
+
+        // Cached reflections are the header followed by the bindings, push constant ranges and vertex inputs
+        constexpr u32 ReflectionCacheMagic = 0x4C465243; // "CRFL"
+        constexpr u32 ReflectionCacheVersion = 1;
+
+        struct ReflectionCacheHeader
+        {
+            u32 magic = ReflectionCacheMagic;
+            u32 version = ReflectionCacheVersion;
+            u64 codeHash = 0;
+            GPUShaderStage stage = GPUShaderStage::Unknown;
+            u32 bindingCount = 0;
+            u32 pushConstantCount = 0;
+            u32 vertexInputCount = 0;
+        };
+
+        static_assert(
+            std::is_trivially_copyable_v<ReflectedBinding> && std::is_trivially_copyable_v<ReflectedVertexInput>
+        );
+
+        u64 HashCode(const std::span<const u8> code)
+        {
+            return Tools::HashArchiveName({reinterpret_cast<const char*>(code.data()), code.size()});
+        }
+
+        std::vector<u8> SerializeReflection(const ShaderReflection& reflection, const u64 codeHash)
+        {
+            const ReflectionCacheHeader header{
+                .codeHash = codeHash,
+                .stage = reflection.stage,
+                .bindingCount = static_cast<u32>(reflection.bindings.size()),
+                .pushConstantCount = static_cast<u32>(reflection.pushConstants.size()),
+                .vertexInputCount = static_cast<u32>(reflection.vertexInputs.size()),
+            };
+
+            std::vector<u8> data;
+            const auto append = [&](const void* source, const usize size) {
+                const auto bytes = static_cast<const u8*>(source);
+                data.insert(data.end(), bytes, bytes + size);
+            };
+            append(&header, sizeof(header));
+            append(reflection.bindings.data(), reflection.bindings.size() * sizeof(ReflectedBinding));
+            append(reflection.pushConstants.data(), reflection.pushConstants.size() * sizeof(GFXPushConstantRange));
+            append(reflection.vertexInputs.data(), reflection.vertexInputs.size() * sizeof(ReflectedVertexInput));
+            return data;
+        }
+
+        /// @return Nothing when the data is malformed or was made for different code
+        std::optional<ShaderReflection> DeserializeReflection(const std::span<const u8> data, const u64 codeHash)
+        {
+            ReflectionCacheHeader header;
+            if (data.size() < sizeof(header))
+                return std::nullopt;
+            std::memcpy(&header, data.data(), sizeof(header));
+            if (header.magic != ReflectionCacheMagic || header.version != ReflectionCacheVersion ||
+                header.codeHash != codeHash)
+                return std::nullopt;
+
+            const usize expectedSize = sizeof(header) + header.bindingCount * sizeof(ReflectedBinding) +
+                                       header.pushConstantCount * sizeof(GFXPushConstantRange) +
+                                       header.vertexInputCount * sizeof(ReflectedVertexInput);
+            if (data.size() != expectedSize)
+                return std::nullopt;
+
+            ShaderReflection reflection;
+            reflection.stage = header.stage;
+            usize offset = sizeof(header);
+            const auto read = [&]<typename T>(std::vector<T>& values, const u32 count) {
+                values.resize(count);
+                std::memcpy(values.data(), data.data() + offset, count * sizeof(T));
+                offset += count * sizeof(T);
+            };
+            read(reflection.bindings, header.bindingCount);
+            read(reflection.pushConstants, header.pushConstantCount);
+            read(reflection.vertexInputs, header.vertexInputCount);
+            return reflection;
+        }
+
+        /// @brief Reflects code, using cached when it was made for the same code
+        std::optional<ShaderReflection> ReflectCached(
+            const std::span<const u8> code, const std::span<const u8> cached, [[maybe_unused]] const std::string& name,
+            std::vector<u8>* updatedCache
+        )
+        {
+            const u64 codeHash = HashCode(code);
+            if (auto reflection = DeserializeReflection(cached, codeHash))
+                return reflection;
+
+            auto reflection = ReflectShader(code);
+            if (!reflection) {
+                PUSH_WARN("Failed to reflect shader %s", name.c_str());
+                return std::nullopt;
+            }
+            if (updatedCache) {
+                *updatedCache = SerializeReflection(*reflection, codeHash);
+            }
+            return reflection;
+        }
+
+        std::vector<u8> ReadWholeFile(const std::filesystem::path& path)
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+                return {};
+            std::vector<u8> data(static_cast<usize>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            return file ? data : std::vector<u8>{};
+        }
+    } // namespace
+
+    std::optional<ShaderReflection> ReflectShader(const std::span<const u8> code)
+    {
+        if (code.size() % sizeof(u32) != 0)
+            return std::nullopt;
+
+        // The code may come straight from an archive or a file buffer, which aren't necessarily aligned for u32
+        std::vector<u32> words(code.size() / sizeof(u32));
+        std::memcpy(words.data(), code.data(), code.size());
+        const auto module = ParseModule(words);
+        if (!module || module->stage == GPUShaderStage::Unknown)
+            return std::nullopt;
+
+        ShaderReflection reflection;
+        reflection.stage = module->stage;
+        for (const auto& [id, pointerType, storage] : module->variables) {
+            const auto pointer = module->GetType(pointerType);
+            if (!pointer || pointer->op != Spirv::OpTypePointer)
+                return std::nullopt;
+            u32 typeId = pointer->operands[1];
+            const auto decorations = module->GetDecorations(id);
+
+            switch (storage) {
+            case Spirv::StorageUniformConstant:
+            case Spirv::StorageUniform:
+            case Spirv::StorageStorageBuffer: {
+                if (!decorations.set || !decorations.binding)
+                    return std::nullopt;
+
+                u32 count = 1;
+                if (const auto type = module->GetType(typeId); type && type->op == Spirv::OpTypeArray) {
+                    const auto length = module->constants.find(type->operands[1]);
+                    count = length == module->constants.end() ? 1 : length->second;
+                    typeId = type->operands[0];
+                } else if (type && type->op == Spirv::OpTypeRuntimeArray) {
+                    count = 0;
+                    typeId = type->operands[0];
+                }
+
+                // Bind groups hold textures and samplers separately, so combined image samplers, storage images and
+                // texel buffers are skipped and whoever builds the layout has to add them by hand
+                const auto type = GetBindGroupType(*module, typeId, storage);
+                if (!type) {
+                    PUSH_WARN(
+                        "Set %u binding %u has a type bind groups can't hold, it's left out of the reflection",
+                        *decorations.set, *decorations.binding
+                    );
+                    break;
+                }
+                reflection.bindings.push_back({
+                    .set = *decorations.set,
+                    .binding = *decorations.binding,
+                    .type = *type,
+                    .visibility = module->stage,
+                    .count = count,
+                });
+                break;
+            }
+            case Spirv::StoragePushConstant: {
+                const auto size = GetTypeSize(*module, typeId);
+                if (!size)
+                    return std::nullopt;
+                const u32 offset = GetFirstMemberOffset(*module, typeId);
+                reflection.pushConstants.push_back({
+                    .visibility = module->stage,
+                    .offset = offset,
+                    .size = *size - offset,
+                });
+                break;
+            }
+            case Spirv::StorageInput: {
+                // Built-ins like gl_VertexIndex aren't fed from vertex buffers
+                if (module->stage != GPUShaderStage::Vertex || decorations.builtIn || !decorations.location)
+                    break;
+                // Only 32-bit float inputs have a format yet, integer inputs are skipped like unsupported bindings
+                const auto format = GetVertexInputFormat(*module, typeId);
+                if (!format) {
+                    PUSH_WARN(
+                        "Vertex input at location %u isn't made of 32-bit floats, it's left out of the reflection",
+                        *decorations.location
+                    );
+                    break;
+                }
+                reflection.vertexInputs.push_back({.location = *decorations.location, .format = *format});
+                break;
+            }
+            default: break;
+            }
+        }
+
+        std::ranges::sort(reflection.bindings, [](const ReflectedBinding& a, const ReflectedBinding& b) {
+            return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+        });
+        std::ranges::sort(reflection.vertexInputs, {}, &ReflectedVertexInput::location);
+        return reflection;
+    }
+
+    std::optional<ShaderReflection> LoadShaderReflection(const std::filesystem::path& path)
+    {
+        const auto code = ReadWholeFile(path);
+        if (code.empty()) {
+            PUSH_WARN("Failed to read shader %s", path.string().c_str());
+            return std::nullopt;
+        }
+
+        auto cachePath = path;
+        cachePath += ".refl";
+        std::vector<u8> updatedCache;
+        auto reflection = ReflectCached(code, ReadWholeFile(cachePath), path.string(), &updatedCache);
+
+        // A cache that can't be written is only slower, e.g. when the shaders are installed read-only
+        if (!updatedCache.empty()) {
+            std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+            file.write(
+                reinterpret_cast<const char*>(updatedCache.data()), static_cast<std::streamsize>(updatedCache.size())
+            );
+        }
+        return reflection;
+    }
+
+    std::optional<ShaderReflection> LoadShaderReflection(const Tools::Archive& archive, const std::string_view name)
+    {
+        const auto read = [&](const std::string_view entryName) {
+            const auto entry = archive.Find(entryName);
+            std::vector<u8> data;
+            if (entry) {
+                data.resize(entry->originalSize);
+                if (!archive.Read(*entry, 0, data)) {
+                    data.clear();
+                }
+            }
+            return data;
+        };
+
+        const auto code = read(name);
+        if (code.empty()) {
+            PUSH_WARN("Failed to read shader %.*s", static_cast<int>(name.size()), name.data());
+            return std::nullopt;
+        }
+        // Archives are read-only, a stale or missing cache only costs reflecting the shader again
+        return ReflectCached(code, read(std::string(name) + ".refl"), std::string(name), nullptr);
+    }
+
+    ShaderReflection MergeShaderReflections(const std::span<const ShaderReflection> stages)
+    {
+        ShaderReflection merged;
+        for (const auto& stage : stages) {
+            merged.stage = merged.stage | stage.stage;
+            if (stage.stage == GPUShaderStage::Vertex) {
+                merged.vertexInputs = stage.vertexInputs;
+            }
+
+            for (const auto& binding : stage.bindings) {
+                const auto existing = std::ranges::find_if(merged.bindings, [&](const ReflectedBinding& other) {
+                    return other.set == binding.set && other.binding == binding.binding;
+                });
+                if (existing == merged.bindings.end()) {
+                    merged.bindings.push_back(binding);
+                } else if (existing->type == binding.type) {
+                    existing->visibility = existing->visibility | binding.visibility;
+                } else {
+                    PUSH_WARN("Shader stages disagree on the type of set %u binding %u", binding.set, binding.binding);
+                }
+            }
+
+            // Stages sharing one push constant block get a single range visible to all of them
+            for (const auto& range : stage.pushConstants) {
+                const auto existing = std::ranges::find_if(merged.pushConstants, [&](const GFXPushConstantRange& o) {
+                    return o.offset == range.offset && o.size == range.size;
+                });
+                if (existing == merged.pushConstants.end()) {
+                    merged.pushConstants.push_back(range);
+                } else {
+                    existing->visibility = existing->visibility | range.visibility;
+                }
+            }
+        }
+
+        std::ranges::sort(merged.bindings, [](const ReflectedBinding& a, const ReflectedBinding& b) {
+            return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+        });
+        return merged;
+    }
+
+    GFXPipelineVertexBinding GetReflectedVertexBinding(const ShaderReflection& reflection, const u32 binding)
+    {
+        // Pipelines assign locations in attribute order, so a gap would shift every location after it
+        GFXPipelineVertexBinding vertexBinding{.binding = binding, .stride = 0, .attributes = {}};
+        for (u32 i = 0; i < reflection.vertexInputs.size(); i++) {
+            const auto& [location, format] = reflection.vertexInputs[i];
+            if (location != i) {
+                PANIC("Vertex inputs have to use consecutive locations starting at 0, found location %u", location);
+            }
+            vertexBinding.Attribute(format, vertexBinding.stride);
+            vertexBinding.stride += GetColorFormatBlock(format).bytes;
+        }
+        return vertexBinding;
+    }
+
+    ReflectedPipelineLayout
+    CreateReflectedPipelineLayout(RenderDevice& device, const ShaderReflection& reflection, const u32 firstSet)
+    {
+        u32 setCount = firstSet;
+        for (const auto& binding : reflection.bindings) {
+            setCount = std::max(setCount, binding.set + 1);
+        }
+
+        // Sets in between that the shaders don't use still need a layout, an empty one
+        ReflectedPipelineLayout layout;
+        GFXPipelineLayoutDesc pipelineLayoutDesc;
+        for (u32 set = firstSet; set < setCount; set++) {
+            GPUBindGroupLayoutDesc groupLayoutDesc;
+            for (const auto& binding : reflection.bindings) {
+                if (binding.set != set)
+                    continue;
+                if (binding.count != 1) {
+                    PANIC("Set %u binding %u is an array, which bind groups can't hold", set, binding.binding);
+                }
+                groupLayoutDesc.Entry(binding.visibility, binding.type, binding.binding);
+            }
+            layout.groupLayouts.push_back(device.CreateBindGroupLayout(groupLayoutDesc));
+            pipelineLayoutDesc.BindGroup(layout.groupLayouts.back());
+        }
+        for (const auto& [visibility, offset, size] : reflection.pushConstants) {
+            pipelineLayoutDesc.PushConstant(visibility, size, offset);
+        }
+
+        layout.pipelineLayout = device.CreatePipelineLayout(pipelineLayoutDesc);
+        return layout;
+    }
+} // namespace Cocoa::Graphics
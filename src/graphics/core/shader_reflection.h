@@ -0,0 +1,73 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "../../tools/archive.h"
+#include "render_device.h"
+
+namespace Cocoa::Graphics {
+    /// @brief A resource a shader declares with layout(set, binding)
+    struct ReflectedBinding
+    {
+        u32 set = 0;
+        u32 binding = 0;
+        GPUBindGroupType type = GPUBindGroupType::UniformBuffer;
+        GPUShaderStage visibility = GPUShaderStage::Unknown;
+        /// @brief Elements of an arrayed binding, 1 for plain ones and 0 for runtime sized arrays
+        u32 count = 1;
+    };
+
+    /// @brief A vertex shader input, the format is the one the shader reads, i.e. always 32-bit floats
+    struct ReflectedVertexInput
+    {
+        u32 location = 0;
+        GPUColorFormat format = GPUColorFormat::Unknown;
+    };
+
+    /// @brief What a SPIR-V module expects from the pipeline it's used in
+    struct ShaderReflection
+    {
+        GPUShaderStage stage = GPUShaderStage::Unknown;
+        /// @brief Sorted by set and binding
+        std::vector<ReflectedBinding> bindings;
+        std::vector<GFXPushConstantRange> pushConstants;
+        /// @brief Sorted by location, only filled in for vertex shaders
+        std::vector<ReflectedVertexInput> vertexInputs;
+    };
+
+    /// @brief Layouts created from a reflection, destroy them when the pipelines using them are gone
+    struct ReflectedPipelineLayout
+    {
+        GFXPipelineLayoutHandle pipelineLayout;
+        std::vector<GPUBindGroupLayoutHandle> groupLayouts;
+    };
+
+    /// @brief Parses the declarations of a SPIR-V module, the code itself isn't looked at
+    /// @note Bindings bind groups can't express, like combined image samplers, and vertex inputs that aren't 32-bit
+    /// floats are left out with a warning
+    /// @return Nothing when the module is malformed
+    std::optional<ShaderReflection> ReflectShader(std::span<const u8> code);
+
+    /// @brief Reflects a compiled shader, reusing the "<path>.refl" file next to it while the shader is unchanged
+    /// @note The cache is keyed on a hash of the code, so recompiled or hot reloaded shaders are reflected again
+    std::optional<ShaderReflection> LoadShaderReflection(const std::filesystem::path& path);
+
+    /// @brief Same as the file version for a shader packed into an archive, a packed "<name>.refl" is used if current
+    std::optional<ShaderReflection> LoadShaderReflection(const Tools::Archive& archive, std::string_view name);
+
+    /// @brief Combines the stages of a pipeline, whatever several stages use becomes visible to all of them
+    ShaderReflection MergeShaderReflections(std::span<const ShaderReflection> stages);
+
+    /// @brief The interleaved vertex layout a vertex shader reads, attributes tightly packed in location order
+    /// @note Meshes stored in other formats, like PackedVertex, still describe their own layout
+    GFXPipelineVertexBinding GetReflectedVertexBinding(const ShaderReflection& reflection, u32 binding = 0);
+
+    /// @brief Creates the bind group layouts and pipeline layout a reflection describes
+    /// @param firstSet Sets below it are left out, 1 when the device is bindless since set 0 is the bindless table
+    /// @note The device shares layouts with equal descriptions, so pipelines with matching shaders share them too
+    ReflectedPipelineLayout
+    CreateReflectedPipelineLayout(RenderDevice& device, const ShaderReflection& reflection, u32 firstSet = 0);
+} // namespace Cocoa::Graphics
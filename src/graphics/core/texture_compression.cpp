@@ -0,0 +1,420 @@
+#include "texture_compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "../../macros.h"
+#include "../utils/float4.h"
+
+namespace Cocoa::Graphics {
+    namespace {
+        constexpr u32 BlockTexels = 16;
+
+        /// @brief BC7 interpolation weights for 4-bit indices, out of 64
+        constexpr std::array<u32, 16> BC7Weights = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        /// @brief Packs fields least significant bit first, the order every BC format uses
+        struct BitWriter
+        {
+            u8* out;
+            u32 position = 0;
+
+            void Put(const u32 value, const u32 bits)
+            {
+                for (u32 i = 0; i < bits; i++, position++) {
+                    out[position >> 3] |= static_cast<u8>(((value >> i) & 1) << (position & 7));
+                }
+            }
+        };
+
+        Float4 Clamp255(const Float4& value) { return value.Max(Float4::Splat(0.0f)).Min(Float4::Splat(255.0f)); }
+
+        /// @brief Line through the texels that keeps the most of their variance, found by power iteration
+        void FitEndpoints(const Float4* texels, Float4& first, Float4& second)
+        {
+            auto mean = Float4::Splat(0.0f);
+            for (u32 i = 0; i < BlockTexels; i++) {
+                mean = mean + texels[i];
+            }
+            mean = mean * Float4::Splat(1.0f / BlockTexels);
+
+            // Start from the texel furthest from the mean, which can't be orthogonal to the spread of the block,
+            // a few iterations then settle on the principal axis
+            auto axis = Float4::Splat(0.0f);
+            for (u32 i = 0; i < BlockTexels; i++) {
+                const auto offset = texels[i] - mean;
+                if (offset.Dot(offset) > axis.Dot(axis)) {
+                    axis = offset;
+                }
+            }
+            for (u32 iteration = 0; iteration < 8; iteration++) {
+                auto next = Float4::Splat(0.0f);
+                for (u32 i = 0; i < BlockTexels; i++) {
+                    const auto offset = texels[i] - mean;
+                    next = next + offset * Float4::Splat(offset.Dot(axis));
+                }
+                const f32 length = std::sqrt(next.Dot(next));
+                if (length < 1e-6f)
+                    break;
+                axis = next * Float4::Splat(1.0f / length);
+            }
+
+            f32 minProjection = f32Max, maxProjection = -f32Max;
+            for (u32 i = 0; i < BlockTexels; i++) {
+                const f32 projection = (texels[i] - mean).Dot(axis);
+                minProjection = std::min(minProjection, projection);
+                maxProjection = std::max(maxProjection, projection);
+            }
+            first = Clamp255(mean + axis * Float4::Splat(maxProjection));
+            second = Clamp255(mean + axis * Float4::Splat(minProjection));
+        }
+
+        /// @brief Least squares endpoints for fixed indices
+        /// @param firstWeights How much of the first endpoint each index blends in
+        bool RefineEndpoints(
+            const Float4* texels, const u32* indices, const f32* firstWeights, Float4& first, Float4& second
+        )
+        {
+            f32 aa = 0, ab = 0, bb = 0;
+            auto ax = Float4::Splat(0.0f);
+            auto bx = Float4::Splat(0.0f);
+            for (u32 i = 0; i < BlockTexels; i++) {
+                const f32 a = firstWeights[indices[i]];
+                const f32 b = 1.0f - a;
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                ax = ax + texels[i] * Float4::Splat(a);
+                bx = bx + texels[i] * Float4::Splat(b);
+            }
+
+            const f32 determinant = aa * bb - ab * ab;
+            if (std::abs(determinant) < 1e-6f)
+                return false;
+            const f32 inverse = 1.0f / determinant;
+            first = Clamp255((ax * Float4::Splat(bb) - bx * Float4::Splat(ab)) * Float4::Splat(inverse));
+            second = Clamp255((bx * Float4::Splat(aa) - ax * Float4::Splat(ab)) * Float4::Splat(inverse));
+            return true;
+        }
+
+        /// @return The summed squared error of picking the closest palette entry for every texel
+        template <usize N>
+        f32 AssignIndices(const Float4* texels, const std::array<Float4, N>& palette, u32* indices)
+        {
+            f32 total = 0;
+            for (u32 i = 0; i < BlockTexels; i++) {
+                f32 best = f32Max;
+                for (u32 entry = 0; entry < N; entry++) {
+                    const auto difference = texels[i] - palette[entry];
+                    const f32 error = difference.Dot(difference);
+                    if (error < best) {
+                        best = error;
+                        indices[i] = entry;
+                    }
+                }
+                total += best;
+            }
+            return total;
+        }
+
+        u16 To565(const Float4& color)
+        {
+            const auto values = color.ToArray();
+            const auto r = static_cast<u16>(std::lround(values[0] * 31.0f / 255.0f));
+            const auto g = static_cast<u16>(std::lround(values[1] * 63.0f / 255.0f));
+            const auto b = static_cast<u16>(std::lround(values[2] * 31.0f / 255.0f));
+            return static_cast<u16>(r << 11 | g << 5 | b);
+        }
+
+        Float4 From565(const u16 color)
+        {
+            const u32 r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+            const auto expand = [](const u32 value, const u32 bits) {
+                return static_cast<f32>(value << (8 - bits) | value >> (2 * bits - 8));
+            };
+            return Float4::Set(expand(r, 5), expand(g, 6), expand(b, 5), 0.0f);
+        }
+
+        f32 AssignBC1(const Float4* texels, const u16 color0, const u16 color1, u32* indices)
+        {
+            const auto first = From565(color0);
+            const auto second = From565(color1);
+            const auto third = Float4::Splat(1.0f / 3.0f);
+            const std::array<Float4, 4> palette = {
+                first, second, (first + first + second) * third, (first + second + second) * third
+            };
+            return AssignIndices(texels, palette, indices);
+        }
+
+        /// @param texels RGB in 0-255 with the fourth lane zeroed
+        void EncodeBC1(const Float4* texels, u8* out)
+        {
+            Float4 first, second;
+            FitEndpoints(texels, first, second);
+            u16 color0 = To565(first);
+            u16 color1 = To565(second);
+            std::array<u32, BlockTexels> indices{};
+            f32 error = AssignBC1(texels, color0, color1, indices.data());
+
+            // Quantizing to 565 moves the endpoints, one least squares pass wins most of that back
+            constexpr f32 firstWeights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+            if (RefineEndpoints(texels, indices.data(), firstWeights, first, second)) {
+                const u16 refined0 = To565(first);
+                const u16 refined1 = To565(second);
+                std::array<u32, BlockTexels> refinedIndices{};
+                if (AssignBC1(texels, refined0, refined1, refinedIndices.data()) < error) {
+                    color0 = refined0;
+                    color1 = refined1;
+                    indices = refinedIndices;
+                }
+            }
+
+            // The first color has to be the larger one, otherwise the block decodes in 3 color mode
+            if (color0 < color1) {
+                std::swap(color0, color1);
+                for (auto& index : indices) {
+                    index ^= 1;
+                }
+            } else if (color0 == color1) {
+                indices.fill(0);
+            }
+
+            BitWriter writer{out};
+            writer.Put(color0, 16);
+            writer.Put(color1, 16);
+            for (const auto index : indices) {
+                writer.Put(index, 2);
+            }
+        }
+
+        /// @param values One channel in 0-255
+        void EncodeBC4(const f32* values, u8* out)
+        {
+            f32 low = 255.0f, high = 0.0f;
+            for (u32 i = 0; i < BlockTexels; i++) {
+                low = std::min(low, values[i]);
+                high = std::max(high, values[i]);
+            }
+            const auto endpoint0 = static_cast<u32>(std::lround(high));
+            const auto endpoint1 = static_cast<u32>(std::lround(low));
+
+            BitWriter writer{out};
+            writer.Put(endpoint0, 8);
+            writer.Put(endpoint1, 8);
+            for (u32 i = 0; i < BlockTexels; i++) {
+                // Index 0 and 1 are the endpoints and 2 to 7 step from the first towards the second
+                u32 index = 0;
+                if (endpoint0 > endpoint1) {
+                    const f32 t = (values[i] - static_cast<f32>(endpoint1)) / static_cast<f32>(endpoint0 - endpoint1);
+                    const auto step = static_cast<u32>(std::clamp(std::lround(t * 7.0f), 0l, 7l));
+                    index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+                }
+                writer.Put(index, 3);
+            }
+        }
+
+        /// @brief A BC7 mode 6 endpoint, 7 bits per channel plus a shared low bit
+        struct BC7Endpoint
+        {
+            std::array<u32, 4> values;
+            u32 pBit;
+
+            [[nodiscard]] std::array<u32, 4> Expand() const
+            {
+                return {values[0] << 1 | pBit, values[1] << 1 | pBit, values[2] << 1 | pBit, values[3] << 1 | pBit};
+            }
+        };
+
+        BC7Endpoint QuantizeBC7(const Float4& endpoint)
+        {
+            const auto values = endpoint.ToArray();
+            BC7Endpoint best{};
+            f32 bestError = f32Max;
+            for (u32 pBit = 0; pBit < 2; pBit++) {
+                BC7Endpoint candidate{{}, pBit};
+                f32 error = 0;
+                for (u32 channel = 0; channel < 4; channel++) {
+                    const f32 halved = (values[channel] - static_cast<f32>(pBit)) / 2.0f;
+                    const auto value = std::clamp(std::lround(halved), 0l, 127l);
+                    candidate.values[channel] = static_cast<u32>(value);
+                    const f32 difference = static_cast<f32>(value * 2 + pBit) - values[channel];
+                    error += difference * difference;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    best = candidate;
+                }
+            }
+            return best;
+        }
+
+        f32 AssignBC7(const Float4* texels, const BC7Endpoint& first, const BC7Endpoint& second, u32* indices)
+        {
+            const auto a = first.Expand();
+            const auto b = second.Expand();
+            std::array<Float4, 16> palette;
+            for (u32 entry = 0; entry < 16; entry++) {
+                f32 channels[4];
+                for (u32 channel = 0; channel < 4; channel++) {
+                    const u32 weight = BC7Weights[entry];
+                    channels[channel] = static_cast<f32>(((64 - weight) * a[channel] + weight * b[channel] + 32) >> 6);
+                }
+                palette[entry] = Float4::Load(channels);
+            }
+            return AssignIndices(texels, palette, indices);
+        }
+
+        /// @brief Mode 6 only, a single RGBA line with 4-bit indices covers most texture content well
+        void EncodeBC7(const Float4* texels, u8* out)
+        {
+            Float4 firstColor, secondColor;
+            FitEndpoints(texels, firstColor, secondColor);
+            auto first = QuantizeBC7(firstColor);
+            auto second = QuantizeBC7(secondColor);
+            std::array<u32, BlockTexels> indices{};
+            const f32 error = AssignBC7(texels, first, second, indices.data());
+
+            std::array<f32, 16> firstWeights{};
+            for (u32 entry = 0; entry < 16; entry++) {
+                firstWeights[entry] = static_cast<f32>(64 - BC7Weights[entry]) / 64.0f;
+            }
+            if (RefineEndpoints(texels, indices.data(), firstWeights.data(), firstColor, secondColor)) {
+                const auto refinedFirst = QuantizeBC7(firstColor);
+                const auto refinedSecond = QuantizeBC7(secondColor);
+                std::array<u32, BlockTexels> refinedIndices{};
+                if (AssignBC7(texels, refinedFirst, refinedSecond, refinedIndices.data()) < error) {
+                    first = refinedFirst;
+                    second = refinedSecond;
+                    indices = refinedIndices;
+                }
+            }
+
+            // The first index is stored without its top bit, so the endpoints are swapped when it would be set
+            if (indices[0] >= 8) {
+                std::swap(first, second);
+                for (auto& index : indices) {
+                    index = 15 - index;
+                }
+            }
+
+            BitWriter writer{out};
+            writer.Put(1u << 6, 7);
+            for (u32 channel = 0; channel < 4; channel++) {
+                writer.Put(first.values[channel], 7);
+                writer.Put(second.values[channel], 7);
+            }
+            writer.Put(first.pBit, 1);
+            writer.Put(second.pBit, 1);
+            writer.Put(indices[0], 3);
+            for (u32 i = 1; i < BlockTexels; i++) {
+                writer.Put(indices[i], 4);
+            }
+        }
+    } // namespace
+
+    void CompressBlock(const GPUColorFormat format, const u8* texels, u8* block)
+    {
+        std::fill_n(block, GetColorFormatBlock(format).bytes, u8{0});
+
+        std::array<Float4, BlockTexels> colors;
+        std::array<f32, BlockTexels> channel;
+        auto loadColors = [&](const bool alpha) {
+            for (u32 i = 0; i < BlockTexels; i++) {
+                const u8* texel = texels + i * 4;
+                colors[i] = Float4::Set(texel[0], texel[1], texel[2], alpha ? texel[3] : 0.0f);
+            }
+        };
+        auto loadChannel = [&](const u32 index) {
+            for (u32 i = 0; i < BlockTexels; i++) {
+                channel[i] = texels[i * 4 + index];
+            }
+        };
+
+        switch (format) {
+        case GPUColorFormat::BC1_Unorm:
+        case GPUColorFormat::BC1_SRGB:
+            loadColors(false);
+            EncodeBC1(colors.data(), block);
+            break;
+        case GPUColorFormat::BC3_Unorm:
+        case GPUColorFormat::BC3_SRGB:
+            loadChannel(3);
+            EncodeBC4(channel.data(), block);
+            loadColors(false);
+            EncodeBC1(colors.data(), block + 8);
+            break;
+        case GPUColorFormat::BC4_Unorm:
+            loadChannel(0);
+            EncodeBC4(channel.data(), block);
+            break;
+        case GPUColorFormat::BC5_Unorm:
+            loadChannel(0);
+            EncodeBC4(channel.data(), block);
+            loadChannel(1);
+            EncodeBC4(channel.data(), block + 8);
+            break;
+        case GPUColorFormat::BC7_Unorm:
+        case GPUColorFormat::BC7_SRGB:
+            loadColors(true);
+            EncodeBC7(colors.data(), block);
+            break;
+        default: PANIC("Format %d isn't block compressed", static_cast<int>(format));
+        }
+    }
+
+    std::vector<u8> CompressTexture(
+        const std::span<const u8> chain, const MipChainLayout& layout, const TextureCompressDesc& desc
+    )
+    {
+        if (layout.levels.empty())
+            return {};
+        if (chain.size() < layout.size) {
+            PANIC(
+                "Mip chain needs %llu bytes but only got %zu", static_cast<unsigned long long>(layout.size),
+                chain.size()
+            );
+        }
+
+        const auto& base = layout.levels.front();
+        const auto compressedLayout = GetMipChainLayout(
+            base.width, base.height, static_cast<u32>(layout.levels.size()), desc.format
+        );
+        const u32 blockBytes = GetColorFormatBlock(desc.format).bytes;
+        std::vector<u8> result(compressedLayout.size);
+
+        for (usize level = 0; level < layout.levels.size(); level++) {
+            const auto& source = layout.levels[level];
+            const u32 blocksWide = (source.width + 3) / 4;
+            const u32 blocksHigh = (source.height + 3) / 4;
+            const u8* src = chain.data() + source.offset;
+            u8* dst = result.data() + compressedLayout.levels[level].offset;
+
+            auto encodeRows = [&](const u32 begin, const u32 end) {
+                std::array<u8, BlockTexels * 4> texels;
+                for (u32 blockY = begin; blockY < end; blockY++) {
+                    for (u32 blockX = 0; blockX < blocksWide; blockX++) {
+                        // Blocks hanging over the edge of small levels repeat the last row and column
+                        for (u32 y = 0; y < 4; y++) {
+                            const u32 sy = std::min(blockY * 4 + y, source.height - 1);
+                            for (u32 x = 0; x < 4; x++) {
+                                const u32 sx = std::min(blockX * 4 + x, source.width - 1);
+                                const u8* texel = src + (static_cast<u64>(sy) * source.width + sx) * 4;
+                                std::copy_n(texel, 4, texels.data() + (y * 4 + x) * 4);
+                            }
+                        }
+                        const u64 block = static_cast<u64>(blockY) * blocksWide + blockX;
+                        CompressBlock(desc.format, texels.data(), dst + block * blockBytes);
+                    }
+                }
+            };
+
+            if (desc.jobs) {
+                desc.jobs->ParallelFor(blocksHigh, 4, encodeRows);
+            } else {
+                encodeRows(0, blocksHigh);
+            }
+        }
+        return result;
+    }
+} // namespace Cocoa::Graphics
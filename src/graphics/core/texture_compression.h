@@ -0,0 +1,27 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "mip_generator.h"
+
+namespace Cocoa::Graphics {
+    struct TextureCompressDesc
+    {
+        /// @brief One of the BC formats, the sRGB variants encode the same bits and only change how they're sampled
+        GPUColorFormat format = GPUColorFormat::BC7_Unorm;
+        /// @brief Splits the block rows across the job system, blocks are encoded on the calling thread when null
+        Tools::JobSystem* jobs = nullptr;
+    };
+
+    /// @brief Encodes one 4x4 block
+    /// @param texels 16 RGBA8 texels in row order, BC4 only reads red and BC5 red and green
+    /// @param block Receives 8 bytes for BC1 and BC4, 16 bytes otherwise
+    void CompressBlock(GPUColorFormat format, const u8* texels, u8* block);
+
+    /// @brief Encodes every level of an RGBA8 mip chain
+    /// @param layout Layout of the RGBA8 chain, the result follows GetMipChainLayout for the compressed format
+    std::vector<u8> CompressTexture(
+        std::span<const u8> chain, const MipChainLayout& layout, const TextureCompressDesc& desc = {}
+    );
+} // namespace Cocoa::Graphics
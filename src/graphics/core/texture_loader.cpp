@@ -0,0 +1,448 @@
+#include "texture_loader.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+#include "../../macros.h"
+#include "../../tools/stb.h"
+#include "dds.h"
+
+namespace Cocoa::Graphics {
+    namespace {
+        // Keeps every reservation aligned for buffer to image copies of any texel size
+        constexpr u64 StagingAlignment = 16;
+
+        bool IsDDSPath(const std::filesystem::path& path)
+        {
+            auto extension = path.extension().string();
+            std::ranges::transform(extension, extension.begin(), [](const unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+            return extension == ".dds";
+        }
+
+        u64 AlignUp(const u64 value, const u64 alignment) { return (value + alignment - 1) / alignment * alignment; }
+    } // namespace
+
+    void TextureLoader::PixelsDeleter::operator()(unsigned char* pixels) const { stbi_image_free(pixels); }
+
+    TextureLoader::TextureLoader(RenderDevice& device, const TextureLoaderDesc& desc)
+        : _device(device), _stagingSize(desc.stagingSize),
+          _blockCompressionSupported(device.IsBlockCompressionSupported()),
+          _mipDesc({.filter = desc.mipFilter, .srgb = desc.srgb, .jobs = desc.jobs}), _generateMips(desc.generateMips),
+          _workers(desc.threadCount)
+    {
+        _staging = _device.CreateBuffer({
+            .usage = GPUBufferUsage::TransferSrc,
+            .access = GPUMemoryAccess::CPUToGPU,
+            .size = _stagingSize,
+        });
+        _stagingData = static_cast<std::byte*>(_device.GetBufferMappedData(_staging));
+        if (!_stagingData) {
+            PANIC("Texture staging ring isn't host visible");
+        }
+    }
+
+    TextureLoader::~TextureLoader()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _stagingFreed.notify_all();
+        _workers.WaitForIdle();
+
+        // Textures nobody picked up are still owned by the loader
+        for (auto& request : _requests) {
+            if (request.result.view.IsValid()) {
+                _device.DestroyTextureView(request.result.view);
+            }
+            if (request.result.texture.IsValid()) {
+                _device.DestroyTexture(request.result.texture);
+            }
+        }
+        _device.DestroyBuffer(_staging);
+    }
+
+    TextureLoadTicket TextureLoader::Load(const std::filesystem::path& path)
+    {
+        TextureLoadTicket ticket;
+        {
+            std::lock_guard lock(_mutex);
+            ticket = static_cast<TextureLoadTicket>(_requests.size());
+            _requests.emplace_back().path = path;
+        }
+        _workers.Submit([this, ticket] { Decode(ticket); });
+        return ticket;
+    }
+
+    TextureLoadTicket TextureLoader::Load(const Tools::Archive& archive, const std::string_view name)
+    {
+        const auto entry = archive.Find(name);
+        TextureLoadTicket ticket;
+        {
+            std::lock_guard lock(_mutex);
+            ticket = static_cast<TextureLoadTicket>(_requests.size());
+            auto& request = _requests.emplace_back();
+            request.path = name;
+            request.archive = &archive;
+            request.entry = entry;
+            if (!entry) {
+                PUSH_WARN(
+                    "Failed to load texture %.*s: not in the archive", static_cast<int>(name.size()), name.data()
+                );
+                request.state = TextureLoadState::Failed;
+                _stats.failed++;
+                return ticket;
+            }
+        }
+        _workers.Submit([this, ticket] { Decode(ticket); });
+        return ticket;
+    }
+
+    u32 TextureLoader::Flush()
+    {
+        // Workers only ever move requests out of Decoding, so the decoded ones can be used without the lock
+        std::vector<TextureLoadTicket> decoded;
+        {
+            std::lock_guard lock(_mutex);
+            for (TextureLoadTicket ticket = 0; ticket < _requests.size(); ticket++) {
+                if (_requests[ticket].state == TextureLoadState::Decoded) {
+                    decoded.push_back(ticket);
+                }
+            }
+        }
+        if (decoded.empty())
+            return 0;
+
+        std::vector<Request*> requests;
+        std::vector<GPUTextureUpload> uploads;
+        std::vector<GPUBufferHandle> oversizedStaging;
+        {
+            std::lock_guard lock(_mutex);
+            for (const auto ticket : decoded) {
+                requests.push_back(&_requests[ticket]);
+            }
+        }
+
+        for (const auto request : requests) {
+            const auto format = request->format;
+            auto& [texture, view, width, height, levels] = request->result;
+            texture = _device.CreateTexture({
+                .usage = GPUTextureUsage::ShaderUsage | GPUTextureUsage::TransferDst,
+                .access = GPUMemoryAccess::GPUOnly,
+                .format = format,
+                .scale = {width, height, 1},
+                .levels = levels,
+            });
+            view = _device.CreateTextureView({.texture = texture, .format = format, .levels = levels});
+
+            auto source = _staging;
+            u64 sourceOffset = request->stagingOffset;
+            if (!request->pixels.empty()) {
+                source = oversizedStaging.emplace_back(_device.CreateBuffer({
+                    .usage = GPUBufferUsage::TransferSrc,
+                    .access = GPUMemoryAccess::CPUToGPU,
+                    .size = request->layout.size,
+                    .mapped = request->pixels.data(),
+                }));
+                sourceOffset = 0;
+                request->pixels = {};
+            }
+            // Every level of a texture comes from one buffer, so the whole chain is one copy command
+            const auto levelUploads = GetMipChainUploads(source, texture, request->layout, sourceOffset);
+            uploads.insert(uploads.end(), levelUploads.begin(), levelUploads.end());
+        }
+
+        _device.EncodeImmediateCommands(
+            [&](RenderEncoder* encoder) { encoder->UploadBufferDataToTextures(uploads); }, {}
+        );
+        for (auto& buffer : oversizedStaging) {
+            _device.DestroyBuffer(buffer);
+        }
+
+        {
+            std::lock_guard lock(_mutex);
+            for (const auto ticket : decoded) {
+                _requests[ticket].state = TextureLoadState::Ready;
+                ReleaseStaging(ticket);
+            }
+            _stats.uploaded += static_cast<u32>(decoded.size());
+        }
+        _stagingFreed.notify_all();
+        return static_cast<u32>(decoded.size());
+    }
+
+    void TextureLoader::WaitForAll()
+    {
+        while (true) {
+            Flush();
+
+            std::unique_lock lock(_mutex);
+            const bool pending = std::ranges::any_of(_requests, [](const Request& request) {
+                return request.state == TextureLoadState::Decoding || request.state == TextureLoadState::Decoded;
+            });
+            if (!pending)
+                return;
+
+            // Workers waiting on the ring only continue after a flush, so wake up for any progress
+            _stagingFreed.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    TextureLoadState TextureLoader::GetState(const TextureLoadTicket ticket)
+    {
+        std::lock_guard lock(_mutex);
+        return _requests[ticket].state;
+    }
+
+    LoadedTexture TextureLoader::GetTexture(const TextureLoadTicket ticket)
+    {
+        std::lock_guard lock(_mutex);
+        auto& result = _requests[ticket].result;
+        const auto texture = result;
+        result.texture.Invalidate();
+        result.view.Invalidate();
+        return texture;
+    }
+
+    TextureLoaderStats TextureLoader::GetStats()
+    {
+        std::lock_guard lock(_mutex);
+        return _stats;
+    }
+
+    void TextureLoader::Decode(const TextureLoadTicket ticket)
+    {
+        std::filesystem::path path;
+        const Tools::Archive* archive;
+        const Tools::ArchiveEntry* entry;
+        {
+            std::lock_guard lock(_mutex);
+            if (_stopping)
+                return;
+            path = _requests[ticket].path;
+            archive = _requests[ticket].archive;
+            entry = _requests[ticket].entry;
+        }
+
+        auto fail = [&]([[maybe_unused]] const char* reason) {
+            PUSH_WARN("Failed to load texture %s: %s", path.string().c_str(), reason);
+            std::lock_guard lock(_mutex);
+            _requests[ticket].state = TextureLoadState::Failed;
+            _stats.failed++;
+        };
+
+        // Uncompressed archive entries are used straight from the mapping, compressed ones are decoded in pieces below
+        const bool compressed = archive && entry->compression != Tools::ArchiveCompression::None;
+        std::vector<u8> fileData;
+        std::span<const u8> encoded;
+        if (archive && !compressed) {
+            encoded = archive->GetStoredData(*entry);
+        } else if (!archive) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file) {
+                fail("can't open file");
+                return;
+            }
+            fileData.resize(static_cast<usize>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+            encoded = fileData;
+        }
+
+        // DDS files already hold their final format and mip chain, everything else is decoded with stb_image
+        GPUColorFormat format;
+        MipChainLayout layout;
+        std::vector<u8> chain;
+        const u8* data = nullptr;
+        std::unique_ptr<unsigned char, PixelsDeleter> pixels;
+        std::chrono::steady_clock::duration decodeTime{}, mipTime{}, streamTime{};
+        u64 streamedBytes = 0;
+        // A compressed DDS chain is never held in full, it's decompressed from here into staging memory
+        std::optional<u64> streamOffset;
+        if (IsDDSPath(path)) {
+            const auto start = std::chrono::steady_clock::now();
+            std::array<u8, DDSMaxHeaderSize> headerData{};
+            if (compressed) {
+                const auto headerSize = static_cast<usize>(std::min<u64>(DDSMaxHeaderSize, entry->originalSize));
+                if (archive->Read(*entry, 0, std::span(headerData).first(headerSize))) {
+                    encoded = std::span(headerData).first(headerSize);
+                }
+            }
+            auto header = ParseDDSHeader(encoded);
+            decodeTime = std::chrono::steady_clock::now() - start;
+            const u64 fileSize = compressed ? entry->originalSize : encoded.size();
+            if (!header || fileSize < header->dataOffset + header->layout.size) {
+                fail("not a supported DDS texture");
+                return;
+            }
+            if (IsBlockCompressedFormat(header->format) && !_blockCompressionSupported) {
+                fail("the GPU doesn't support block compressed textures");
+                return;
+            }
+            format = header->format;
+            layout = std::move(header->layout);
+            if (compressed) {
+                streamOffset = header->dataOffset;
+            } else {
+                data = encoded.data() + header->dataOffset;
+            }
+        } else {
+            if (compressed) {
+                const auto start = std::chrono::steady_clock::now();
+                fileData.resize(static_cast<usize>(entry->originalSize));
+                if (!archive->Read(*entry, 0, fileData)) {
+                    fail("corrupt archive entry");
+                    return;
+                }
+                streamTime = std::chrono::steady_clock::now() - start;
+                streamedBytes = fileData.size();
+                encoded = fileData;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            int width = 0, height = 0, channels = 0;
+            pixels.reset(stbi_load_from_memory(
+                encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels, STBI_rgb_alpha
+            ));
+            decodeTime = std::chrono::steady_clock::now() - start;
+            if (!pixels) {
+                fail(stbi_failure_reason());
+                return;
+            }
+
+            // Mips are built in ordinary memory, reading back from the mapped ring could be uncached
+            format = _mipDesc.srgb ? GPUColorFormat::RGBA8_SRGB : GPUColorFormat::RGBA8_Unorm;
+            layout = GetMipChainLayout(static_cast<u32>(width), static_cast<u32>(height), _generateMips ? 0 : 1);
+            data = pixels.get();
+            const auto mipStart = std::chrono::steady_clock::now();
+            if (layout.levels.size() > 1) {
+                chain.resize(layout.size);
+                std::memcpy(chain.data(), pixels.get(), layout.levels[1].offset);
+                pixels.reset();
+                GenerateMips(chain, layout, _mipDesc);
+                data = chain.data();
+            }
+            mipTime = std::chrono::steady_clock::now() - mipStart;
+        }
+
+        // Either copies the decoded chain or decompresses the archive entry into it
+        auto write = [&](u8* destination) {
+            if (!streamOffset) {
+                std::memcpy(destination, data, layout.size);
+                return true;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const bool read = archive->Read(*entry, *streamOffset, {destination, static_cast<usize>(layout.size)});
+            streamTime = std::chrono::steady_clock::now() - start;
+            streamedBytes = layout.size;
+            return read;
+        };
+
+        std::unique_lock lock(_mutex);
+        auto offset = ReserveStaging(layout.size, ticket);
+        if (offset) {
+            // The reservation is ours alone, so the copy runs without holding the lock
+            lock.unlock();
+            const bool written = write(reinterpret_cast<u8*>(_stagingData + *offset));
+            chain = {};
+            lock.lock();
+            if (!written) {
+                ReleaseStaging(ticket);
+                lock.unlock();
+                _stagingFreed.notify_all();
+                fail("corrupt archive entry");
+                return;
+            }
+        } else if (_stopping) {
+            return;
+        } else {
+            if (chain.empty()) {
+                lock.unlock();
+                chain.resize(layout.size);
+                const bool written = write(chain.data());
+                lock.lock();
+                if (!written) {
+                    lock.unlock();
+                    fail("corrupt archive entry");
+                    return;
+                }
+            }
+            _stats.oversized++;
+        }
+
+        auto& request = _requests[ticket];
+        request.result.width = layout.levels[0].width;
+        request.result.height = layout.levels[0].height;
+        request.result.levels = static_cast<u32>(layout.levels.size());
+        request.format = format;
+        request.stagingOffset = offset.value_or(0);
+        request.pixels = std::move(chain);
+        request.state = TextureLoadState::Decoded;
+        _stats.decoded++;
+        _stats.decodedBytes += layout.size;
+        _stats.decodeTime += std::chrono::duration_cast<std::chrono::nanoseconds>(decodeTime);
+        _stats.mipTime += std::chrono::duration_cast<std::chrono::nanoseconds>(mipTime);
+        _stats.streamedBytes += streamedBytes;
+        _stats.streamTime += std::chrono::duration_cast<std::chrono::nanoseconds>(streamTime);
+        request.layout = std::move(layout);
+    }
+
+    std::optional<u64> TextureLoader::ReserveStaging(u64 size, const TextureLoadTicket ticket)
+    {
+        size = AlignUp(size, StagingAlignment);
+        if (size > _stagingSize)
+            return std::nullopt;
+
+        // Must be called with the lock held, waits for earlier uploads to free enough of the ring
+        std::unique_lock lock(_mutex, std::adopt_lock);
+        std::optional<u64> offset;
+        _stagingFreed.wait(lock, [&] {
+            if (_stopping)
+                return true;
+            if (_reservations.empty()) {
+                _stagingHead = 0;
+                offset = 0;
+                return true;
+            }
+
+            // The space between head and tail is free, a full ring never lets head catch up to tail
+            const u64 tail = _reservations.front().offset;
+            if (_stagingHead >= tail) {
+                if (_stagingHead + size <= _stagingSize) {
+                    offset = _stagingHead;
+                } else if (size < tail) {
+                    offset = 0;
+                }
+            } else if (_stagingHead + size < tail) {
+                offset = _stagingHead;
+            }
+            return offset.has_value();
+        });
+        lock.release();
+
+        if (!offset)
+            return std::nullopt;
+
+        _stagingHead = *offset + size;
+        _reservations.push_back({.offset = *offset, .size = size, .ticket = ticket});
+        return offset;
+    }
+
+    void TextureLoader::ReleaseStaging(const TextureLoadTicket ticket)
+    {
+        for (auto& reservation : _reservations) {
+            if (reservation.ticket == ticket) {
+                reservation.released = true;
+                break;
+            }
+        }
+        while (!_reservations.empty() && _reservations.front().released) {
+            _reservations.pop_front();
+        }
+    }
+} // namespace Cocoa::Graphics
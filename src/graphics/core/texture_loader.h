@@ -0,0 +1,155 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+#include "../../tools/archive.h"
+#include "../../tools/thread_pool.h"
+#include "mip_generator.h"
+#include "render_device.h"
+
+namespace Cocoa::Graphics {
+    using TextureLoadTicket = u32;
+
+    enum class TextureLoadState
+    {
+        Decoding,
+        /// @brief Decoded and waiting in staging memory for the next Flush
+        Decoded,
+        Ready,
+        Failed
+    };
+
+    struct TextureLoaderDesc
+    {
+        /// @brief Decode threads, 0 picks one less than the hardware thread count
+        u32 threadCount = 0;
+        /// @brief Size of the persistently mapped ring decoded pixels are written into
+        u64 stagingSize = 64 * 1024 * 1024;
+        /// @brief Generates the full mip chain on the decode thread and uploads every level, DDS files keep theirs
+        bool generateMips = true;
+        MipFilter mipFilter = MipFilter::Kaiser;
+        /// @brief Images hold sRGB color, textures are created as RGBA8_SRGB and mips are filtered in linear space
+        bool srgb = false;
+        /// @brief Spreads mip generation of large images across the job system instead of one decode thread
+        Tools::JobSystem* jobs = nullptr;
+    };
+
+    struct LoadedTexture
+    {
+        GPUTextureHandle texture = GPUTextureHandle(u64Max);
+        GPUTextureViewHandle view = GPUTextureViewHandle(u64Max);
+        u32 width = 0;
+        u32 height = 0;
+        u32 levels = 1;
+    };
+
+    struct TextureLoaderStats
+    {
+        u32 decoded = 0;
+        u32 uploaded = 0;
+        u32 failed = 0;
+        /// @brief Bytes written to staging memory, mips included
+        u64 decodedBytes = 0;
+        /// @brief Summed over every worker, divide by wall time to see how well decoding scales
+        std::chrono::nanoseconds decodeTime{0};
+        /// @brief Summed over every worker like decodeTime
+        std::chrono::nanoseconds mipTime{0};
+        /// @brief Images too large for the staging ring, uploaded from a staging buffer of their own
+        u32 oversized = 0;
+        /// @brief Bytes decompressed from archive entries, together with streamTime this is the codec's throughput
+        u64 streamedBytes = 0;
+        /// @brief Summed over every worker like decodeTime
+        std::chrono::nanoseconds streamTime{0};
+    };
+
+    /// @brief Decodes images on worker threads into a shared staging ring and uploads them in batches
+    /// @note DDS files are uploaded as they are, with their own format and mips
+    /// @note Load and Flush are meant to be called from the thread that owns the device, only decoding runs elsewhere
+    class TextureLoader
+    {
+      public:
+        explicit TextureLoader(RenderDevice& device, const TextureLoaderDesc& desc = {});
+        ~TextureLoader();
+
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
+
+        /// @brief Queues an image file to be decoded as RGBA8, or read as is for DDS files
+        TextureLoadTicket Load(const std::filesystem::path& path);
+
+        /// @brief Queues an image stored in an archive, compressed DDS chains are decompressed straight into staging
+        /// @note The archive has to stay alive until the texture has been decoded
+        TextureLoadTicket Load(const Tools::Archive& archive, std::string_view name);
+
+        /// @brief Creates textures for every decoded image and uploads them in a single submission
+        /// @return The number of textures that became ready
+        u32 Flush();
+
+        /// @brief Flushes until every queued image is either ready or failed
+        void WaitForAll();
+
+        [[nodiscard]] TextureLoadState GetState(TextureLoadTicket ticket);
+
+        /// @brief The texture and view of a ready image, ownership moves to the caller
+        [[nodiscard]] LoadedTexture GetTexture(TextureLoadTicket ticket);
+
+        [[nodiscard]] TextureLoaderStats GetStats();
+
+      private:
+        struct PixelsDeleter
+        {
+            void operator()(unsigned char* pixels) const;
+        };
+
+        struct Request
+        {
+            std::filesystem::path path;
+            /// @brief Set for images stored in an archive, otherwise the image is read from path
+            const Tools::Archive* archive = nullptr;
+            const Tools::ArchiveEntry* entry = nullptr;
+            TextureLoadState state = TextureLoadState::Decoding;
+            LoadedTexture result;
+            GPUColorFormat format = GPUColorFormat::RGBA8_Unorm;
+            MipChainLayout layout;
+            u64 stagingOffset = 0;
+            /// @brief Only kept for images that didn't fit in the staging ring
+            std::vector<u8> pixels;
+        };
+
+        /// @brief A reserved run of the staging ring, freed in reservation order once its upload is done
+        struct Reservation
+        {
+            u64 offset;
+            u64 size;
+            TextureLoadTicket ticket;
+            bool released = false;
+        };
+
+        RenderDevice& _device;
+        GPUBufferHandle _staging;
+        std::byte* _stagingData = nullptr;
+        u64 _stagingSize;
+        bool _blockCompressionSupported;
+        MipGenerateDesc _mipDesc;
+        bool _generateMips;
+        u64 _stagingHead = 0;
+        std::deque<Reservation> _reservations;
+
+        std::mutex _mutex;
+        std::condition_variable _stagingFreed;
+        std::deque<Request> _requests;
+        TextureLoaderStats _stats;
+        bool _stopping = false;
+
+        // Last so workers are joined before anything they touch is destroyed
+        Tools::ThreadPool _workers;
+
+        void Decode(TextureLoadTicket ticket);
+        [[nodiscard]] std::optional<u64> ReserveStaging(u64 size, TextureLoadTicket ticket);
+        void ReleaseStaging(TextureLoadTicket ticket);
+    };
+} // namespace Cocoa::Graphics
@@ -0,0 +1,327 @@
+#include "texture_streamer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+
+#include "../../macros.h"
+
+namespace Cocoa::Graphics {
+    TextureStreamer::TextureStreamer(RenderDevice& device, const TextureStreamerDesc& desc)
+        : _device(device), _desc(desc), _blockCompressionSupported(device.IsBlockCompressionSupported()),
+          _workers(desc.threadCount)
+    {
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        _workers.WaitForIdle();
+        for (auto& texture : _textures) {
+            if (texture.view.IsValid()) {
+                _device.DestroyTextureView(texture.view);
+            }
+            if (texture.texture.IsValid()) {
+                _device.DestroyTexture(texture.texture);
+            }
+        }
+        for (auto& [texture, view, frame] : _retired) {
+            _device.DestroyTextureView(view);
+            _device.DestroyTexture(texture);
+        }
+    }
+
+    StreamedTextureId TextureStreamer::Register(const std::filesystem::path& path) { return Add({.path = path}); }
+
+    StreamedTextureId TextureStreamer::Register(const Tools::Archive& archive, const std::string_view name)
+    {
+        return Add({.path = name, .archive = &archive, .entry = archive.Find(name)});
+    }
+
+    void TextureStreamer::RequestLevel(const StreamedTextureId id, const u32 level)
+    {
+        auto& texture = _textures[id];
+        if (texture.failed)
+            return;
+        texture.requestedLevel = std::min(texture.requestedLevel, level);
+        texture.lastUsedFrame = _frame;
+    }
+
+    void TextureStreamer::RequestScreenSize(const StreamedTextureId id, const f32 screenSize)
+    {
+        // Textures that failed in Register have no levels to pick from
+        const auto& texture = _textures[id];
+        if (texture.failed)
+            return;
+        const auto& base = texture.header.layout.levels.front();
+        const f32 size = static_cast<f32>(std::max(base.width, base.height));
+
+        // Rounding down keeps at least one texel per pixel, the level is clamped to the tail later
+        const f32 level = std::floor(std::log2(size / std::max(screenSize, 1.0f)));
+        RequestLevel(id, static_cast<u32>(std::max(level, 0.0f)));
+    }
+
+    void TextureStreamer::Update()
+    {
+        // Replaced textures can still be read by frames the GPU hasn't finished
+        std::erase_if(_retired, [&](Retired& retired) {
+            if (_frame < retired.frame + _desc.framesInFlight)
+                return false;
+            _device.DestroyTextureView(retired.view);
+            _device.DestroyTexture(retired.texture);
+            return true;
+        });
+
+        FinishLoads();
+        StartLoads();
+
+        for (auto& texture : _textures) {
+            texture.requestedLevel = u32Max;
+        }
+        _frame++;
+    }
+
+    GPUTextureViewHandle TextureStreamer::GetView(const StreamedTextureId id) const { return _textures[id].view; }
+
+    u32 TextureStreamer::GetResidentLevel(const StreamedTextureId id) const { return _textures[id].residentLevel; }
+
+    StreamedTextureId TextureStreamer::Add(Source source)
+    {
+        const auto id = static_cast<StreamedTextureId>(_textures.size());
+        auto& texture = _textures.emplace_back();
+        texture.source = std::move(source);
+
+        auto fail = [&]([[maybe_unused]] const char* reason) {
+            PUSH_WARN("Failed to stream texture %s: %s", texture.source.path.string().c_str(), reason);
+            texture.failed = true;
+            return id;
+        };
+
+        if (texture.source.archive && !texture.source.entry)
+            return fail("not in the archive");
+
+        std::array<u8, DDSMaxHeaderSize> headerData{};
+        u64 fileSize = 0;
+        if (texture.source.entry) {
+            fileSize = texture.source.entry->originalSize;
+        } else {
+            std::error_code error;
+            fileSize = std::filesystem::file_size(texture.source.path, error);
+            if (error)
+                return fail("can't open file");
+        }
+        const auto headerSize = static_cast<usize>(std::min<u64>(DDSMaxHeaderSize, fileSize));
+        if (!ReadSource(texture.source, 0, std::span(headerData).first(headerSize)))
+            return fail("can't read the header");
+
+        auto header = ParseDDSHeader(std::span(headerData).first(headerSize));
+        if (!header || fileSize < header->dataOffset + header->layout.size)
+            return fail("not a supported DDS texture");
+        if (IsBlockCompressedFormat(header->format) && !_blockCompressionSupported)
+            return fail("the GPU doesn't support block compressed textures");
+        texture.header = std::move(*header);
+
+        const auto& levels = texture.header.layout.levels;
+        texture.tailLevel = static_cast<u32>(levels.size() - 1);
+        for (u32 level = 0; level < levels.size(); level++) {
+            if (std::max(levels[level].width, levels[level].height) <= _desc.tailSize) {
+                texture.tailLevel = level;
+                break;
+            }
+        }
+        return id;
+    }
+
+    void TextureStreamer::FinishLoads()
+    {
+        std::vector<Load> completed;
+        {
+            std::lock_guard lock(_mutex);
+            completed.swap(_completed);
+        }
+        if (completed.empty())
+            return;
+
+        std::vector<GPUTextureUpload> uploads;
+        std::vector<GPUBufferHandle> staging;
+        for (auto& load : completed) {
+            auto& texture = _textures[load.id];
+            texture.loading = false;
+            _stats.loadsInFlight--;
+            if (load.failed) {
+                // Whatever is resident stays usable, the texture just doesn't change anymore
+                PUSH_WARN("Failed to stream texture %s: can't read the data", texture.source.path.string().c_str());
+                texture.failed = true;
+                const u64 bytes = texture.residentLevel == u32Max
+                                      ? 0
+                                      : _device.GetTextureMemoryRequirements(
+                                            GetTextureDesc(texture, texture.residentLevel)
+                                        ).size;
+                _stats.committedBytes = _stats.committedBytes - texture.bytes + bytes;
+                texture.bytes = bytes;
+                continue;
+            }
+
+            auto desc = GetTextureDesc(texture, load.firstLevel);
+            auto newTexture = _device.CreateTexture(desc);
+            auto newView = _device.CreateTextureView({
+                .texture = newTexture,
+                .format = desc.format,
+                .levels = desc.levels,
+            });
+
+            const auto& base = texture.header.layout.levels[load.firstLevel];
+            const auto layout = GetMipChainLayout(base.width, base.height, desc.levels, texture.header.format);
+            auto& buffer = staging.emplace_back(_device.CreateBuffer({
+                .usage = GPUBufferUsage::TransferSrc,
+                .access = GPUMemoryAccess::CPUToGPU,
+                .size = layout.size,
+                .mapped = load.data.data(),
+            }));
+            const auto levelUploads = GetMipChainUploads(buffer, newTexture, layout, 0);
+            uploads.insert(uploads.end(), levelUploads.begin(), levelUploads.end());
+
+            if (load.firstLevel < texture.residentLevel || texture.residentLevel == u32Max) {
+                _stats.loaded++;
+            } else {
+                _stats.evicted++;
+            }
+            if (texture.texture.IsValid()) {
+                _retired.push_back({.texture = texture.texture, .view = texture.view, .frame = _frame});
+            }
+            texture.texture = newTexture;
+            texture.view = newView;
+            texture.residentLevel = load.firstLevel;
+        }
+        if (uploads.empty())
+            return;
+
+        // Every swap of this update lands in one submission, before anything of the next frame is recorded
+        _device.EncodeImmediateCommands(
+            [&](RenderEncoder* encoder) { encoder->UploadBufferDataToTextures(uploads); }, {}
+        );
+        for (auto& buffer : staging) {
+            _device.DestroyBuffer(buffer);
+        }
+    }
+
+    void TextureStreamer::StartLoads()
+    {
+        struct Candidate
+        {
+            StreamedTextureId id;
+            u32 level;
+        };
+
+        std::vector<Candidate> candidates;
+        for (StreamedTextureId id = 0; id < _textures.size(); id++) {
+            const auto& texture = _textures[id];
+            if (texture.loading || texture.failed)
+                continue;
+
+            // Textures go one level at a time, so every texture gets a coarse improvement before any gets a fine one
+            if (texture.residentLevel == u32Max) {
+                candidates.push_back({id, texture.tailLevel});
+            } else if (std::min(texture.requestedLevel, texture.tailLevel) < texture.residentLevel) {
+                candidates.push_back({id, texture.residentLevel - 1});
+            }
+        }
+        std::ranges::sort(candidates, [&](const Candidate& a, const Candidate& b) {
+            if (a.level != b.level)
+                return a.level > b.level;
+            return _textures[a.id].lastUsedFrame > _textures[b.id].lastUsedFrame;
+        });
+
+        for (const auto& [id, level] : candidates) {
+            if (_stats.loadsInFlight >= _desc.maxLoadsInFlight)
+                break;
+
+            // Tails are tiny and nothing can be drawn without them, so only levels above the tail answer to the budget
+            const auto& texture = _textures[id];
+            const u64 bytes = _device.GetTextureMemoryRequirements(GetTextureDesc(texture, level)).size;
+            if (level < texture.tailLevel) {
+                // Evictions are loads of a smaller level, so they count against the same cap
+                bool fits = true;
+                while (_stats.committedBytes + bytes - texture.bytes > _desc.budget) {
+                    if (_stats.loadsInFlight >= _desc.maxLoadsInFlight || !EvictOne()) {
+                        fits = false;
+                        break;
+                    }
+                }
+                // Candidates are sorted coarse first, so the rest would need even more memory
+                if (!fits || _stats.loadsInFlight >= _desc.maxLoadsInFlight)
+                    break;
+            }
+            StartLoad(id, level);
+        }
+    }
+
+    void TextureStreamer::StartLoad(const StreamedTextureId id, const u32 firstLevel)
+    {
+        auto& texture = _textures[id];
+        const u64 bytes = _device.GetTextureMemoryRequirements(GetTextureDesc(texture, firstLevel)).size;
+        _stats.committedBytes = _stats.committedBytes - texture.bytes + bytes;
+        _stats.loadsInFlight++;
+        texture.bytes = bytes;
+        texture.loading = true;
+
+        // Levels are stored largest first, so a level and everything below it is one contiguous read
+        const auto& layout = texture.header.layout;
+        const u64 offset = texture.header.dataOffset + layout.levels[firstLevel].offset;
+        const u64 size = layout.size - layout.levels[firstLevel].offset;
+        _stats.streamedBytes += size;
+        _workers.Submit([this, id, firstLevel, offset, size, source = texture.source] {
+            Load load{.id = id, .firstLevel = firstLevel, .data = std::vector<u8>(size)};
+            load.failed = !ReadSource(source, offset, load.data);
+
+            std::lock_guard lock(_mutex);
+            _completed.push_back(std::move(load));
+        });
+    }
+
+    bool TextureStreamer::EvictOne()
+    {
+        // Anything used this frame is still needed, evicting it would only load it again next frame
+        Texture* oldest = nullptr;
+        StreamedTextureId oldestId = 0;
+        for (StreamedTextureId id = 0; id < _textures.size(); id++) {
+            auto& texture = _textures[id];
+            const bool evictable = !texture.loading && !texture.failed && texture.residentLevel < texture.tailLevel &&
+                                   texture.lastUsedFrame < _frame;
+            if (evictable && (!oldest || texture.lastUsedFrame < oldest->lastUsedFrame)) {
+                oldest = &texture;
+                oldestId = id;
+            }
+        }
+        if (!oldest)
+            return false;
+
+        StartLoad(oldestId, oldest->residentLevel + 1);
+        return true;
+    }
+
+    GPUTextureDesc TextureStreamer::GetTextureDesc(const Texture& texture, const u32 firstLevel) const
+    {
+        const auto& base = texture.header.layout.levels[firstLevel];
+        return {
+            .usage = GPUTextureUsage::ShaderUsage | GPUTextureUsage::TransferDst,
+            .access = GPUMemoryAccess::GPUOnly,
+            .format = texture.header.format,
+            .scale = {base.width, base.height, 1},
+            .levels = static_cast<u32>(texture.header.layout.levels.size()) - firstLevel,
+        };
+    }
+
+    bool TextureStreamer::ReadSource(const Source& source, const u64 offset, const std::span<u8> destination)
+    {
+        if (source.archive)
+            return source.archive->Read(*source.entry, offset, destination);
+
+        std::ifstream file(source.path, std::ios::binary);
+        if (!file)
+            return false;
+        file.seekg(static_cast<std::streamoff>(offset));
+        file.read(reinterpret_cast<char*>(destination.data()), static_cast<std::streamsize>(destination.size()));
+        return static_cast<bool>(file);
+    }
+} // namespace Cocoa::Graphics
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "../../tools/archive.h"
+#include "../../tools/thread_pool.h"
+#include "dds.h"
+#include "render_device.h"
+
+namespace Cocoa::Graphics {
+    using StreamedTextureId = u32;
+
+    struct TextureStreamerDesc
+    {
+        /// @brief GPU memory streamed textures may use, the mip tails are always kept even when they go over it
+        u64 budget = 256ull * 1024 * 1024;
+        /// @brief Levels this size or smaller form the tail, loaded first and never evicted
+        u32 tailSize = 64;
+        /// @brief Loads running at once, each one reads and uploads a whole mip chain
+        u32 maxLoadsInFlight = 8;
+        /// @brief Frames the GPU can lag behind the CPU, replaced textures are destroyed after this many updates
+        u32 framesInFlight = 2;
+        /// @brief Read threads, 0 picks one less than the hardware thread count
+        u32 threadCount = 2;
+    };
+
+    struct TextureStreamerStats
+    {
+        /// @brief Memory of every resident level, including loads that haven't finished yet
+        u64 committedBytes = 0;
+        u32 loadsInFlight = 0;
+        /// @brief Level increases since the streamer was created
+        u32 loaded = 0;
+        /// @brief Level decreases since the streamer was created, made to get back under the budget
+        u32 evicted = 0;
+        /// @brief Bytes read from files and archives
+        u64 streamedBytes = 0;
+    };
+
+    /// @brief Keeps DDS textures resident only down to the level they're seen at, within a memory budget
+    /// @note Each texture is rebuilt with a different number of levels instead of using sparse residency, so a level
+    /// change re-reads the smaller levels too. They're a third of the size at most.
+    /// @note Register, the requests and Update are meant to be called from the thread that owns the device
+    class TextureStreamer
+    {
+      public:
+        explicit TextureStreamer(RenderDevice& device, const TextureStreamerDesc& desc = {});
+        /// @note The GPU must be done with every streamed texture
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+        /// @brief Reads the header of a DDS file and queues its mip tail
+        StreamedTextureId Register(const std::filesystem::path& path);
+
+        /// @note The archive has to outlive the streamer
+        StreamedTextureId Register(const Tools::Archive& archive, std::string_view name);
+
+        /// @brief Asks for a level to be resident this frame, the finest level asked for wins
+        void RequestLevel(StreamedTextureId id, u32 level);
+
+        /// @brief Asks for the level that matches how many pixels the texture covers on screen
+        /// @param screenSize Pixels across the largest side, e.g. from Camera::GetProjectedSize
+        void RequestScreenSize(StreamedTextureId id, f32 screenSize);
+
+        /// @brief Swaps in finished loads and starts new ones, evicting the least recently used levels to stay in
+        /// budget. Call once per frame, a swap replaces the view between frames so a frame never mixes the two.
+        void Update();
+
+        /// @return An invalid handle until the mip tail has been uploaded
+        [[nodiscard]] GPUTextureViewHandle GetView(StreamedTextureId id) const;
+
+        /// @return The finest resident level, u32Max while nothing is resident
+        [[nodiscard]] u32 GetResidentLevel(StreamedTextureId id) const;
+
+        [[nodiscard]] TextureStreamerStats GetStats() const { return _stats; }
+
+      private:
+        /// @brief Where a DDS file is read from, either a loose file or an archive entry
+        struct Source
+        {
+            std::filesystem::path path;
+            const Tools::Archive* archive = nullptr;
+            const Tools::ArchiveEntry* entry = nullptr;
+        };
+
+        struct Texture
+        {
+            Source source;
+            DDSHeader header;
+            u32 tailLevel = 0;
+
+            GPUTextureHandle texture = GPUTextureHandle(u64Max);
+            GPUTextureViewHandle view = GPUTextureViewHandle(u64Max);
+            u32 residentLevel = u32Max;
+            /// @brief Memory of the resident levels, or of the loading ones once a load starts
+            u64 bytes = 0;
+            u32 requestedLevel = u32Max;
+            u64 lastUsedFrame = 0;
+            bool loading = false;
+            bool failed = false;
+        };
+
+        struct Load
+        {
+            StreamedTextureId id;
+            u32 firstLevel;
+            std::vector<u8> data;
+            bool failed = false;
+        };
+
+        struct Retired
+        {
+            GPUTextureHandle texture;
+            GPUTextureViewHandle view;
+            u64 frame;
+        };
+
+        RenderDevice& _device;
+        TextureStreamerDesc _desc;
+        bool _blockCompressionSupported;
+        std::deque<Texture> _textures;
+        std::vector<Retired> _retired;
+        TextureStreamerStats _stats;
+        u64 _frame = 0;
+
+        std::mutex _mutex;
+        std::vector<Load> _completed;
+
+        // Last so workers are joined before anything they touch is destroyed
+        Tools::ThreadPool _workers;
+
+        StreamedTextureId Add(Source source);
+        void FinishLoads();
+        void StartLoads();
+        void StartLoad(StreamedTextureId id, u32 firstLevel);
+        bool EvictOne();
+        [[nodiscard]] GPUTextureDesc GetTextureDesc(const Texture& texture, u32 firstLevel) const;
+        [[nodiscard]] static bool ReadSource(const Source& source, u64 offset, std::span<u8> destination);
+    };
+} // namespace Cocoa::Graphics
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SDL3/SDL.h>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <variant>
@@ -18,6 +19,13 @@ namespace Cocoa::Graphics {
         SDL_Window* window = nullptr;
         std::vector<GPUQueueType> desiredQueues;
         GPUPowerPreference powerPreference = GPUPowerPreference::HighPerformance;
+        /// @brief Where compiled pipelines are stored between launches, empty disables the on-disk cache
+        std::string pipelineCachePath = "pipeline_cache.bin";
+        /// @brief Worker threads used by CreateRenderPipelineAsync, 0 picks one per spare hardware thread
+        u32 pipelineCompileThreads = 0;
+        /// @brief Places every sampled texture, sampler and storage buffer in one global descriptor table
+        /// @note Pipeline layouts then reserve set 0 for the table and bind groups start at set 1
+        bool bindless = false;
     };
 
     struct RenderWindowDesc
@@ -86,29 +94,59 @@ namespace Cocoa::Graphics {
         }
     };
 
-    using GPUBindGroupEntry = std::variant<GPUBufferHandle, GPUTextureHandle, GPUSamplerHandle>;
+    struct GPUBindGroupEntry
+    {
+        u32 binding = UINT32_MAX;
+        /// @brief A buffer, texture view or sampler, matching the type its layout declares for the binding
+        Handle resource;
+        u64 offset = 0;
+        /// @brief Bytes of a buffer visible to shaders, u64Max covers the rest of the buffer
+        u64 size = u64Max;
+    };
 
     struct GPUBindGroupDesc
     {
         GPUBindGroupLayoutHandle layout;
         std::vector<GPUBindGroupEntry> entries;
+        /// @brief Only lives for the frame being recorded, its descriptors are reclaimed in bulk with the frame
+        bool transient = false;
+        u32 nextImplicitBinding = 0;
 
-        GPUBindGroupDesc& Entry(GPUBindGroupEntry entry)
+        GPUBindGroupDesc& Entry(Handle resource, u32 binding = UINT32_MAX, u64 offset = 0, u64 size = u64Max)
         {
-            entries.push_back(entry);
+            u32 actualBinding = (binding == UINT32_MAX) ? nextImplicitBinding : binding;
+            entries.push_back({actualBinding, resource, offset, size});
+            nextImplicitBinding = std::max(nextImplicitBinding, actualBinding + 1);
             return *this;
         }
     };
 
+    struct GFXPushConstantRange
+    {
+        GPUShaderStage visibility;
+        u32 offset;
+        u32 size;
+    };
+
     struct GFXPipelineLayoutDesc
     {
         std::vector<GPUBindGroupLayoutHandle> groupLayouts;
+        std::vector<GFXPushConstantRange> pushConstantRanges;
+        u32 nextImplicitPushConstantOffset = 0;
 
         GFXPipelineLayoutDesc& BindGroup(GPUBindGroupLayoutHandle groupLayout)
         {
             groupLayouts.push_back(groupLayout);
             return *this;
         }
+
+        GFXPipelineLayoutDesc& PushConstant(GPUShaderStage visibility, u32 size, u32 offset = UINT32_MAX)
+        {
+            u32 actualOffset = (offset == UINT32_MAX) ? nextImplicitPushConstantOffset : offset;
+            pushConstantRanges.push_back({.visibility = visibility, .offset = actualOffset, .size = size});
+            nextImplicitPushConstantOffset = std::max(nextImplicitPushConstantOffset, actualOffset + size);
+            return *this;
+        }
     };
 
     struct GFXPipelineVertexAttribute
@@ -191,6 +229,7 @@ namespace Cocoa::Graphics {
 
     struct GPUTextureViewDesc
     {
+        GPUTextureHandle texture;
         GPUTextureViewType type = GPUTextureViewType::TwoDimensional;
         std::variant<GPUColorFormat, GPUDepthStencilFormat> format;
         GPUTextureAspect aspect = GPUTextureAspect::Color;
@@ -200,9 +239,20 @@ namespace Cocoa::Graphics {
         u32 layers = 1;
     };
 
+    struct GPUTextureUpload
+    {
+        GPUBufferHandle srcBuffer;
+        GPUTextureHandle dstTexture;
+        u64 bufferOffset = 0;
+        u32 level = 0;
+        u32 layer = 0;
+    };
+
     struct GFXShaderModuleDesc
     {
         std::string shaderPath;
+        /// @brief SPIR-V already in memory, e.g. mapped from an archive, the file at shaderPath is only read without it
+        std::span<const u8> code;
     };
 
     struct GPUSamplerDesc
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 namespace Cocoa::Graphics {
     enum class GPUPowerPreference
     {
@@ -65,10 +67,30 @@ namespace Cocoa::Graphics {
     {
         Unknown = 0,
         BGRA8_SRGB,
+        R32_Float,
         RG32_Float,
         RGB32_Float,
         RGBA32_Float,
-        RGBA8_Unorm
+        RGBA8_Unorm,
+        RGBA8_SRGB,
+        RG16_Float,
+        RGBA16_Float,
+        RG16_Snorm,
+        RGBA16_Snorm,
+        BC1_Unorm,
+        BC1_SRGB,
+        BC3_Unorm,
+        BC3_SRGB,
+        BC4_Unorm,
+        BC5_Unorm,
+        BC7_Unorm,
+        BC7_SRGB
+    };
+
+    enum class GPUIndexFormat
+    {
+        Uint16,
+        Uint32
     };
 
     enum class GPUDepthStencilFormat
@@ -66,12 +66,12 @@ namespace Cocoa::Graphics {
     {
         None = 0,
         Count1 = 1 << 0,
-        Count2 = 2 << 0,
-        Count4 = 4 << 0,
-        Count8 = 8 << 0,
-        Count16 = 1 << 1,
-        Count32 = 2 << 1,
-        Count64 = 4 << 1
+        Count2 = 1 << 1,
+        Count4 = 1 << 2,
+        Count8 = 1 << 3,
+        Count16 = 1 << 4,
+        Count32 = 1 << 5,
+        Count64 = 1 << 6
     };
 
     inline bool operator&(GPUSamplingCount a, GPUSamplingCount b)
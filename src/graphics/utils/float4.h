@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "../../common.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define COCOA_FLOAT4_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define COCOA_FLOAT4_NEON
+#endif
+
+namespace Cocoa::Graphics {
+    /// @brief Four floats in one SIMD register, used for per-texel RGBA math in the CPU texture tools
+    struct Float4
+    {
+#if defined(COCOA_FLOAT4_SSE2)
+        __m128 v;
+
+        static Float4 Load(const f32* p) { return {_mm_loadu_ps(p)}; }
+        static Float4 Splat(const f32 value) { return {_mm_set1_ps(value)}; }
+        void Store(f32* p) const { _mm_storeu_ps(p, v); }
+        Float4 operator+(const Float4& other) const { return {_mm_add_ps(v, other.v)}; }
+        Float4 operator-(const Float4& other) const { return {_mm_sub_ps(v, other.v)}; }
+        Float4 operator*(const Float4& other) const { return {_mm_mul_ps(v, other.v)}; }
+        Float4 Min(const Float4& other) const { return {_mm_min_ps(v, other.v)}; }
+        Float4 Max(const Float4& other) const { return {_mm_max_ps(v, other.v)}; }
+#elif defined(COCOA_FLOAT4_NEON)
+        float32x4_t v;
+
+        static Float4 Load(const f32* p) { return {vld1q_f32(p)}; }
+        static Float4 Splat(const f32 value) { return {vdupq_n_f32(value)}; }
+        void Store(f32* p) const { vst1q_f32(p, v); }
+        Float4 operator+(const Float4& other) const { return {vaddq_f32(v, other.v)}; }
+        Float4 operator-(const Float4& other) const { return {vsubq_f32(v, other.v)}; }
+        Float4 operator*(const Float4& other) const { return {vmulq_f32(v, other.v)}; }
+        Float4 Min(const Float4& other) const { return {vminq_f32(v, other.v)}; }
+        Float4 Max(const Float4& other) const { return {vmaxq_f32(v, other.v)}; }
+#else
+        std::array<f32, 4> v;
+
+        static Float4 Load(const f32* p) { return {{p[0], p[1], p[2], p[3]}}; }
+        static Float4 Splat(const f32 value) { return {{value, value, value, value}}; }
+        void Store(f32* p) const { std::copy(v.begin(), v.end(), p); }
+        Float4 operator+(const Float4& other) const { return Apply(other, [](f32 a, f32 b) { return a + b; }); }
+        Float4 operator-(const Float4& other) const { return Apply(other, [](f32 a, f32 b) { return a - b; }); }
+        Float4 operator*(const Float4& other) const { return Apply(other, [](f32 a, f32 b) { return a * b; }); }
+        Float4 Min(const Float4& other) const { return Apply(other, [](f32 a, f32 b) { return std::min(a, b); }); }
+        Float4 Max(const Float4& other) const { return Apply(other, [](f32 a, f32 b) { return std::max(a, b); }); }
+
+        template <typename F> Float4 Apply(const Float4& other, F&& function) const
+        {
+            return {{function(v[0], other.v[0]), function(v[1], other.v[1]), function(v[2], other.v[2]),
+                     function(v[3], other.v[3])}};
+        }
+#endif
+
+        static Float4 Set(const f32 x, const f32 y, const f32 z, const f32 w)
+        {
+            const f32 values[4] = {x, y, z, w};
+            return Load(values);
+        }
+
+        Float4 Saturate() const { return Max(Splat(0.0f)).Min(Splat(1.0f)); }
+
+        [[nodiscard]] f32 Dot(const Float4& other) const
+        {
+            alignas(16) f32 products[4];
+            (*this * other).Store(products);
+            return (products[0] + products[1]) + (products[2] + products[3]);
+        }
+
+        [[nodiscard]] std::array<f32, 4> ToArray() const
+        {
+            alignas(16) std::array<f32, 4> values;
+            Store(values.data());
+            return values;
+        }
+    };
+} // namespace Cocoa::Graphics
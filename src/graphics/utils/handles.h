@@ -13,4 +13,5 @@ namespace Cocoa::Graphics {
     using GFXRenderPipelineHandle = Handle;
     using GFXPipelineLayoutHandle = Handle;
     using GFXShaderModuleHandle = Handle;
+    using GPUMemoryHeapHandle = Handle;
 } // namespace Cocoa::Graphics
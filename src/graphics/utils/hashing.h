@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+#include "descriptors.h"
+
+namespace Cocoa::Graphics {
+    inline void HashCombine(usize& seed, const usize value)
+    {
+        seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+
+    template <typename T> void HashValue(usize& seed, const T& value) { HashCombine(seed, std::hash<T>{}(value)); }
+
+    // Builder bookkeeping such as nextImplicitBinding is not part of the state, so descriptions
+    // are compared and hashed by hand instead of with defaulted operators
+
+    inline bool operator==(const GPUBindGroupLayoutEntry& a, const GPUBindGroupLayoutEntry& b)
+    {
+        return a.binding == b.binding && a.visibility == b.visibility && a.type == b.type;
+    }
+
+    inline bool operator==(const GFXPushConstantRange& a, const GFXPushConstantRange& b)
+    {
+        return a.visibility == b.visibility && a.offset == b.offset && a.size == b.size;
+    }
+
+    inline bool operator==(const GFXPipelineVertexAttribute& a, const GFXPipelineVertexAttribute& b)
+    {
+        return a.format == b.format && a.offset == b.offset;
+    }
+
+    inline bool operator==(const GFXPipelineVertexBinding& a, const GFXPipelineVertexBinding& b)
+    {
+        return a.binding == b.binding && a.stride == b.stride && a.attributes == b.attributes;
+    }
+
+    inline bool operator==(const GFXPipelineStencilOpState& a, const GFXPipelineStencilOpState& b)
+    {
+        return a.failOp == b.failOp && a.passOp == b.passOp && a.depthFailOp == b.depthFailOp &&
+               a.compareOp == b.compareOp && a.compareMask == b.compareMask && a.writeMask == b.writeMask &&
+               a.reference == b.reference;
+    }
+
+    /// @brief Entries sorted by binding, type and visibility, so the order they were declared in doesn't matter
+    /// @note Every field takes part, entries sharing a binding would otherwise keep their declared order
+    inline std::vector<GPUBindGroupLayoutEntry> GetCanonicalEntries(const GPUBindGroupLayoutDesc& desc)
+    {
+        auto entries = desc.entries;
+        std::ranges::sort(entries, [](const GPUBindGroupLayoutEntry& a, const GPUBindGroupLayoutEntry& b) {
+            return std::tie(a.binding, a.type, a.visibility) < std::tie(b.binding, b.type, b.visibility);
+        });
+        return entries;
+    }
+
+    /// @brief Ranges sorted by offset, size and visibility, so the order they were declared in doesn't matter
+    inline std::vector<GFXPushConstantRange> GetCanonicalRanges(const GFXPipelineLayoutDesc& desc)
+    {
+        auto ranges = desc.pushConstantRanges;
+        std::ranges::sort(ranges, [](const GFXPushConstantRange& a, const GFXPushConstantRange& b) {
+            return std::tie(a.offset, a.size, a.visibility) < std::tie(b.offset, b.size, b.visibility);
+        });
+        return ranges;
+    }
+
+    inline bool operator==(const GPUBindGroupLayoutDesc& a, const GPUBindGroupLayoutDesc& b)
+    {
+        return a.entries.size() == b.entries.size() && GetCanonicalEntries(a) == GetCanonicalEntries(b);
+    }
+
+    inline bool operator==(const GFXPipelineLayoutDesc& a, const GFXPipelineLayoutDesc& b)
+    {
+        return a.groupLayouts == b.groupLayouts && a.pushConstantRanges.size() == b.pushConstantRanges.size() &&
+               GetCanonicalRanges(a) == GetCanonicalRanges(b);
+    }
+
+    inline bool operator==(const GFXPipelineDesc& a, const GFXPipelineDesc& b)
+    {
+        return a.shaders == b.shaders && a.vertexLayout == b.vertexLayout && a.topology == b.topology &&
+               a.cullMode == b.cullMode && a.polygonMode == b.polygonMode && a.frontFace == b.frontFace &&
+               a.depthTest == b.depthTest && a.depthWrite == b.depthWrite && a.depthCompareOp == b.depthCompareOp &&
+               a.stencilTest == b.stencilTest && a.stencilFrontFace == b.stencilFrontFace &&
+               a.stencilBackFace == b.stencilBackFace && a.colorFormat == b.colorFormat &&
+               a.depthStencilFormat == b.depthStencilFormat && a.pipelineLayout == b.pipelineLayout;
+    }
+
+    inline bool operator==(const GPUSamplerDesc& a, const GPUSamplerDesc& b)
+    {
+        return a.magnification == b.magnification && a.minification == b.minification &&
+               a.mipmapMode == b.mipmapMode && a.horizontalWrapping == b.horizontalWrapping &&
+               a.verticalWrapping == b.verticalWrapping && a.depthWrapping == b.depthWrapping &&
+               a.minLevel == b.minLevel && a.maxLevel == b.maxLevel && a.levelBias == b.levelBias;
+    }
+} // namespace Cocoa::Graphics
+
+template <> struct std::hash<Cocoa::Graphics::GPUBindGroupLayoutDesc>
+{
+    usize operator()(const Cocoa::Graphics::GPUBindGroupLayoutDesc& desc) const noexcept
+    {
+        usize seed = desc.entries.size();
+        for (const auto& [binding, visibility, type] : Cocoa::Graphics::GetCanonicalEntries(desc)) {
+            Cocoa::Graphics::HashValue(seed, binding);
+            Cocoa::Graphics::HashValue(seed, visibility);
+            Cocoa::Graphics::HashValue(seed, type);
+        }
+        return seed;
+    }
+};
+
+template <> struct std::hash<Cocoa::Graphics::GFXPipelineLayoutDesc>
+{
+    usize operator()(const Cocoa::Graphics::GFXPipelineLayoutDesc& desc) const noexcept
+    {
+        usize seed = desc.groupLayouts.size();
+        for (const auto& groupLayout : desc.groupLayouts) {
+            Cocoa::Graphics::HashValue(seed, groupLayout.id);
+        }
+        for (const auto& [visibility, offset, size] : Cocoa::Graphics::GetCanonicalRanges(desc)) {
+            Cocoa::Graphics::HashValue(seed, visibility);
+            Cocoa::Graphics::HashValue(seed, offset);
+            Cocoa::Graphics::HashValue(seed, size);
+        }
+        return seed;
+    }
+};
+
+template <> struct std::hash<Cocoa::Graphics::GFXPipelineDesc>
+{
+    usize operator()(const Cocoa::Graphics::GFXPipelineDesc& desc) const noexcept
+    {
+        using Cocoa::Graphics::HashValue;
+
+        // unordered_map iteration order isn't stable between equal maps, so hash the shaders sorted by stage
+        std::vector<std::pair<u32, u64>> shaders;
+        shaders.reserve(desc.shaders.size());
+        for (const auto& [stage, module] : desc.shaders) {
+            shaders.emplace_back(static_cast<u32>(stage), module.id);
+        }
+        std::ranges::sort(shaders);
+
+        usize seed = shaders.size();
+        for (const auto& [stage, module] : shaders) {
+            HashValue(seed, stage);
+            HashValue(seed, module);
+        }
+
+        for (const auto& [binding, stride, attributes] : desc.vertexLayout) {
+            HashValue(seed, binding);
+            HashValue(seed, stride);
+            for (const auto& [format, offset] : attributes) {
+                HashValue(seed, format);
+                HashValue(seed, offset);
+            }
+        }
+
+        HashValue(seed, desc.topology);
+        HashValue(seed, desc.cullMode);
+        HashValue(seed, desc.polygonMode);
+        HashValue(seed, desc.frontFace);
+        HashValue(seed, desc.depthTest);
+        HashValue(seed, desc.depthWrite);
+        HashValue(seed, desc.depthCompareOp);
+        HashValue(seed, desc.stencilTest);
+        for (const auto& stencil : {desc.stencilFrontFace, desc.stencilBackFace}) {
+            HashValue(seed, stencil.failOp);
+            HashValue(seed, stencil.passOp);
+            HashValue(seed, stencil.depthFailOp);
+            HashValue(seed, stencil.compareOp);
+            HashValue(seed, stencil.compareMask);
+            HashValue(seed, stencil.writeMask);
+            HashValue(seed, stencil.reference);
+        }
+        HashValue(seed, desc.colorFormat);
+        HashValue(seed, desc.depthStencilFormat);
+        HashValue(seed, desc.pipelineLayout.id);
+        return seed;
+    }
+};
+
+template <> struct std::hash<Cocoa::Graphics::GPUSamplerDesc>
+{
+    usize operator()(const Cocoa::Graphics::GPUSamplerDesc& desc) const noexcept
+    {
+        using Cocoa::Graphics::HashValue;
+
+        usize seed = 0;
+        HashValue(seed, desc.magnification);
+        HashValue(seed, desc.minification);
+        HashValue(seed, desc.mipmapMode);
+        HashValue(seed, desc.horizontalWrapping);
+        HashValue(seed, desc.verticalWrapping);
+        HashValue(seed, desc.depthWrapping);
+        HashValue(seed, desc.minLevel);
+        HashValue(seed, desc.maxLevel);
+        HashValue(seed, desc.levelBias);
+        return seed;
+    }
+};
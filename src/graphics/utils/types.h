@@ -5,15 +5,28 @@
 
 #include "../../common.h"
 #include "../../math/matrix4x4.h"
+#include "enums.h"
 
 namespace Cocoa::Graphics {
-    struct MVP
+    /// @brief Per-frame camera data, stored in a uniform buffer at set 0
+    struct FrameConstants
     {
-        Math::Matrix4x4 model;
         Math::Matrix4x4 view;
         Math::Matrix4x4 projection;
     };
 
+    /// @brief Per-draw data, sent with push constants so objects never touch descriptor sets
+    /// @note indices.x is the object index and indices.y the texture index. With bindless enabled indices.z
+    /// is the sampler index and indices.w the storage buffer holding the frame constants
+    struct DrawConstants
+    {
+        Math::Matrix4x4 model;
+        std::array<u32, 4> indices = {0, 0, 0, 0};
+    };
+
+    // Vulkan only guarantees 128 bytes of push constant space
+    static_assert(sizeof(DrawConstants) <= 128);
+
     struct Vertex
     {
         std::array<f32, 3> pos;
@@ -21,10 +34,58 @@ namespace Cocoa::Graphics {
         std::array<f32, 2> uv;
     };
 
+    /// @brief A run of MeshData::indices drawing the mesh at one level of detail
+    struct MeshLOD
+    {
+        u32 firstIndex = 0;
+        u32 indexCount = 0;
+        /// @brief How far, in mesh units, this LOD's surface may be from the full detail one
+        f32 error = 0;
+    };
+
     struct MeshData
     {
         std::vector<Vertex> vertices;
-        std::vector<uint16_t> indices;
+        std::vector<u32> indices;
+        /// @brief Format the indices are uploaded in, OptimizeMesh promotes it when 16 bits can't address every vertex
+        GPUIndexFormat indexFormat = GPUIndexFormat::Uint16;
+        /// @brief Empty, or every LOD from full detail down, each one's indices stored after the previous one's
+        std::vector<MeshLOD> lods;
+    };
+
+    /// @brief Quantized vertex, 20 bytes instead of Vertex's 36
+    /// @note pos is snorm16 relative to the mesh bounds (w is unused), normal is octahedral snorm16,
+    /// col is unorm8 and uv is half float
+    struct PackedVertex
+    {
+        std::array<int16_t, 4> pos;
+        std::array<int16_t, 2> normal;
+        std::array<uint8_t, 4> col;
+        std::array<uint16_t, 2> uv;
+    };
+
+    static_assert(sizeof(PackedVertex) == 20);
+
+    struct PackedMeshData
+    {
+        std::vector<PackedVertex> vertices;
+        std::vector<u32> indices;
+        GPUIndexFormat indexFormat = GPUIndexFormat::Uint16;
+        std::vector<MeshLOD> lods;
+        /// @brief Center and half size of the mesh bounds, positions are stored relative to these
+        std::array<f32, 3> positionCenter = {0, 0, 0};
+        std::array<f32, 3> positionExtent = {1, 1, 1};
+
+        /// @brief Maps the packed [-1, 1] positions back to mesh space, meant to be multiplied into the model matrix
+        [[nodiscard]] Math::Matrix4x4 GetDequantizeTransform() const
+        {
+            Math::Matrix4x4 transform;
+            for (int i = 0; i < 3; i++) {
+                transform(i, i) = positionExtent[i];
+                transform(i, 3) = positionCenter[i];
+            }
+            return transform;
+        }
     };
 
     struct Offset
@@ -58,4 +119,96 @@ namespace Cocoa::Graphics {
     };
 
     using RenderArea = Rect;
+
+    /// @brief Size and placement rules for a resource that is bound into shared memory
+    struct GPUMemoryRequirements
+    {
+        u64 size = 0;
+        u64 alignment = 1;
+        u32 memoryTypeBits = u32Max;
+    };
+
+    struct GPUMemoryHeapStats
+    {
+        /// @brief How much of the heap this process can use before the OS starts evicting, an estimate
+        u64 budget = 0;
+        /// @brief How much of the heap this process currently uses, including other APIs and drivers
+        u64 usage = 0;
+        /// @brief Bytes in live allocations
+        u64 allocatedBytes = 0;
+        /// @brief Bytes in VkDeviceMemory blocks, the gap to allocatedBytes is free space inside blocks
+        u64 blockBytes = 0;
+        u32 allocations = 0;
+        u32 blocks = 0;
+        bool deviceLocal = false;
+    };
+
+    struct GPUMemoryStats
+    {
+        std::vector<GPUMemoryHeapStats> heaps;
+        u64 allocatedBytes = 0;
+        u64 blockBytes = 0;
+        u32 allocations = 0;
+        u32 blocks = 0;
+        /// @brief Whether budget and usage come from VK_EXT_memory_budget rather than an estimate
+        bool budgetExact = false;
+        bool defragmenting = false;
+        u32 defragmentationMoves = 0;
+        u64 defragmentationBytesMoved = 0;
+    };
+
+    /// @brief Selects a block of mip levels and array layers in a texture
+    /// @note A count of u32Max covers everything from the first level/layer to the end of the texture
+    struct GPUTextureSubresourceRange
+    {
+        u32 firstLevel = 0;
+        u32 levels = u32Max;
+        u32 firstLayer = 0;
+        u32 layers = u32Max;
+    };
+
+    /// @brief Size of the smallest unit a color format stores, a single texel for uncompressed formats
+    struct GPUColorFormatBlock
+    {
+        u32 width = 1;
+        u32 height = 1;
+        u32 bytes = 0;
+    };
+
+    inline GPUColorFormatBlock GetColorFormatBlock(const GPUColorFormat format)
+    {
+        switch (format) {
+        case GPUColorFormat::BGRA8_SRGB:
+        case GPUColorFormat::R32_Float:
+        case GPUColorFormat::RGBA8_Unorm:
+        case GPUColorFormat::RGBA8_SRGB:
+        case GPUColorFormat::RG16_Float:
+        case GPUColorFormat::RG16_Snorm:   return {1, 1, 4};
+        case GPUColorFormat::RG32_Float:
+        case GPUColorFormat::RGBA16_Float:
+        case GPUColorFormat::RGBA16_Snorm: return {1, 1, 8};
+        case GPUColorFormat::RGB32_Float:  return {1, 1, 12};
+        case GPUColorFormat::RGBA32_Float: return {1, 1, 16};
+        case GPUColorFormat::BC1_Unorm:
+        case GPUColorFormat::BC1_SRGB:
+        case GPUColorFormat::BC4_Unorm:    return {4, 4, 8};
+        case GPUColorFormat::BC3_Unorm:
+        case GPUColorFormat::BC3_SRGB:
+        case GPUColorFormat::BC5_Unorm:
+        case GPUColorFormat::BC7_Unorm:
+        case GPUColorFormat::BC7_SRGB:     return {4, 4, 16};
+        default:                           return {1, 1, 0};
+        }
+    }
+
+    inline bool IsBlockCompressedFormat(const GPUColorFormat format) { return GetColorFormatBlock(format).width > 1; }
+
+    /// @brief Bytes one tightly packed mip level takes, partial blocks at the edges count as whole blocks
+    inline u64 GetTextureLevelSize(const GPUColorFormat format, const u32 width, const u32 height)
+    {
+        const auto block = GetColorFormatBlock(format);
+        const u64 blocksWide = (width + block.width - 1) / block.width;
+        const u64 blocksHigh = (height + block.height - 1) / block.height;
+        return blocksWide * blocksHigh * block.bytes;
+    }
 } // namespace Cocoa::Graphics
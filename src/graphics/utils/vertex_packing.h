@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+#include "../../common.h"
+
+namespace Cocoa::Graphics {
+    /// @brief Converts to IEEE half precision, rounding to nearest even and clamping to infinity
+    inline uint16_t FloatToHalf(const f32 value)
+    {
+        const auto bits = std::bit_cast<uint32_t>(value);
+        const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        const uint32_t magnitude = bits & 0x7FFFFFFF;
+
+        // NaN stays NaN, anything too large for a half becomes infinity
+        if (magnitude > 0x7F800000)
+            return sign | 0x7E00;
+        if (magnitude >= 0x477FF000)
+            return sign | 0x7C00;
+
+        // Too small for a normal half, shift the mantissa into a subnormal
+        if (magnitude < 0x38800000) {
+            if (magnitude < 0x33000000)
+                return sign;
+            const uint32_t exponent = magnitude >> 23;
+            const uint32_t mantissa = (magnitude & 0x007FFFFF) | 0x00800000;
+            const uint32_t shift = 126 - exponent;
+            uint32_t half = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1))) {
+                half++;
+            }
+            return sign | static_cast<uint16_t>(half);
+        }
+
+        // Rebias the exponent and round the 13 bits that get dropped
+        uint32_t half = (magnitude - 0x38000000) >> 13;
+        const uint32_t remainder = magnitude & 0x1FFF;
+        if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+            half++;
+        }
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    /// @param value Expected in [-1, 1], values outside are clamped
+    inline int16_t PackSnorm16(const f32 value)
+    {
+        return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    /// @param value Expected in [0, 1], values outside are clamped
+    inline uint8_t PackUnorm8(const f32 value)
+    {
+        return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    }
+
+    /// @brief Folds a unit vector onto an octahedron and unwraps it into a square, two snorm16 values in total
+    /// @note shaders/packed.vert has the matching decode
+    inline std::array<int16_t, 2> PackOctahedral(const std::array<f32, 3>& normal)
+    {
+        const f32 length = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+        if (length == 0.0f)
+            return {0, 0};
+
+        f32 x = normal[0] / length;
+        f32 y = normal[1] / length;
+        if (normal[2] < 0.0f) {
+            const f32 foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const f32 foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldedX;
+            y = foldedY;
+        }
+        return {PackSnorm16(x), PackSnorm16(y)};
+    }
+} // namespace Cocoa::Graphics
@@ -4,8 +4,10 @@
 
 #include <SDL3/SDL.h>
 
-#include "graphics/core/render_device.h"
+#include "graphics/core/render_graph.h"
+#include "tools/job_system.h"
 #include "tools/rich_presence.h"
+#include "vulkan/core/render_device_impl.h"
 
 #include "macros.h"
 
@@ -19,6 +21,16 @@ int main()
 
     SDL_Window* window = SDL_CreateWindow("Cocoa", 800, 600, SDL_WINDOW_RESIZABLE);
 
+    // Shared by every system that splits work across cores, jobs touching SDL go through RunOnMainThread
+    Cocoa::Tools::JobSystem jobs;
+
+    Cocoa::Vulkan::RenderDeviceImpl device({
+        .window = window,
+        .desiredQueues = {Cocoa::Graphics::GPUQueueType::Graphics},
+    });
+    // Every frame is declared as a render graph, which owns the frame's transient targets
+    auto graph = std::make_unique<Cocoa::Graphics::RenderGraph>(device);
+
     // Rich presence (for fun)
     const Cocoa::Tools::RichPresenceDesc rpcDescriptor = {.appID = "1444737693090316409"};
     Cocoa::Tools::RichPresence rpc(rpcDescriptor);
@@ -35,10 +47,49 @@ int main()
             }
         }
 
+        jobs.PumpMainThread();
+
+        int width = 0, height = 0;
+        SDL_GetWindowSizeInPixels(window, &width, &height);
+        if (width > 0 && height > 0) {
+            const Cocoa::Graphics::Scale scale = {static_cast<u32>(width), static_cast<u32>(height)};
+            const Cocoa::Graphics::GPUTextureDesc sceneColorDesc = {
+                .usage = Cocoa::Graphics::GPUTextureUsage::RenderTarget,
+                .access = Cocoa::Graphics::GPUMemoryAccess::GPUOnly,
+                .format = Cocoa::Graphics::GPUColorFormat::RGBA8_Unorm,
+                .scale = {scale.w, scale.h, 1},
+            };
+            Cocoa::Graphics::RenderGraphResource sceneColor = Cocoa::Graphics::InvalidRenderGraphResource;
+
+            // Windows don't have swapchains yet, so the scene is cleared offscreen and kept alive as a side effect
+            graph->AddPass(
+                "Scene",
+                [&](Cocoa::Graphics::RenderGraphBuilder& builder) {
+                    sceneColor = builder.Write(builder.CreateTexture("SceneColor", sceneColorDesc));
+                    builder.SideEffect();
+                },
+                [&](Cocoa::Graphics::RenderGraph& frameGraph, Cocoa::Graphics::RenderEncoder* encoder) {
+                    encoder->StartRenderPass({
+                        .colorPasses = {{.view = &frameGraph.GetTextureView(sceneColor)}},
+                        .renderArea = {.offset = {0, 0}, .scale = scale},
+                    });
+                    encoder->EndRenderPass();
+                }
+            );
+
+            auto encoder = device.Encode({});
+            graph->Execute(encoder.get());
+            device.EndEncoding(std::move(encoder));
+            graph->Reset();
+        }
+
         // Update RPC
         rpc.Update();
     }
 
+    device.WaitForIdle();
+    graph.reset();
+
     SDL_Quit();
     return 0;
 }
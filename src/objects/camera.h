@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+
 #include "../math/common.h"
 #include "transform.h"
 
@@ -26,6 +29,14 @@ namespace Cocoa::Objects {
                                 Math::Vector3(0, 1, 0));
         }
 
+        /// @brief How many pixels across a sphere appears on screen, used to pick how much detail it needs
+        /// @param viewportHeight Height of the viewport in pixels
+        [[nodiscard]] float GetProjectedSize(const Math::Vector3& center, float radius, float viewportHeight)
+        {
+            const float distance = std::max((center - _transform.GetPosition()).Length() - radius, 1e-3f);
+            return 2.0f * radius * viewportHeight / (2.0f * std::tan(_fov * 0.5f) * distance);
+        }
+
         [[nodiscard]] Math::Matrix4x4 GetProjectionMatrix() const
         {
             return Math::CreatePerspectiveMatrix(_fov, _aspect, _near, _far);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "../graphics/utils/types.h"
+#include "camera.h"
+
+namespace Cocoa::Objects {
+    /// @brief Picks which LOD of a mesh to draw from how large its simplification error would look on screen
+    class LODGroup
+    {
+      public:
+        LODGroup() = default;
+        ~LODGroup() = default;
+
+        /// @param boundsRadius Radius of a sphere around the mesh origin holding every vertex
+        LODGroup(std::vector<Graphics::MeshLOD> lods, float boundsRadius)
+            : _lods(std::move(lods)), _boundsRadius(boundsRadius)
+        {
+        }
+
+        explicit LODGroup(const Graphics::MeshData& mesh) : _lods(mesh.lods)
+        {
+            for (const auto& vertex : mesh.vertices) {
+                const Math::Vector3 position(vertex.pos[0], vertex.pos[1], vertex.pos[2]);
+                _boundsRadius = std::max(_boundsRadius, position.Length());
+            }
+        }
+
+        /// @brief How many pixels of error are acceptable before a finer LOD is used
+        void SetPixelError(float pixelError) { _pixelError = pixelError; }
+
+        /// @brief Fraction the error has to drop below the threshold before moving to a coarser LOD, stops popping
+        /// when the object sits right at a switch distance
+        void SetHysteresis(float hysteresis) { _hysteresis = hysteresis; }
+
+        /// @brief Updates and returns the current LOD for the object seen from the camera
+        /// @param viewportHeight Height of the viewport in pixels
+        uint32_t Select(Camera& camera, Transform& transform, float viewportHeight)
+        {
+            if (_lods.size() < 2)
+                return _current = 0;
+
+            const auto& scale = transform.GetScale();
+            const float maxScale = std::max({std::abs(scale.x), std::abs(scale.y), std::abs(scale.z)});
+
+            // Distance to the closest point of the bounds, the error is assumed to be there
+            const auto toObject = transform.GetPosition() - camera.GetTransform().GetPosition();
+            const float distance = std::max(toObject.Length() - _boundsRadius * maxScale, 1e-3f);
+            const float pixelsPerUnit = viewportHeight /
+                                        (2.0f * std::tan(Math::Radians(camera.GetFieldOfView()) * 0.5f)) * maxScale /
+                                        distance;
+
+            // Finer LODs are picked right away so detail never lags behind, coarser ones only with some margin
+            if (_lods[_current].error * pixelsPerUnit > _pixelError) {
+                _current = CoarsestWithin(pixelsPerUnit, _pixelError);
+            } else {
+                _current = std::max(_current, CoarsestWithin(pixelsPerUnit, _pixelError * (1.0f - _hysteresis)));
+            }
+            return _current;
+        }
+
+        [[nodiscard]] uint32_t GetCurrentLOD() const { return _current; }
+        [[nodiscard]] const Graphics::MeshLOD& GetLOD(uint32_t lod) const { return _lods[lod]; }
+        [[nodiscard]] const std::vector<Graphics::MeshLOD>& GetLODs() const { return _lods; }
+
+      private:
+        std::vector<Graphics::MeshLOD> _lods;
+        float _boundsRadius = 0;
+        float _pixelError = 1.0f;
+        float _hysteresis = 0.25f;
+        uint32_t _current = 0;
+
+        [[nodiscard]] uint32_t CoarsestWithin(float pixelsPerUnit, float pixelError) const
+        {
+            for (uint32_t i = static_cast<uint32_t>(_lods.size()); i-- > 1;) {
+                if (_lods[i].error * pixelsPerUnit <= pixelError)
+                    return i;
+            }
+            return 0;
+        }
+    };
+} // namespace Cocoa::Objects
@@ -0,0 +1,366 @@
+#include "archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#include <lz4.h>
+#include <lz4hc.h>
+#include <zstd.h>
+
+#include "../macros.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Cocoa::Tools {
+    namespace {
+        // Level 19 is slow to compress, but that happens once at build time and decoding speed doesn't depend on it
+        constexpr int ZstdLevel = 19;
+
+        u64 GetChunkCount(const ArchiveEntry& entry)
+        {
+            return entry.originalSize / entry.chunkSize + (entry.originalSize % entry.chunkSize != 0);
+        }
+
+        bool DecompressChunk(
+            const ArchiveCompression compression, const std::span<const u8> source, const std::span<u8> destination
+        )
+        {
+            // A chunk that didn't shrink is stored as is
+            if (source.size() == destination.size()) {
+                std::memcpy(destination.data(), source.data(), destination.size());
+                return true;
+            }
+
+            switch (compression) {
+            case ArchiveCompression::LZ4: {
+                const int size = LZ4_decompress_safe(
+                    reinterpret_cast<const char*>(source.data()), reinterpret_cast<char*>(destination.data()),
+                    static_cast<int>(source.size()), static_cast<int>(destination.size())
+                );
+                return size == static_cast<int>(destination.size());
+            }
+            case ArchiveCompression::Zstd: {
+                // A context per thread saves reallocating the decoder's window for every chunk
+                thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(
+                    ZSTD_createDCtx(), &ZSTD_freeDCtx
+                );
+                const usize size = ZSTD_decompressDCtx(
+                    context.get(), destination.data(), destination.size(), source.data(), source.size()
+                );
+                return !ZSTD_isError(size) && size == destination.size();
+            }
+            default: return false;
+            }
+        }
+
+        std::vector<u8> CompressChunk(const ArchiveCompression compression, const std::span<const u8> source)
+        {
+            std::vector<u8> compressed;
+            switch (compression) {
+            case ArchiveCompression::LZ4: {
+                compressed.resize(static_cast<usize>(LZ4_compressBound(static_cast<int>(source.size()))));
+                const int size = LZ4_compress_HC(
+                    reinterpret_cast<const char*>(source.data()), reinterpret_cast<char*>(compressed.data()),
+                    static_cast<int>(source.size()), static_cast<int>(compressed.size()), LZ4HC_CLEVEL_MAX
+                );
+                compressed.resize(static_cast<usize>(std::max(size, 0)));
+                break;
+            }
+            case ArchiveCompression::Zstd: {
+                compressed.resize(ZSTD_compressBound(source.size()));
+                const usize size =
+                    ZSTD_compress(compressed.data(), compressed.size(), source.data(), source.size(), ZstdLevel);
+                compressed.resize(ZSTD_isError(size) ? 0 : size);
+                break;
+            }
+            default: break;
+            }
+
+            if (compressed.empty() || compressed.size() >= source.size()) {
+                compressed.assign(source.begin(), source.end());
+            }
+            return compressed;
+        }
+    } // namespace
+
+    Archive::Archive(const std::filesystem::path& path)
+    {
+#ifdef _WIN32
+        _file = CreateFileW(
+            path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr
+        );
+        if (_file == INVALID_HANDLE_VALUE) {
+            _file = nullptr;
+            PANIC("Failed to open archive %s", path.string().c_str());
+        }
+        LARGE_INTEGER fileSize{};
+        GetFileSizeEx(_file, &fileSize);
+        _size = static_cast<usize>(fileSize.QuadPart);
+        _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping) {
+            _data = static_cast<const u8*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+#else
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            PANIC("Failed to open archive %s", path.string().c_str());
+        }
+        struct stat status{};
+        fstat(file, &status);
+        _size = static_cast<usize>(status.st_size);
+        if (_size > 0) {
+            void* mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+            _data = mapping == MAP_FAILED ? nullptr : static_cast<const u8*>(mapping);
+        }
+        // The mapping keeps the file alive on its own
+        close(file);
+#endif
+        if (!_data) {
+            Unmap();
+            PANIC("Failed to map archive %s", path.string().c_str());
+        }
+
+        ArchiveHeader header;
+        if (_size < sizeof(header)) {
+            Unmap();
+            PANIC("Archive %s is truncated", path.string().c_str());
+        }
+        std::memcpy(&header, _data, sizeof(header));
+        const u64 entriesSize = static_cast<u64>(header.entryCount) * sizeof(ArchiveEntry);
+        const bool valid = header.magic == ArchiveMagic && header.version == ArchiveVersion &&
+                           header.entriesOffset % alignof(ArchiveEntry) == 0 &&
+                           header.entriesOffset <= _size && entriesSize <= _size - header.entriesOffset &&
+                           header.namesOffset <= _size && header.namesSize <= _size - header.namesOffset;
+        if (!valid) {
+            Unmap();
+            PANIC("%s isn't a valid version %u archive", path.string().c_str(), ArchiveVersion);
+        }
+
+        // The writer aligns the table, so it's used in place rather than copied out
+        _entries = {reinterpret_cast<const ArchiveEntry*>(_data + header.entriesOffset), header.entryCount};
+        _names = {reinterpret_cast<const char*>(_data + header.namesOffset), header.namesSize};
+        // Offsets come from the file, so every check is written so that it can't wrap around
+        for (const auto& entry : _entries) {
+            const bool dataInside = entry.offset <= _size && entry.size <= _size - entry.offset;
+            const bool nameInside =
+                entry.nameOffset <= _names.size() && entry.nameLength <= _names.size() - entry.nameOffset;
+            if (!dataInside || !nameInside) {
+                Unmap();
+                PANIC("Archive %s has an entry outside of the file", path.string().c_str());
+            }
+            const bool compressed = entry.compression != ArchiveCompression::None;
+            if (compressed && (entry.chunkSize == 0 || GetChunkCount(entry) > entry.size / sizeof(u32))) {
+                Unmap();
+                PANIC("Archive %s has a compressed entry without a chunk table", path.string().c_str());
+            }
+            // Stored entries are read straight out of the mapping, their original size has to be the stored one
+            if (!compressed && entry.originalSize != entry.size) {
+                Unmap();
+                PANIC("Archive %s has an uncompressed entry with a mismatched size", path.string().c_str());
+            }
+        }
+    }
+
+    Archive::~Archive() { Unmap(); }
+
+    const ArchiveEntry* Archive::Find(const std::string_view name) const
+    {
+        const u64 hash = HashArchiveName(name);
+        auto [first, last] = std::ranges::equal_range(_entries, hash, {}, &ArchiveEntry::nameHash);
+
+        // Hashes can collide, the stored name settles it
+        for (; first != last; ++first) {
+            if (GetName(*first) == name)
+                return &*first;
+        }
+        return nullptr;
+    }
+
+    std::span<const u8> Archive::Map(const std::string_view name) const
+    {
+        const auto entry = Find(name);
+        if (!entry)
+            return {};
+        if (entry->compression != ArchiveCompression::None) {
+            PANIC("Tried to map %.*s, which is compressed", static_cast<int>(name.size()), name.data());
+        }
+        return GetStoredData(*entry);
+    }
+
+    bool Archive::Read(const ArchiveEntry& entry, const u64 offset, const std::span<u8> destination) const
+    {
+        if (offset > entry.originalSize || destination.size() > entry.originalSize - offset)
+            return false;
+
+        const auto stored = GetStoredData(entry);
+        if (entry.compression == ArchiveCompression::None) {
+            std::memcpy(destination.data(), stored.data() + offset, destination.size());
+            return true;
+        }
+
+        const u64 chunkCount = GetChunkCount(entry);
+        const u64 end = offset + destination.size();
+        thread_local std::vector<u8> chunk;
+        chunk.resize(entry.chunkSize);
+
+        // Chunk sizes are only stored individually, so the position of each is found by walking the table
+        u64 chunkOffset = chunkCount * sizeof(u32);
+        for (u64 index = 0; index < chunkCount && index * entry.chunkSize < end; index++) {
+            u32 storedSize = 0;
+            std::memcpy(&storedSize, stored.data() + index * sizeof(u32), sizeof(storedSize));
+            if (storedSize > stored.size() - chunkOffset)
+                return false;
+
+            const u64 chunkStart = index * entry.chunkSize;
+            const u64 chunkEnd = std::min(chunkStart + entry.chunkSize, entry.originalSize);
+            if (chunkEnd > offset) {
+                const auto decoded = std::span(chunk).first(static_cast<usize>(chunkEnd - chunkStart));
+                if (!DecompressChunk(entry.compression, stored.subspan(chunkOffset, storedSize), decoded))
+                    return false;
+
+                const u64 copyStart = std::max(chunkStart, offset);
+                const u64 copyEnd = std::min(chunkEnd, end);
+                std::memcpy(
+                    destination.data() + (copyStart - offset), decoded.data() + (copyStart - chunkStart),
+                    copyEnd - copyStart
+                );
+            }
+            chunkOffset += storedSize;
+        }
+        return true;
+    }
+
+    std::span<const u8> Archive::GetStoredData(const ArchiveEntry& entry) const
+    {
+        return {_data + entry.offset, static_cast<usize>(entry.size)};
+    }
+
+    std::string_view Archive::GetName(const ArchiveEntry& entry) const
+    {
+        return _names.substr(entry.nameOffset, entry.nameLength);
+    }
+
+    void Archive::Unmap()
+    {
+#ifdef _WIN32
+        if (_data) {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping) {
+            CloseHandle(_mapping);
+        }
+        if (_file) {
+            CloseHandle(_file);
+        }
+        _mapping = nullptr;
+        _file = nullptr;
+#else
+        if (_data) {
+            munmap(const_cast<u8*>(_data), _size);
+        }
+#endif
+        _data = nullptr;
+        _entries = {};
+        _names = {};
+    }
+
+    ArchiveWriter::ArchiveWriter(const u32 alignment) : _alignment(std::max(alignment, 16u)) {}
+
+    u64 ArchiveWriter::Add(std::string name, std::vector<u8> data, const ArchiveCompression compression)
+    {
+        const bool duplicate = std::ranges::any_of(_files, [&](const File& file) { return file.name == name; });
+        if (duplicate) {
+            PANIC("Archive already has a file named %s", name.c_str());
+        }
+
+        const u64 originalSize = data.size();
+        if (compression != ArchiveCompression::None && !data.empty()) {
+            const u64 chunkCount = (originalSize + ArchiveChunkSize - 1) / ArchiveChunkSize;
+            std::vector<u8> stored(chunkCount * sizeof(u32));
+            for (u64 index = 0; index < chunkCount; index++) {
+                const u64 start = index * ArchiveChunkSize;
+                const auto size = static_cast<usize>(std::min<u64>(ArchiveChunkSize, originalSize - start));
+                const auto source = std::span(data).subspan(static_cast<usize>(start), size);
+                const auto chunk = CompressChunk(compression, source);
+                const auto storedSize = static_cast<u32>(chunk.size());
+                std::memcpy(stored.data() + index * sizeof(u32), &storedSize, sizeof(storedSize));
+                stored.insert(stored.end(), chunk.begin(), chunk.end());
+            }
+            if (stored.size() < originalSize) {
+                _files.push_back({std::move(name), std::move(stored), compression, originalSize});
+                return _files.back().data.size();
+            }
+        }
+        _files.push_back({std::move(name), std::move(data), ArchiveCompression::None, originalSize});
+        return originalSize;
+    }
+
+    bool ArchiveWriter::Write(const std::filesystem::path& path) const
+    {
+        auto alignUp = [](const u64 value, const u64 alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        };
+
+        std::vector<ArchiveEntry> entries;
+        std::string names;
+        u64 offset = alignUp(sizeof(ArchiveHeader), _alignment);
+        for (const auto& file : _files) {
+            entries.push_back({
+                .nameHash = HashArchiveName(file.name),
+                .offset = offset,
+                .size = file.data.size(),
+                .originalSize = file.originalSize,
+                .nameOffset = static_cast<u32>(names.size()),
+                .nameLength = static_cast<u32>(file.name.size()),
+                .compression = file.compression,
+                .chunkSize = file.compression == ArchiveCompression::None ? 0 : ArchiveChunkSize,
+            });
+            names += file.name;
+            offset = alignUp(offset + file.data.size(), _alignment);
+        }
+
+        // Sorting by hash is what lets Find binary search, files stay in the order they were added
+        std::ranges::stable_sort(entries, {}, &ArchiveEntry::nameHash);
+
+        ArchiveHeader header;
+        header.entryCount = static_cast<u32>(entries.size());
+        header.alignment = _alignment;
+        header.entriesOffset = offset;
+        header.namesOffset = offset + entries.size() * sizeof(ArchiveEntry);
+        header.namesSize = names.size();
+
+        std::ofstream stream(path, std::ios::binary);
+        if (!stream)
+            return false;
+
+        const std::vector<char> padding(_alignment, 0);
+        auto padTo = [&](const u64 position) {
+            const auto current = static_cast<u64>(stream.tellp());
+            stream.write(padding.data(), static_cast<std::streamsize>(position - current));
+        };
+
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& file : _files) {
+            padTo(alignUp(static_cast<u64>(stream.tellp()), _alignment));
+            stream.write(
+                reinterpret_cast<const char*>(file.data.data()), static_cast<std::streamsize>(file.data.size())
+            );
+        }
+        padTo(header.entriesOffset);
+        const auto entriesSize = static_cast<std::streamsize>(entries.size() * sizeof(ArchiveEntry));
+        stream.write(reinterpret_cast<const char*>(entries.data()), entriesSize);
+        stream.write(names.data(), static_cast<std::streamsize>(names.size()));
+        return static_cast<bool>(stream);
+    }
+} // namespace Cocoa::Tools
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../common.h"
+
+namespace Cocoa::Tools {
+    /// @brief Codec of an entry, compressed entries are split into chunks that decompress independently
+    enum class ArchiveCompression : u32
+    {
+        None = 0,
+        /// @brief Fast to decode, a good fit for data needed on the critical path like shaders
+        LZ4 = 1,
+        /// @brief Smaller but slower to decode, a good fit for large textures and meshes
+        Zstd = 2
+    };
+
+    /// @brief Uncompressed bytes per chunk, small enough to stream and large enough to keep the ratio
+    constexpr u32 ArchiveChunkSize = 128 * 1024;
+
+    constexpr u32 ArchiveMagic = 0x4B415043; // "CPAK"
+    /// @brief Bumped whenever the layout changes, version 2 added compressed entries
+    constexpr u32 ArchiveVersion = 2;
+
+    /// @brief Start of an archive file, the entry table and the names follow the file data at the end
+    struct ArchiveHeader
+    {
+        u32 magic = ArchiveMagic;
+        u32 version = ArchiveVersion;
+        u32 entryCount = 0;
+        /// @brief Every entry's data starts at a multiple of this, so it can be copied straight into staging memory
+        u32 alignment = 0;
+        u64 entriesOffset = 0;
+        u64 namesOffset = 0;
+        u64 namesSize = 0;
+    };
+
+    /// @brief One file in the archive, the table is sorted by name hash
+    /// @note Compressed data starts with a u32 stored size per chunk, a chunk stored at its full size isn't compressed
+    struct ArchiveEntry
+    {
+        u64 nameHash = 0;
+        u64 offset = 0;
+        /// @brief Bytes stored in the archive
+        u64 size = 0;
+        /// @brief Bytes once decompressed, the same as size for uncompressed entries
+        u64 originalSize = 0;
+        u32 nameOffset = 0;
+        u32 nameLength = 0;
+        ArchiveCompression compression = ArchiveCompression::None;
+        /// @brief Uncompressed bytes per chunk, unused for uncompressed entries
+        u32 chunkSize = 0;
+    };
+
+    static_assert(sizeof(ArchiveHeader) == 40 && sizeof(ArchiveEntry) == 48);
+
+    /// @brief 64-bit FNV-1a of a path using forward slashes, stable across platforms and builds
+    constexpr u64 HashArchiveName(const std::string_view name)
+    {
+        u64 hash = 0xcbf29ce484222325ull;
+        for (const char c : name) {
+            hash ^= static_cast<u8>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    /// @brief A packed archive mapped into memory for as long as the object lives
+    /// @note Lookups only touch the entry table, file data is paged in by the OS when it's first read
+    class Archive
+    {
+      public:
+        explicit Archive(const std::filesystem::path& path);
+        ~Archive();
+
+        Archive(const Archive&) = delete;
+        Archive& operator=(const Archive&) = delete;
+
+        /// @return nullptr when the archive has no file with this name
+        [[nodiscard]] const ArchiveEntry* Find(std::string_view name) const;
+
+        /// @brief The bytes of an uncompressed file, straight from the mapping
+        /// @return An empty span when the file is missing
+        [[nodiscard]] std::span<const u8> Map(std::string_view name) const;
+
+        /// @brief Copies part of a file into destination, decompressing it a chunk at a time
+        /// @note Chunks are decoded in a small cached buffer and then copied out, since decoders read back what they
+        /// wrote and destination is often write-combined staging memory. Only chunks covering the range are decoded.
+        /// @return False when the range is out of bounds or the data is corrupt
+        [[nodiscard]] bool Read(const ArchiveEntry& entry, u64 offset, std::span<u8> destination) const;
+
+        /// @brief The bytes of an entry exactly as stored, compressed or not
+        [[nodiscard]] std::span<const u8> GetStoredData(const ArchiveEntry& entry) const;
+
+        [[nodiscard]] std::string_view GetName(const ArchiveEntry& entry) const;
+        [[nodiscard]] std::span<const ArchiveEntry> GetEntries() const { return _entries; }
+
+      private:
+        const u8* _data = nullptr;
+        usize _size = 0;
+        std::span<const ArchiveEntry> _entries;
+        std::string_view _names;
+#ifdef _WIN32
+        void* _file = nullptr;
+        void* _mapping = nullptr;
+#endif
+
+        void Unmap();
+    };
+
+    /// @brief Collects files and writes them out as an archive, used by the packer at build time
+    class ArchiveWriter
+    {
+      public:
+        explicit ArchiveWriter(u32 alignment = 256);
+
+        /// @param name Path the file is looked up by, with forward slashes
+        /// @note Files that don't get smaller, e.g. PNGs, are stored uncompressed whatever the codec
+        /// @return The number of bytes the file takes up in the archive
+        u64 Add(std::string name, std::vector<u8> data, ArchiveCompression compression = ArchiveCompression::None);
+
+        bool Write(const std::filesystem::path& path) const;
+
+      private:
+        struct File
+        {
+            std::string name;
+            std::vector<u8> data;
+            ArchiveCompression compression;
+            u64 originalSize;
+        };
+
+        u32 _alignment;
+        std::vector<File> _files;
+    };
+} // namespace Cocoa::Tools
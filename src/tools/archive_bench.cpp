@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include "../vulkan/core/render_device_impl.h"
+#include "archive.h"
+
+using namespace Cocoa;
+
+namespace {
+    constexpr std::pair<std::string_view, Tools::ArchiveCompression> Codecs[] = {
+        {"none", Tools::ArchiveCompression::None},
+        {"lz4", Tools::ArchiveCompression::LZ4},
+        {"zstd", Tools::ArchiveCompression::Zstd},
+    };
+
+    int Usage()
+    {
+        fprintf(stderr, "Usage: CocoaArchiveBench <file>... [--rounds N]\n");
+        return 1;
+    }
+
+    bool ReadFile(const std::filesystem::path& path, std::vector<u8>& data)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+        data.resize(static_cast<usize>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file);
+    }
+} // namespace
+
+/// @brief Packs the given files once per codec and times reading every entry out of the archive into a mapped staging
+/// buffer, the same path the texture loader streams through
+/// @note The first round pays for paging the archive in, the best of the later rounds shows the codec itself
+int main(const int argc, char** argv)
+{
+    std::vector<std::filesystem::path> paths;
+    u32 rounds = 5;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--rounds" && i + 1 < argc) {
+            rounds = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument.starts_with("--")) {
+            return Usage();
+        } else {
+            paths.emplace_back(argument);
+        }
+    }
+    if (paths.empty() || rounds == 0)
+        return Usage();
+
+    std::vector<std::vector<u8>> files(paths.size());
+    u64 totalSize = 0;
+    u64 largestSize = 1;
+    for (usize i = 0; i < paths.size(); i++) {
+        if (!ReadFile(paths[i], files[i])) {
+            fprintf(stderr, "Failed to read %s\n", paths[i].string().c_str());
+            return 1;
+        }
+        totalSize += files[i].size();
+        largestSize = std::max<u64>(largestSize, files[i].size());
+    }
+
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        PANIC("Failed to start SDL3");
+    }
+    SDL_Window* window = SDL_CreateWindow("CocoaArchiveBench", 64, 64, SDL_WINDOW_HIDDEN | SDL_WINDOW_VULKAN);
+
+    {
+        Vulkan::RenderDeviceImpl device({
+            .window = window,
+            .desiredQueues = {Graphics::GPUQueueType::Graphics},
+            .pipelineCachePath = "",
+        });
+
+        auto staging = device.CreateBuffer({
+            .usage = Graphics::GPUBufferUsage::TransferSrc,
+            .access = Graphics::GPUMemoryAccess::CPUToGPU,
+            .size = largestSize,
+        });
+        auto* stagingData = static_cast<u8*>(device.GetBufferMappedData(staging));
+        if (!stagingData) {
+            PANIC("Staging buffer isn't host visible");
+        }
+
+        const auto archivePath = std::filesystem::temp_directory_path() / "CocoaArchiveBench.pak";
+        printf("%zu files, %.2f MB\n", files.size(), static_cast<double>(totalSize) / (1024.0 * 1024.0));
+        printf("codec    stored MB   ratio   first MB/s    best MB/s\n");
+        for (const auto& [codecName, compression] : Codecs) {
+            Tools::ArchiveWriter writer;
+            u64 storedSize = 0;
+            for (usize i = 0; i < files.size(); i++) {
+                storedSize += writer.Add(std::to_string(i), files[i], compression);
+            }
+            if (!writer.Write(archivePath)) {
+                PANIC("Failed to write %s", archivePath.string().c_str());
+            }
+
+            double firstSeconds = 0.0;
+            double bestSeconds = 0.0;
+            {
+                const Tools::Archive archive(archivePath);
+                for (u32 round = 0; round < rounds; round++) {
+                    const auto start = std::chrono::steady_clock::now();
+                    for (const auto& entry : archive.GetEntries()) {
+                        const auto destination = std::span(stagingData, static_cast<usize>(entry.originalSize));
+                        if (!archive.Read(entry, 0, destination)) {
+                            PANIC("Failed to read %s", std::string(archive.GetName(entry)).c_str());
+                        }
+                    }
+                    const double seconds =
+                        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    if (round == 0) {
+                        firstSeconds = seconds;
+                    }
+                    if (round == 1 || (round > 1 && seconds < bestSeconds)) {
+                        bestSeconds = seconds;
+                    }
+                }
+            }
+            std::filesystem::remove(archivePath);
+
+            const double megabytes = static_cast<double>(totalSize) / (1024.0 * 1024.0);
+            printf(
+                "%-5.*s %12.2f %7.2f %12.1f %12.1f\n", static_cast<int>(codecName.size()), codecName.data(),
+                static_cast<double>(storedSize) / (1024.0 * 1024.0),
+                totalSize ? static_cast<double>(storedSize) / static_cast<double>(totalSize) : 1.0,
+                megabytes / firstSeconds, rounds > 1 ? megabytes / bestSeconds : megabytes / firstSeconds
+            );
+        }
+
+        device.DestroyBuffer(staging);
+    }
+
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
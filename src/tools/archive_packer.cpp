@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <utility>
+
+#include "archive.h"
+
+using namespace Cocoa;
+
+namespace {
+    int Usage()
+    {
+        fprintf(
+            stderr, "Usage: CocoaArchivePacker <output.pak> [--compress <.extension|*>=<none|lz4|zstd>]... "
+                    "<prefix>=<directory>...\n"
+        );
+        return 1;
+    }
+
+    constexpr std::pair<std::string_view, Tools::ArchiveCompression> Codecs[] = {
+        {"none", Tools::ArchiveCompression::None},
+        {"lz4", Tools::ArchiveCompression::LZ4},
+        {"zstd", Tools::ArchiveCompression::Zstd},
+    };
+
+    struct CompressionRule
+    {
+        std::string extension;
+        Tools::ArchiveCompression compression;
+    };
+
+    Tools::ArchiveCompression PickCompression(const std::vector<CompressionRule>& rules, const std::string& extension)
+    {
+        // An exact extension wins over the wildcard, whatever order they were given in
+        auto compression = Tools::ArchiveCompression::None;
+        for (const auto& rule : rules) {
+            if (rule.extension == extension)
+                return rule.compression;
+            if (rule.extension == "*") {
+                compression = rule.compression;
+            }
+        }
+        return compression;
+    }
+
+    bool ReadFile(const std::filesystem::path& path, std::vector<u8>& data)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+        data.resize(static_cast<usize>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file);
+    }
+} // namespace
+
+/// @brief Packs directories into a single archive, each file is named "<prefix>/<path relative to the directory>"
+/// @note Compression is picked per extension so each asset type can use the codec that suits it
+int main(const int argc, char** argv)
+{
+    if (argc < 3)
+        return Usage();
+
+    Tools::ArchiveWriter writer;
+    std::vector<CompressionRule> rules;
+    u64 totalSize = 0, storedSize = 0;
+    usize fileCount = 0;
+    for (int i = 2; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--compress" && i + 1 < argc) {
+            const std::string_view rule = argv[++i];
+            const auto separator = rule.find('=');
+            if (separator == std::string_view::npos)
+                return Usage();
+            const auto codec = std::ranges::find_if(Codecs, [&](const auto& entry) {
+                return entry.first == rule.substr(separator + 1);
+            });
+            if (codec == std::end(Codecs))
+                return Usage();
+            rules.push_back({std::string(rule.substr(0, separator)), codec->second});
+            continue;
+        }
+
+        const auto separator = argument.find('=');
+        if (separator == std::string_view::npos)
+            return Usage();
+        const std::string prefix(argument.substr(0, separator));
+        const std::filesystem::path directory(argument.substr(separator + 1));
+
+        std::error_code error;
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+            if (entry.is_regular_file()) {
+                paths.push_back(entry.path());
+            }
+        }
+        if (error) {
+            fprintf(stderr, "Failed to list %s: %s\n", directory.string().c_str(), error.message().c_str());
+            return 1;
+        }
+
+        // Directory iteration order isn't specified, sorting keeps the output identical between builds
+        std::ranges::sort(paths);
+        for (const auto& path : paths) {
+            std::vector<u8> data;
+            if (!ReadFile(path, data)) {
+                fprintf(stderr, "Failed to read %s\n", path.string().c_str());
+                return 1;
+            }
+            totalSize += data.size();
+            fileCount++;
+            const auto compression = PickCompression(rules, path.extension().string());
+            storedSize += writer.Add(
+                prefix + "/" + path.lexically_relative(directory).generic_string(), std::move(data), compression
+            );
+        }
+    }
+
+    if (!writer.Write(argv[1])) {
+        fprintf(stderr, "Failed to write %s\n", argv[1]);
+        return 1;
+    }
+    printf(
+        "%s: %zu files, %llu bytes stored as %llu\n", argv[1], fileCount, static_cast<unsigned long long>(totalSize),
+        static_cast<unsigned long long>(storedSize)
+    );
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include "../vulkan/core/render_device_impl.h"
+
+using namespace Cocoa;
+
+namespace {
+    int Usage()
+    {
+        fprintf(stderr, "Usage: CocoaBindGroupBench [--groups N] [--frames N]\n");
+        return 1;
+    }
+
+    double NanosecondsSince(const std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /// @brief Submits an empty frame, which also flushes the descriptor writes queued so far
+    void SubmitFrame(Vulkan::RenderDeviceImpl& device)
+    {
+        auto encoder = device.Encode({});
+        device.EndEncoding(std::move(encoder));
+    }
+} // namespace
+
+/// @brief Times creating bind groups with a uniform buffer, a texture and a sampler, persistent and per frame, and
+/// updating existing ones
+/// @note Created groups write each binding of their layout once, so the device writes them through the layout's
+/// update template. Updates are timed that way and one binding per call, which queues a write per binding. Times
+/// include flushing the writes at the next Encode.
+int main(const int argc, char** argv)
+{
+    u32 groupCount = 10000;
+    u32 frameCount = 8;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--groups" && i + 1 < argc) {
+            groupCount = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--frames" && i + 1 < argc) {
+            frameCount = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            return Usage();
+        }
+    }
+    if (groupCount == 0 || frameCount == 0)
+        return Usage();
+
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        PANIC("Failed to start SDL3");
+    }
+    SDL_Window* window = SDL_CreateWindow("CocoaBindGroupBench", 64, 64, SDL_WINDOW_HIDDEN | SDL_WINDOW_VULKAN);
+
+    {
+        Vulkan::RenderDeviceImpl device({
+            .window = window,
+            .desiredQueues = {Graphics::GPUQueueType::Graphics},
+            .pipelineCachePath = "",
+        });
+
+        const auto visibility = Graphics::GPUShaderStage::Vertex | Graphics::GPUShaderStage::Pixel;
+        auto layout = device.CreateBindGroupLayout(
+            Graphics::GPUBindGroupLayoutDesc()
+                .Entry(visibility, Graphics::GPUBindGroupType::UniformBuffer)
+                .Entry(visibility, Graphics::GPUBindGroupType::Texture)
+                .Entry(visibility, Graphics::GPUBindGroupType::Sampler)
+        );
+
+        auto buffer = device.CreateBuffer({.usage = Graphics::GPUBufferUsage::Uniform, .size = 256});
+        auto texture = device.CreateTexture({
+            .usage = Graphics::GPUTextureUsage::ShaderUsage | Graphics::GPUTextureUsage::TransferDst,
+            .access = Graphics::GPUMemoryAccess::GPUOnly,
+            .format = Graphics::GPUColorFormat::RGBA8_Unorm,
+            .scale = {4, 4, 1},
+        });
+        auto view = device.CreateTextureView({.texture = texture, .format = Graphics::GPUColorFormat::RGBA8_Unorm});
+        auto sampler = device.CreateSampler({});
+
+        auto getDesc = [&](const bool transient) {
+            Graphics::GPUBindGroupDesc desc{.layout = layout, .transient = transient};
+            desc.Entry(buffer).Entry(view).Entry(sampler);
+            return desc;
+        };
+
+        // Persistent groups, the second round reuses the sets the first one released
+        std::vector<Graphics::GPUBindGroupHandle> groups(groupCount);
+        for (u32 round = 0; round < 2; round++) {
+            const auto desc = getDesc(false);
+            const auto start = std::chrono::steady_clock::now();
+            for (auto& group : groups) {
+                group = device.CreateBindGroup(desc);
+            }
+            SubmitFrame(device);
+            const double createNs = NanosecondsSince(start);
+
+            const auto destroyStart = std::chrono::steady_clock::now();
+            for (auto& group : groups) {
+                device.DestroyBindGroup(group);
+            }
+            const double destroyNs = NanosecondsSince(destroyStart);
+            printf(
+                "persistent round %u: %u groups  create %8.1f ns/group  destroy %6.1f ns/group\n", round + 1,
+                groupCount, createNs / groupCount, destroyNs / groupCount
+            );
+
+            // Released sets are only recycled once the frames that may use them are done
+            for (u32 i = 0; i < Vulkan::RenderDeviceImpl::FramesInFlight; i++) {
+                SubmitFrame(device);
+            }
+        }
+
+        // Updating existing groups, every binding through the update template or one binding per call through
+        // queued writes, alternating between two buffers so each update changes what the group points at
+        auto otherBuffer = device.CreateBuffer({.usage = Graphics::GPUBufferUsage::Uniform, .size = 256});
+        const Graphics::GPUBufferHandle buffers[] = {buffer, otherBuffer};
+        for (auto& group : groups) {
+            group = device.CreateBindGroup(getDesc(false));
+        }
+        SubmitFrame(device);
+        for (u32 round = 0; round < 2; round++) {
+            const auto wholeDesc = Graphics::GPUBindGroupDesc{.layout = layout}
+                                       .Entry(buffers[(round + 1) % 2], 0)
+                                       .Entry(view, 1)
+                                       .Entry(sampler, 2);
+            auto start = std::chrono::steady_clock::now();
+            for (auto& group : groups) {
+                device.UpdateBindGroup(group, wholeDesc);
+            }
+            SubmitFrame(device);
+            const double wholeNs = NanosecondsSince(start);
+
+            const Graphics::GPUBindGroupDesc bindingDescs[] = {
+                Graphics::GPUBindGroupDesc{.layout = layout}.Entry(buffers[round % 2], 0),
+                Graphics::GPUBindGroupDesc{.layout = layout}.Entry(view, 1),
+                Graphics::GPUBindGroupDesc{.layout = layout}.Entry(sampler, 2),
+            };
+            start = std::chrono::steady_clock::now();
+            for (auto& group : groups) {
+                for (const auto& bindingDesc : bindingDescs) {
+                    device.UpdateBindGroup(group, bindingDesc);
+                }
+            }
+            SubmitFrame(device);
+            const double bindingNs = NanosecondsSince(start);
+            printf(
+                "update round %u: %u groups  template %8.1f ns/group  per binding %8.1f ns/group\n", round + 1,
+                groupCount, wholeNs / groupCount, bindingNs / groupCount
+            );
+        }
+        for (auto& group : groups) {
+            device.DestroyBindGroup(group);
+        }
+
+        // Transient groups are reclaimed with their frame, later frames reuse the pools the first ones grew
+        double firstFrameNs = 0.0;
+        double laterFramesNs = 0.0;
+        const auto transientDesc = getDesc(true);
+        for (u32 frame = 0; frame < frameCount; frame++) {
+            const auto start = std::chrono::steady_clock::now();
+            for (u32 i = 0; i < groupCount; i++) {
+                device.CreateBindGroup(transientDesc);
+            }
+            SubmitFrame(device);
+            (frame == 0 ? firstFrameNs : laterFramesNs) += NanosecondsSince(start);
+        }
+        printf("transient first frame: %u groups  %8.1f ns/group\n", groupCount, firstFrameNs / groupCount);
+        if (frameCount > 1) {
+            printf(
+                "transient later frames: %u groups  %8.1f ns/group\n", groupCount,
+                laterFramesNs / (static_cast<double>(groupCount) * (frameCount - 1))
+            );
+        }
+
+        device.WaitForIdle();
+        device.DestroySampler(sampler);
+        device.DestroyTextureView(view);
+        device.DestroyTexture(texture);
+        device.DestroyBuffer(otherBuffer);
+        device.DestroyBuffer(buffer);
+        device.DestroyBindGroupLayout(layout);
+    }
+
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
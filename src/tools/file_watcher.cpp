@@ -0,0 +1,150 @@
+#include "file_watcher.h"
+
+#include "../macros.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Cocoa::Tools {
+    namespace {
+        constexpr auto PollInterval = std::chrono::milliseconds(100);
+    }
+
+    FileWatcher::FileWatcher(
+        const std::vector<std::filesystem::path>& directories, const std::chrono::milliseconds settleTime
+    )
+        : _settleTime(settleTime)
+    {
+        for (const auto& directory : directories) {
+            _directories.push_back(std::filesystem::weakly_canonical(directory));
+        }
+
+#ifdef __linux__
+        _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (_inotify < 0) {
+            PANIC("Failed to start watching files");
+        }
+        for (const auto& directory : _directories) {
+            AddWatches(directory);
+        }
+#else
+        Scan(false);
+#endif
+        _thread = std::thread(&FileWatcher::WatchLoop, this);
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        _stopping = true;
+        _thread.join();
+#ifdef __linux__
+        close(_inotify);
+#endif
+    }
+
+    std::vector<std::filesystem::path> FileWatcher::Poll()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        std::vector<std::filesystem::path> settled;
+
+        std::lock_guard lock(_mutex);
+        std::erase_if(_changed, [&](const auto& change) {
+            if (now - change.second < _settleTime)
+                return false;
+            settled.push_back(change.first);
+            return true;
+        });
+        return settled;
+    }
+
+    void FileWatcher::MarkChanged(const std::filesystem::path& path)
+    {
+        std::lock_guard lock(_mutex);
+        _changed[path] = std::chrono::steady_clock::now();
+    }
+
+#ifdef __linux__
+    void FileWatcher::AddWatches(const std::filesystem::path& directory)
+    {
+        // Editors usually save by writing a temporary file and renaming it over the original, hence MOVED_TO
+        constexpr u32 Mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+        const int watch = inotify_add_watch(_inotify, directory.c_str(), Mask);
+        if (watch < 0) {
+            PUSH_WARN("Failed to watch %s", directory.string().c_str());
+            return;
+        }
+        _watches[watch] = directory;
+
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            if (entry.is_directory()) {
+                AddWatches(entry.path());
+            }
+        }
+    }
+
+    void FileWatcher::WatchLoop()
+    {
+        alignas(inotify_event) char buffer[4096];
+        pollfd descriptor{.fd = _inotify, .events = POLLIN, .revents = 0};
+        while (!_stopping) {
+            if (poll(&descriptor, 1, static_cast<int>(PollInterval.count())) <= 0)
+                continue;
+
+            ssize_t length;
+            while ((length = read(_inotify, buffer, sizeof(buffer))) > 0) {
+                for (ssize_t offset = 0; offset < length;) {
+                    const auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                    const auto directory = _watches.find(event->wd);
+                    if (directory == _watches.end() || event->len == 0)
+                        continue;
+
+                    const auto path = directory->second / event->name;
+                    if (event->mask & IN_ISDIR) {
+                        if (event->mask & IN_CREATE) {
+                            AddWatches(path);
+                        }
+                    } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                        MarkChanged(path);
+                    }
+                }
+            }
+        }
+    }
+#else
+    void FileWatcher::Scan(const bool report)
+    {
+        for (const auto& directory : _directories) {
+            std::error_code error;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+                if (!entry.is_regular_file())
+                    continue;
+
+                const auto writeTime = entry.last_write_time(error);
+                auto [known, inserted] = _writeTimes.try_emplace(entry.path(), writeTime);
+                if (!inserted && known->second != writeTime) {
+                    known->second = writeTime;
+                    if (report) {
+                        MarkChanged(entry.path());
+                    }
+                } else if (inserted && report) {
+                    MarkChanged(entry.path());
+                }
+            }
+        }
+    }
+
+    void FileWatcher::WatchLoop()
+    {
+        while (!_stopping) {
+            std::this_thread::sleep_for(PollInterval * 2);
+            Scan(true);
+        }
+    }
+#endif
+} // namespace Cocoa::Tools
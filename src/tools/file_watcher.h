@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../common.h"
+
+namespace Cocoa::Tools {
+    /// @brief Watches directories on a background thread and reports files once they've been written
+    /// @note Uses inotify on Linux, other platforms fall back to comparing modification times a few times a second
+    class FileWatcher
+    {
+      public:
+        /// @param directories Watched recursively, directories created later included
+        /// @param settleTime How long a file has to stay untouched before it's reported, editors often write twice
+        explicit FileWatcher(
+            const std::vector<std::filesystem::path>& directories,
+            std::chrono::milliseconds settleTime = std::chrono::milliseconds(100)
+        );
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        /// @brief Files changed since the last call, each listed once with a canonical path
+        [[nodiscard]] std::vector<std::filesystem::path> Poll();
+
+      private:
+        std::vector<std::filesystem::path> _directories;
+        std::chrono::milliseconds _settleTime;
+        std::atomic<bool> _stopping = false;
+        std::thread _thread;
+
+        std::mutex _mutex;
+        /// @brief Changed files and when they last changed, reported once they've settled
+        std::unordered_map<std::filesystem::path, std::chrono::steady_clock::time_point> _changed;
+
+#ifdef __linux__
+        int _inotify = -1;
+        std::unordered_map<int, std::filesystem::path> _watches;
+
+        void AddWatches(const std::filesystem::path& directory);
+#else
+        std::unordered_map<std::filesystem::path, std::filesystem::file_time_type> _writeTimes;
+
+        void Scan(bool report);
+#endif
+
+        void WatchLoop();
+        void MarkChanged(const std::filesystem::path& path);
+    };
+} // namespace Cocoa::Tools
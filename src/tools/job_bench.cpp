@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "job_system.h"
+
+using namespace Cocoa;
+
+namespace {
+    int Usage()
+    {
+        fprintf(stderr, "Usage: CocoaJobBench [--workers N] [--jobs N] [--items N] [--grain N]\n");
+        return 1;
+    }
+
+    double NanosecondsSince(const std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /// @brief A few dozen cycles of math per item, enough that the split and not the memory bandwidth is measured
+    void Work(std::vector<f32>& values, const u32 begin, const u32 end)
+    {
+        for (u32 i = begin; i < end; i++) {
+            f32 value = static_cast<f32>(i);
+            for (u32 step = 0; step < 8; step++) {
+                value = std::sqrt(value * 1.5f + 1.0f);
+            }
+            values[i] = value;
+        }
+    }
+} // namespace
+
+/// @brief Measures what a job costs to spawn and how ParallelFor scales with 1, 2, 4... up to N workers
+/// @note Spawn times cover queueing, running and counting down an empty job, from the main thread through the shared
+/// queue and from inside a job through the worker's own deque. The calling thread helps in Wait and ParallelFor, so
+/// N workers run on N + 1 threads.
+int main(const int argc, char** argv)
+{
+    u32 maxWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    u32 jobCount = 100000;
+    u32 itemCount = 1u << 22;
+    u32 grain = 4096;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--workers" && i + 1 < argc) {
+            maxWorkers = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--jobs" && i + 1 < argc) {
+            jobCount = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--items" && i + 1 < argc) {
+            itemCount = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--grain" && i + 1 < argc) {
+            grain = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            return Usage();
+        }
+    }
+    if (maxWorkers == 0 || jobCount == 0 || itemCount == 0 || grain == 0)
+        return Usage();
+
+    std::vector<f32> values(itemCount);
+    const auto serialStart = std::chrono::steady_clock::now();
+    Work(values, 0, itemCount);
+    const double serialNs = NanosecondsSince(serialStart);
+
+    printf("%u jobs, %u items in grains of %u, serial %.2f ms\n", jobCount, itemCount, grain, serialNs / 1e6);
+    printf("workers   main ns/job   job ns/job   ParallelFor ms   speedup\n");
+    for (u32 workers = 1;; workers = std::min(workers * 2, maxWorkers)) {
+        Tools::JobSystem jobs(workers);
+        std::atomic<u32> ran = 0;
+
+        Tools::JobCounter fromMain;
+        auto start = std::chrono::steady_clock::now();
+        for (u32 i = 0; i < jobCount; i++) {
+            jobs.Run([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, &fromMain);
+        }
+        jobs.Wait(fromMain);
+        const double mainNs = NanosecondsSince(start);
+
+        Tools::JobCounter fromJob;
+        start = std::chrono::steady_clock::now();
+        jobs.Run(
+            [&] {
+                for (u32 i = 0; i < jobCount; i++) {
+                    jobs.Run([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, &fromJob);
+                }
+            },
+            &fromJob
+        );
+        jobs.Wait(fromJob);
+        const double jobNs = NanosecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        jobs.ParallelFor(itemCount, grain, [&values](const u32 begin, const u32 end) { Work(values, begin, end); });
+        const double parallelNs = NanosecondsSince(start);
+
+        if (ran.load() != jobCount * 2) {
+            fprintf(stderr, "Ran %u of %u jobs\n", ran.load(), jobCount * 2);
+            return 1;
+        }
+        printf(
+            "%7u %13.1f %12.1f %16.2f %8.2fx\n", workers, mainNs / jobCount, jobNs / jobCount, parallelNs / 1e6,
+            serialNs / parallelNs
+        );
+
+        if (workers == maxWorkers)
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "job_system.h"
+
+using namespace Cocoa;
+
+namespace {
+    int Usage()
+    {
+        fprintf(stderr, "Usage: CocoaJobStress [--rounds N]\n");
+        return 1;
+    }
+
+    int Fail(const char* what, const u32 round, const u32 workers)
+    {
+        fprintf(stderr, "%s failed in round %u with %u workers\n", what, round, workers);
+        return 1;
+    }
+} // namespace
+
+/// @brief Exercises the job system's scheduling paths over and over with 1 to 4 workers and checks the results
+/// @note Meant to be built with -fsanitize=thread, which catches races the checks alone would miss
+int main(const int argc, char** argv)
+{
+    u32 rounds = 20;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--rounds" && i + 1 < argc) {
+            rounds = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            return Usage();
+        }
+    }
+
+    for (u32 round = 0; round < rounds; round++) {
+        const u32 workers = round % 4 + 1;
+        Tools::JobSystem jobs(workers);
+
+        // Every item is touched by exactly one range
+        std::vector<u32> items(100000, 0);
+        jobs.ParallelFor(static_cast<u32>(items.size()), 64, [&items](const u32 begin, const u32 end) {
+            for (u32 i = begin; i < end; i++) {
+                items[i]++;
+            }
+        });
+        for (const u32 item : items) {
+            if (item != 1)
+                return Fail("ParallelFor", round, workers);
+        }
+
+        // Waits inside jobs run other jobs instead of blocking their worker
+        std::atomic<u64> nestedItems = 0;
+        jobs.ParallelFor(64, 1, [&](const u32 begin, const u32 end) {
+            for (u32 i = begin; i < end; i++) {
+                jobs.ParallelFor(1000, 10, [&](const u32 innerBegin, const u32 innerEnd) {
+                    nestedItems += innerEnd - innerBegin;
+                });
+            }
+        });
+        if (nestedItems != 64000)
+            return Fail("Nested ParallelFor", round, workers);
+
+        // A chain of RunAfter jobs only starts once everything it depends on finished
+        Tools::JobCounter first;
+        Tools::JobCounter second;
+        Tools::JobCounter third;
+        std::atomic<u32> stage = 0;
+        std::atomic<bool> ordered = true;
+        for (u32 i = 0; i < 100; i++) {
+            jobs.Run(
+                [&] {
+                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                    if (stage.load() != 0) {
+                        ordered = false;
+                    }
+                },
+                &first
+            );
+        }
+        jobs.RunAfter(first, [&] { stage = 1; }, &second);
+        jobs.RunAfter(
+            second,
+            [&] {
+                if (stage.load() != 1) {
+                    ordered = false;
+                }
+                stage = 2;
+            },
+            &third
+        );
+
+        // Main thread jobs run while the main thread waits
+        Tools::JobCounter main;
+        std::thread::id mainThread;
+        jobs.RunOnMainThread([&mainThread] { mainThread = std::this_thread::get_id(); }, &main);
+        jobs.Wait(third);
+        jobs.Wait(main);
+        if (!ordered || stage != 2)
+            return Fail("RunAfter", round, workers);
+        if (mainThread != std::this_thread::get_id())
+            return Fail("RunOnMainThread", round, workers);
+
+        // A counter can be waited on again once it reached zero
+        Tools::JobCounter reused;
+        std::atomic<u32> ran = 0;
+        for (u32 repeat = 0; repeat < 3; repeat++) {
+            for (u32 i = 0; i < 20000; i++) {
+                jobs.Run([&ran] { ++ran; }, &reused);
+            }
+            jobs.Wait(reused);
+        }
+        if (ran != 60000)
+            return Fail("Counter reuse", round, workers);
+
+        // More jobs than a worker's deque holds, the rest spill into the shared queue
+        Tools::JobCounter spawned;
+        std::atomic<u32> spawnedRan = 0;
+        jobs.Run(
+            [&] {
+                for (u32 i = 0; i < 10000; i++) {
+                    jobs.Run([&spawnedRan] { ++spawnedRan; }, &spawned);
+                }
+            },
+            &spawned
+        );
+        jobs.Wait(spawned);
+        if (spawnedRan != 10000)
+            return Fail("Spawning from a job", round, workers);
+    }
+
+    printf("%u rounds passed\n", rounds);
+    return 0;
+}
@@ -0,0 +1,273 @@
+#include "job_system.h"
+
+#include <utility>
+
+namespace Cocoa::Tools {
+    struct Job
+    {
+        std::function<void()> function;
+        JobCounter* counter = nullptr;
+        /// @brief Next job waiting on the same counter
+        Job* next = nullptr;
+    };
+
+    bool JobSystem::WorkQueue::Push(Job* job)
+    {
+        const i64 bottom = _bottom.load(std::memory_order_relaxed);
+        const i64 top = _top.load(std::memory_order_acquire);
+        if (bottom - top >= Capacity)
+            return false;
+
+        _jobs[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Job* JobSystem::WorkQueue::Pop()
+    {
+        const i64 bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 top = _top.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        // The last job can be stolen at the same time, whoever moves top first gets it
+        Job* job = _jobs[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                job = nullptr;
+            }
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job* JobSystem::WorkQueue::Steal()
+    {
+        i64 top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const i64 bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return nullptr;
+
+        Job* job = _jobs[top & (Capacity - 1)].load(std::memory_order_relaxed);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+    JobSystem::JobSystem(u32 workerCount) : _mainThread(std::this_thread::get_id())
+    {
+        if (workerCount == 0) {
+            workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        }
+
+        // Every worker has to exist before any starts, they steal from each other right away
+        _workers.reserve(workerCount);
+        for (u32 i = 0; i < workerCount; i++) {
+            _workers.push_back(std::make_unique<Worker>());
+            _workers.back()->system = this;
+            _workers.back()->index = i;
+        }
+        for (auto& worker : _workers) {
+            worker->thread = std::thread(&JobSystem::WorkerLoop, this, std::ref(*worker));
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard lock(_sleepMutex);
+            _stopping = true;
+        }
+        _wake.notify_all();
+
+        // Workers finish whatever is queued before leaving, main thread jobs that never got pumped are dropped
+        for (auto& worker : _workers) {
+            worker->thread.join();
+        }
+        for (Job* job : _main) {
+            delete job;
+        }
+    }
+
+    void JobSystem::Run(std::function<void()> function, JobCounter* counter)
+    {
+        if (counter) {
+            counter->_pending++;
+        }
+        Schedule(new Job{.function = std::move(function), .counter = counter, .next = nullptr});
+    }
+
+    void JobSystem::RunAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter)
+    {
+        if (counter) {
+            counter->_pending++;
+        }
+        auto job = new Job{.function = std::move(function), .counter = counter, .next = nullptr};
+        {
+            std::lock_guard lock(dependency._mutex);
+            if (dependency._pending.load() != 0) {
+                job->next = dependency._waiters;
+                dependency._waiters = job;
+                return;
+            }
+        }
+        Schedule(job);
+    }
+
+    void JobSystem::RunOnMainThread(std::function<void()> function, JobCounter* counter)
+    {
+        if (counter) {
+            counter->_pending++;
+        }
+        std::lock_guard lock(_mainMutex);
+        _main.push_back(new Job{.function = std::move(function), .counter = counter, .next = nullptr});
+    }
+
+    void JobSystem::PumpMainThread()
+    {
+        // Jobs queued by the ones running now wait for the next pump, so a job requeueing itself can't stall the frame
+        std::deque<Job*> jobs;
+        {
+            std::lock_guard lock(_mainMutex);
+            jobs.swap(_main);
+        }
+        for (Job* job : jobs) {
+            Execute(job);
+        }
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        Worker* worker = GetCurrentWorker();
+        const bool mainThread = std::this_thread::get_id() == _mainThread;
+        while (!counter.IsDone()) {
+            Job* job = FindJob(worker);
+            if (!job && mainThread) {
+                job = TakeMainThreadJob();
+            }
+            if (job) {
+                Execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    JobSystem::Worker* JobSystem::GetCurrentWorker() const
+    {
+        return _currentWorker && _currentWorker->system == this ? _currentWorker : nullptr;
+    }
+
+    void JobSystem::WorkerLoop(Worker& worker)
+    {
+        _currentWorker = &worker;
+        while (true) {
+            if (Job* job = FindJob(&worker)) {
+                Execute(job);
+                continue;
+            }
+
+            std::unique_lock lock(_sleepMutex);
+            if (_stopping && _queued.load() == 0)
+                return;
+            _sleeping++;
+            _wake.wait(lock, [this] { return _queued.load() > 0 || _stopping; });
+            _sleeping--;
+        }
+    }
+
+    void JobSystem::Schedule(Job* job)
+    {
+        // Counted before it's visible, so a worker checking whether to sleep never misses it
+        _queued++;
+        Worker* worker = GetCurrentWorker();
+        if (!worker || !worker->queue.Push(job)) {
+            std::lock_guard lock(_sharedMutex);
+            _shared.push_back(job);
+        }
+
+        if (_sleeping.load() > 0) {
+            std::lock_guard lock(_sleepMutex);
+            _wake.notify_one();
+        }
+    }
+
+    Job* JobSystem::FindJob(Worker* worker)
+    {
+        // Own jobs come newest first while they're still in cache, thieves take the oldest which tend to be largest
+        if (worker) {
+            if (Job* job = worker->queue.Pop()) {
+                _queued--;
+                return job;
+            }
+        }
+        {
+            std::lock_guard lock(_sharedMutex);
+            if (!_shared.empty()) {
+                Job* job = _shared.front();
+                _shared.pop_front();
+                _queued--;
+                return job;
+            }
+        }
+
+        // Starting after the worker's own index spreads thieves across victims instead of all hitting the first
+        const u32 count = GetWorkerCount();
+        const u32 start = worker ? worker->index + 1 : 0;
+        for (u32 i = 0; i < count; i++) {
+            Worker& victim = *_workers[(start + i) % count];
+            if (&victim == worker)
+                continue;
+            if (Job* job = victim.queue.Steal()) {
+                _queued--;
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    Job* JobSystem::TakeMainThreadJob()
+    {
+        std::lock_guard lock(_mainMutex);
+        if (_main.empty())
+            return nullptr;
+        Job* job = _main.front();
+        _main.pop_front();
+        return job;
+    }
+
+    void JobSystem::Execute(Job* job)
+    {
+        job->function();
+        if (job->counter) {
+            Finish(*job->counter);
+        }
+        delete job;
+    }
+
+    void JobSystem::Finish(JobCounter& counter)
+    {
+        counter._finishing++;
+        if (counter._pending.fetch_sub(1) == 1) {
+            Job* waiters = nullptr;
+            {
+                // The counter may have been reused since it reached zero, its new waiters are for a later finish
+                std::lock_guard lock(counter._mutex);
+                if (counter._pending.load() == 0) {
+                    waiters = std::exchange(counter._waiters, nullptr);
+                }
+            }
+            while (waiters) {
+                Schedule(std::exchange(waiters, waiters->next));
+            }
+        }
+        // Last access, a thread waiting on the counter may destroy it right after
+        counter._finishing--;
+    }
+} // namespace Cocoa::Tools
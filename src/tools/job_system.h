@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../common.h"
+
+namespace Cocoa::Tools {
+    class JobSystem;
+    struct Job;
+
+    /// @brief Counts unfinished jobs, jobs can be made to wait for one to reach zero instead of blocking a thread
+    /// @note Must outlive every job counted by it or waiting on it
+    class JobCounter
+    {
+      public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        [[nodiscard]] bool IsDone() const { return _pending.load() == 0 && _finishing.load() == 0; }
+
+      private:
+        friend class JobSystem;
+
+        /// @brief Jobs queued with RunAfter, scheduled once the count reaches zero
+        Job* _waiters = nullptr;
+        std::atomic<u32> _pending = 0;
+        /// @brief Jobs still touching the counter after counting themselves done, so it can't be destroyed yet
+        std::atomic<u32> _finishing = 0;
+        std::mutex _mutex;
+    };
+
+    /// @brief Runs short CPU jobs on a worker per core, idle workers steal queued jobs from busy ones
+    /// @note Jobs shouldn't block on IO or locks held for long, a blocked job holds up a whole worker. Those are a
+    /// better fit for a ThreadPool. Jobs must not throw.
+    class JobSystem
+    {
+      public:
+        /// @param workerCount Number of workers to start, 0 picks one less than the hardware thread count
+        /// @note The thread creating the system is the main thread, which RunOnMainThread jobs run on
+        explicit JobSystem(u32 workerCount = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /// @param counter Counts the job until it has finished, optional
+        void Run(std::function<void()> function, JobCounter* counter = nullptr);
+
+        /// @brief Queues a job once dependency reaches zero, without a thread waiting for it in between
+        void RunAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter = nullptr);
+
+        /// @brief Runs a job on the main thread the next time it pumps, for APIs like SDL that need that thread
+        void RunOnMainThread(std::function<void()> function, JobCounter* counter = nullptr);
+
+        /// @brief Runs the main thread jobs queued so far, meant to be called once per frame
+        void PumpMainThread();
+
+        /// @brief Returns once counter reaches zero, running other jobs on the calling thread meanwhile
+        /// @note Can be called from jobs, and on the main thread also runs main thread jobs
+        void Wait(const JobCounter& counter);
+
+        /// @brief Splits [0, count) into ranges of grainSize items, runs them across the workers and waits
+        /// @note The calling thread works on the ranges too, so it can be called from inside a job
+        template <typename F> void ParallelFor(const u32 count, const u32 grainSize, F&& function)
+        {
+            const u32 grain = std::max(grainSize, 1u);
+            if (count <= grain || _workers.empty()) {
+                function(0u, count);
+                return;
+            }
+
+            JobCounter counter;
+            for (u32 begin = grain; begin < count; begin += grain) {
+                const u32 end = std::min(begin + grain, count);
+                Run([&function, begin, end] { function(begin, end); }, &counter);
+            }
+            function(0u, grain);
+            Wait(counter);
+        }
+
+        [[nodiscard]] u32 GetWorkerCount() const { return static_cast<u32>(_workers.size()); }
+
+      private:
+        /// @brief Chase-Lev deque, the owning worker pushes and pops at the bottom while others steal from the top
+        class WorkQueue
+        {
+          public:
+            static constexpr i64 Capacity = 4096;
+
+            /// @return False when full, the job then has to go elsewhere
+            bool Push(Job* job);
+            Job* Pop();
+            Job* Steal();
+
+          private:
+            alignas(64) std::atomic<i64> _top = 0;
+            alignas(64) std::atomic<i64> _bottom = 0;
+            std::array<std::atomic<Job*>, Capacity> _jobs{};
+        };
+
+        struct Worker
+        {
+            JobSystem* system;
+            u32 index;
+            WorkQueue queue;
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::thread::id _mainThread;
+
+        /// @brief Jobs queued from threads that aren't workers, or that didn't fit a worker's queue
+        std::mutex _sharedMutex;
+        std::deque<Job*> _shared;
+
+        std::mutex _mainMutex;
+        std::deque<Job*> _main;
+
+        /// @brief Jobs queued but not yet taken, idle workers sleep while it's zero
+        std::atomic<u32> _queued = 0;
+        std::atomic<u32> _sleeping = 0;
+        std::mutex _sleepMutex;
+        std::condition_variable _wake;
+        std::atomic<bool> _stopping = false;
+
+        static inline thread_local Worker* _currentWorker = nullptr;
+
+        /// @return nullptr when the calling thread isn't one of this system's workers
+        [[nodiscard]] Worker* GetCurrentWorker() const;
+        void WorkerLoop(Worker& worker);
+        void Schedule(Job* job);
+        /// @brief Takes a job from the calling worker's queue, the shared queue or another worker, in that order
+        Job* FindJob(Worker* worker);
+        Job* TakeMainThreadJob();
+        void Execute(Job* job);
+        void Finish(JobCounter& counter);
+    };
+} // namespace Cocoa::Tools
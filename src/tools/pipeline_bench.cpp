@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include "../graphics/core/shader_reflection.h"
+#include "../vulkan/core/render_device_impl.h"
+
+using namespace Cocoa;
+
+namespace {
+    constexpr Graphics::GPUColorFormat ColorFormats[] = {
+        Graphics::GPUColorFormat::BGRA8_SRGB,
+        Graphics::GPUColorFormat::RGBA8_Unorm,
+        Graphics::GPUColorFormat::RGBA8_SRGB,
+        Graphics::GPUColorFormat::RGBA16_Float,
+    };
+
+    constexpr Graphics::GPUCullMode CullModes[] = {
+        Graphics::GPUCullMode::None,
+        Graphics::GPUCullMode::Frontside,
+        Graphics::GPUCullMode::Backside,
+    };
+
+    int Usage()
+    {
+        fprintf(stderr, "Usage: CocoaPipelineBench <vertex.spv> <pixel.spv> [--pipelines N] [--threads N]\n");
+        return 1;
+    }
+
+    double MillisecondsSince(const std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /// @brief Every variant differs in fixed-function state, so the device can't share one pipeline between them
+    Graphics::GFXPipelineDesc GetVariant(const Graphics::GFXPipelineDesc& base, const u32 variant)
+    {
+        auto desc = base;
+        u32 rest = variant;
+        desc.colorFormat = ColorFormats[rest % std::size(ColorFormats)];
+        rest /= std::size(ColorFormats);
+        desc.cullMode = CullModes[rest % std::size(CullModes)];
+        rest /= std::size(CullModes);
+        desc.depthCompareOp = static_cast<Graphics::GPUCompareOp>(rest % 8);
+        rest /= 8;
+        desc.stencilFrontFace.reference = rest;
+        return desc;
+    }
+
+    /// @brief Compiles variants [first, first + count) on a fresh device, either one after another or all at once on
+    /// the device's compile threads
+    /// @return Milliseconds until every pipeline was ready
+    double CompilePipelines(
+        SDL_Window* window, const std::string& vertexPath, const std::string& pixelPath, const u32 first,
+        const u32 count, const u32 threads, const bool async
+    )
+    {
+        // An empty cache path keeps pipelines from earlier runs out of the measurement
+        Vulkan::RenderDeviceImpl device({
+            .window = window,
+            .desiredQueues = {Graphics::GPUQueueType::Graphics},
+            .pipelineCachePath = "",
+            .pipelineCompileThreads = threads,
+        });
+
+        const auto vertexReflection = Graphics::LoadShaderReflection(vertexPath);
+        const auto pixelReflection = Graphics::LoadShaderReflection(pixelPath);
+        if (!vertexReflection || !pixelReflection) {
+            PANIC("Failed to reflect %s or %s", vertexPath.c_str(), pixelPath.c_str());
+        }
+        const Graphics::ShaderReflection stages[] = {*vertexReflection, *pixelReflection};
+        auto layout = Graphics::CreateReflectedPipelineLayout(device, Graphics::MergeShaderReflections(stages));
+
+        auto vertexModule = device.CreateShaderModule({.shaderPath = vertexPath, .code = {}});
+        auto pixelModule = device.CreateShaderModule({.shaderPath = pixelPath, .code = {}});
+
+        Graphics::GFXPipelineDesc base;
+        base.shaders[Graphics::GPUShaderStage::Vertex] = vertexModule;
+        base.shaders[Graphics::GPUShaderStage::Pixel] = pixelModule;
+        if (!vertexReflection->vertexInputs.empty()) {
+            base.vertexLayout.push_back(Graphics::GetReflectedVertexBinding(*vertexReflection));
+        }
+        base.stencilTest = true;
+        base.depthStencilFormat = Graphics::GPUDepthStencilFormat::DepthFloat32_StencilUint8;
+        base.pipelineLayout = layout.pipelineLayout;
+
+        std::vector<Graphics::GFXPipelineDesc> descs;
+        descs.reserve(count);
+        for (u32 i = 0; i < count; i++) {
+            descs.push_back(GetVariant(base, first + i));
+        }
+
+        std::vector<Graphics::GFXRenderPipelineHandle> pipelines;
+        pipelines.reserve(count);
+        const auto start = std::chrono::steady_clock::now();
+        if (async) {
+            for (const auto& desc : descs) {
+                pipelines.push_back(device.CreateRenderPipelineAsync(desc, Graphics::GFXRenderPipelineHandle(u64Max)));
+            }
+            for (auto& pipeline : pipelines) {
+                while (!device.IsRenderPipelineReady(pipeline)) {
+                    std::this_thread::yield();
+                }
+            }
+        } else {
+            for (const auto& desc : descs) {
+                pipelines.push_back(device.CreateRenderPipeline(desc));
+            }
+        }
+        const double milliseconds = MillisecondsSince(start);
+
+        for (auto& pipeline : pipelines) {
+            device.DestroyRenderPipeline(pipeline);
+        }
+        device.DestroyPipelineLayout(layout.pipelineLayout);
+        for (auto& groupLayout : layout.groupLayouts) {
+            device.DestroyBindGroupLayout(groupLayout);
+        }
+        device.DestroyShaderModule(vertexModule);
+        device.DestroyShaderModule(pixelModule);
+        return milliseconds;
+    }
+} // namespace
+
+/// @brief Compares compiling render pipelines one by one against compiling them on worker threads
+/// @note Both runs compile different variants on a fresh device without a pipeline cache, drivers with their own
+/// shader cache can still reuse the shader code between them
+int main(const int argc, char** argv)
+{
+    if (argc < 3)
+        return Usage();
+
+    const std::string vertexPath = argv[1];
+    const std::string pixelPath = argv[2];
+    u32 pipelineCount = 256;
+    u32 threads = 0;
+    for (int i = 3; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--pipelines" && i + 1 < argc) {
+            pipelineCount = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--threads" && i + 1 < argc) {
+            threads = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            return Usage();
+        }
+    }
+    if (pipelineCount == 0)
+        return Usage();
+
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        PANIC("Failed to start SDL3");
+    }
+    SDL_Window* window = SDL_CreateWindow("CocoaPipelineBench", 64, 64, SDL_WINDOW_HIDDEN | SDL_WINDOW_VULKAN);
+
+    const double serial = CompilePipelines(window, vertexPath, pixelPath, 0, pipelineCount, threads, false);
+    const double async = CompilePipelines(window, vertexPath, pixelPath, pipelineCount, pipelineCount, threads, true);
+
+    printf("%u pipelines\n", pipelineCount);
+    printf("serial   %9.2f ms  %7.3f ms/pipeline\n", serial, serial / pipelineCount);
+    printf("async    %9.2f ms  %7.3f ms/pipeline  %.2fx\n", async, async / pipelineCount, serial / async);
+
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
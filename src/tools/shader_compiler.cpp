@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+#include "../graphics/core/shader_manifest.h"
+#include "../graphics/core/shader_reflection.h"
+#include "thread_pool.h"
+
+using namespace Cocoa;
+
+namespace {
+    // Bumped whenever the way outputs are produced changes, so older cached outputs are rebuilt
+    constexpr std::string_view CompilerVersion = "1";
+
+    /// @brief Lists the extra define sets a shader is compiled with, one whitespace separated set per line
+    constexpr std::string_view PermutationsExtension = ".permutations";
+
+    /// @brief Cache of the last build, the manifest is only written once everything compiled
+    constexpr std::string_view CacheName = ".shader_cache";
+
+    constexpr std::string_view ShaderExtensions[] = {".vert", ".frag", ".comp", ".geom", ".tesc", ".tese"};
+
+    /// @brief Stages shader reflection understands, the others compile without a .refl next to them
+    constexpr std::string_view ReflectedExtensions[] = {".vert", ".frag"};
+
+    int Usage()
+    {
+        fprintf(
+            stderr, "Usage: CocoaShaderCompiler <source directory> <output directory> [--compiler glslangValidator] "
+                    "[--threads N]\n"
+        );
+        return 1;
+    }
+
+    std::optional<std::string> ReadText(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return std::nullopt;
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    void HashBytes(u64& hash, const std::string_view bytes)
+    {
+        // FNV-1a, continued from wherever the previous call left it
+        for (const char c : bytes) {
+            hash ^= static_cast<u8>(c);
+            hash *= 0x100000001b3ull;
+        }
+        hash ^= 0xFF;
+        hash *= 0x100000001b3ull;
+    }
+
+    /// @brief Hashes a file and, recursively, everything it includes, so editing a shared include rebuilds its users
+    /// @note Includes are found by scanning for #include lines, one skipped by the preprocessor still counts
+    bool HashWithIncludes(
+        u64& hash, const std::filesystem::path& path, const std::filesystem::path& sourceDirectory,
+        std::set<std::filesystem::path>& visited
+    )
+    {
+        if (!visited.insert(path).second)
+            return true;
+        const auto text = ReadText(path);
+        if (!text) {
+            fprintf(stderr, "Failed to read %s\n", path.string().c_str());
+            return false;
+        }
+        HashBytes(hash, *text);
+
+        std::istringstream lines(*text);
+        for (std::string line; std::getline(lines, line);) {
+            const auto directive = line.find_first_not_of(" \t");
+            if (directive == std::string::npos || line.compare(directive, 8, "#include") != 0)
+                continue;
+            const auto open = line.find_first_of("\"<", directive + 8);
+            const auto close = open == std::string::npos ? open : line.find_first_of("\">", open + 1);
+            if (close == std::string::npos)
+                continue;
+
+            // Quoted includes are looked up next to the including file first, like the compiler does
+            const std::string name = line.substr(open + 1, close - open - 1);
+            auto included = path.parent_path() / name;
+            if (line[open] == '<' || !std::filesystem::exists(included)) {
+                included = sourceDirectory / name;
+            }
+            if (!HashWithIncludes(hash, std::filesystem::weakly_canonical(included), sourceDirectory, visited))
+                return false;
+        }
+        return true;
+    }
+
+    /// @brief The base permutation keeps the plain "<source>.spv" name, others get a suffix derived from their defines
+    std::string GetOutputName(const std::string& source, const std::vector<std::string>& defines)
+    {
+        if (defines.empty())
+            return source + ".spv";
+
+        u64 hash = 0xcbf29ce484222325ull;
+        for (const auto& define : defines) {
+            HashBytes(hash, define);
+        }
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "%08x", static_cast<u32>(hash ^ hash >> 32));
+        return source + "." + suffix + ".spv";
+    }
+
+    std::string Quote(const std::string& text) { return "\"" + text + "\""; }
+
+    int RunCommand(const std::string& command)
+    {
+#ifdef _WIN32
+        // cmd /c strips the first and last quote of the line, which would break a quoted compiler path
+        return std::system(Quote(command).c_str());
+#else
+        return std::system(command.c_str());
+#endif
+    }
+} // namespace
+
+/// @brief Compiles every GLSL shader in a directory to SPIR-V, including the permutations listed next to it
+/// @note "<shader>.permutations" holds one define set per line, e.g. "ALPHA_TEST SKINNED=1", the shader is also
+/// always compiled without defines. Outputs are only rebuilt when their source, includes, defines or compiler
+/// changed, and the resulting shaders.manifest tells the game which file holds which permutation.
+int main(const int argc, char** argv)
+{
+    if (argc < 3)
+        return Usage();
+
+    const auto sourceDirectory = std::filesystem::weakly_canonical(argv[1]);
+    const std::filesystem::path outputDirectory(argv[2]);
+    std::string compiler = "glslangValidator";
+    u32 threads = 0;
+    for (int i = 3; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--compiler" && i + 1 < argc) {
+            compiler = argv[++i];
+        } else if (argument == "--threads" && i + 1 < argc) {
+            threads = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            return Usage();
+        }
+    }
+
+    std::error_code error;
+    std::vector<std::filesystem::path> sources;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(sourceDirectory, error)) {
+        const auto extension = entry.path().extension().string();
+        if (entry.is_regular_file() && std::ranges::find(ShaderExtensions, extension) != std::end(ShaderExtensions)) {
+            sources.push_back(entry.path());
+        }
+    }
+    if (error) {
+        fprintf(stderr, "Failed to list %s: %s\n", sourceDirectory.string().c_str(), error.message().c_str());
+        return 1;
+    }
+    // Directory iteration order isn't specified, sorting keeps the manifest identical between builds
+    std::ranges::sort(sources);
+
+    std::unordered_map<std::string, u64> cachedHashes;
+    if (const auto text = ReadText(outputDirectory / CacheName)) {
+        if (const auto cache = Graphics::ParseShaderManifest(*text)) {
+            for (const auto& permutation : cache->permutations) {
+                cachedHashes[permutation.path] = permutation.hash;
+            }
+        }
+    }
+
+    Graphics::ShaderManifest manifest;
+    for (const auto& path : sources) {
+        const auto source = path.lexically_relative(sourceDirectory).generic_string();
+        u64 sourceHash = 0xcbf29ce484222325ull;
+        HashBytes(sourceHash, CompilerVersion);
+        HashBytes(sourceHash, compiler);
+        std::set<std::filesystem::path> visited;
+        if (!HashWithIncludes(sourceHash, std::filesystem::weakly_canonical(path), sourceDirectory, visited))
+            return 1;
+
+        std::vector<std::vector<std::string>> defineSets = {{}};
+        auto permutationsPath = path;
+        permutationsPath += PermutationsExtension;
+        if (const auto text = ReadText(permutationsPath)) {
+            std::istringstream lines(*text);
+            for (std::string line; std::getline(lines, line);) {
+                auto defines = Graphics::ParseShaderDefines(line.substr(0, line.find('#')));
+                if (!defines.empty() && std::ranges::find(defineSets, defines) == defineSets.end()) {
+                    defineSets.push_back(std::move(defines));
+                }
+            }
+        }
+
+        for (auto& defines : defineSets) {
+            u64 hash = sourceHash;
+            for (const auto& define : defines) {
+                HashBytes(hash, define);
+            }
+            manifest.permutations.push_back({
+                .source = source,
+                .path = GetOutputName(source, defines),
+                .defines = std::move(defines),
+                .hash = hash,
+            });
+        }
+    }
+
+    // Outputs of permutations that no longer exist would otherwise end up in the archive
+    for (const auto& [output, hash] : cachedHashes) {
+        const bool stale = std::ranges::none_of(manifest.permutations, [&](const Graphics::ShaderPermutation& p) {
+            return p.path == output;
+        });
+        if (stale) {
+            std::filesystem::remove(outputDirectory / output, error);
+            std::filesystem::remove(outputDirectory / (output + ".refl"), error);
+        }
+    }
+
+    Tools::ThreadPool pool(threads);
+    std::vector<std::future<bool>> compiles(manifest.permutations.size());
+    std::atomic<u32> compiled = 0;
+    for (usize i = 0; i < manifest.permutations.size(); i++) {
+        const auto& permutation = manifest.permutations[i];
+        const auto output = outputDirectory / permutation.path;
+        const auto cached = cachedHashes.find(permutation.path);
+        if (cached != cachedHashes.end() && cached->second == permutation.hash && std::filesystem::exists(output))
+            continue;
+
+        std::string command = Quote(compiler) + " -V --quiet -I" + Quote(sourceDirectory.string());
+        for (const auto& define : permutation.defines) {
+            command += " -D" + Quote(define);
+        }
+        command += " " + Quote((sourceDirectory / permutation.source).string()) + " -o " + Quote(output.string());
+
+        const auto extension = std::filesystem::path(permutation.source).extension().string();
+        const bool reflect = std::ranges::find(ReflectedExtensions, extension) != std::end(ReflectedExtensions);
+        compiles[i] = pool.Submit([command, output, reflect, &compiled] {
+            std::error_code createError;
+            std::filesystem::create_directories(output.parent_path(), createError);
+            if (RunCommand(command) != 0)
+                return false;
+
+            // Reflecting now leaves a current .refl next to the output, so it gets packed and the game skips it
+            if (reflect && !Graphics::LoadShaderReflection(output))
+                return false;
+            ++compiled;
+            return true;
+        });
+    }
+
+    // Failed permutations are left out of the cache so the next build tries them again
+    Graphics::ShaderManifest cache;
+    bool failed = false;
+    for (usize i = 0; i < manifest.permutations.size(); i++) {
+        const auto& permutation = manifest.permutations[i];
+        if (compiles[i].valid() && !compiles[i].get()) {
+            fprintf(stderr, "Failed to compile %s\n", permutation.source.c_str());
+            failed = true;
+            continue;
+        }
+        cache.permutations.push_back(permutation);
+    }
+
+    std::filesystem::create_directories(outputDirectory, error);
+    if (!Graphics::WriteShaderManifest(outputDirectory / CacheName, cache)) {
+        fprintf(stderr, "Failed to write the cache to %s\n", outputDirectory.string().c_str());
+        return 1;
+    }
+    // A missing manifest makes the build run this again, an outdated one would be taken as up to date
+    const auto manifestPath = outputDirectory / Graphics::ShaderManifestName;
+    if (failed) {
+        std::filesystem::remove(manifestPath, error);
+        return 1;
+    }
+    if (!Graphics::WriteShaderManifest(manifestPath, manifest)) {
+        fprintf(stderr, "Failed to write %s\n", manifestPath.string().c_str());
+        return 1;
+    }
+
+    printf(
+        "%s: %zu permutations, %u compiled, %zu up to date\n", manifestPath.string().c_str(),
+        manifest.permutations.size(), compiled.load(), manifest.permutations.size() - compiled.load()
+    );
+    return 0;
+}
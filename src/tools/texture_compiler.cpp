@@ -0,0 +1,114 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#include "../graphics/core/dds.h"
+#include "../graphics/core/texture_compression.h"
+#include "stb.h"
+
+using namespace Cocoa;
+
+namespace {
+    struct FormatName
+    {
+        std::string_view name;
+        Graphics::GPUColorFormat linear;
+        Graphics::GPUColorFormat srgb;
+    };
+
+    constexpr FormatName Formats[] = {
+        {"bc1", Graphics::GPUColorFormat::BC1_Unorm, Graphics::GPUColorFormat::BC1_SRGB},
+        {"bc3", Graphics::GPUColorFormat::BC3_Unorm, Graphics::GPUColorFormat::BC3_SRGB},
+        {"bc4", Graphics::GPUColorFormat::BC4_Unorm, Graphics::GPUColorFormat::BC4_Unorm},
+        {"bc5", Graphics::GPUColorFormat::BC5_Unorm, Graphics::GPUColorFormat::BC5_Unorm},
+        {"bc7", Graphics::GPUColorFormat::BC7_Unorm, Graphics::GPUColorFormat::BC7_SRGB},
+    };
+
+    int Usage()
+    {
+        fprintf(
+            stderr, "Usage: CocoaTextureCompiler <input.png|jpg> <output.dds> [--format bc1|bc3|bc4|bc5|bc7] "
+                    "[--srgb] [--no-mips] [--box] [--threads N]\n"
+        );
+        return 1;
+    }
+} // namespace
+
+/// @brief Offline converter from PNG/JPG to block compressed DDS textures with a full mip chain
+int main(const int argc, char** argv)
+{
+    if (argc < 3)
+        return Usage();
+
+    const char* input = argv[1];
+    const char* output = argv[2];
+    const FormatName* format = &Formats[4];
+    bool srgb = false;
+    bool mips = true;
+    u32 threads = 0;
+    Graphics::MipFilter filter = Graphics::MipFilter::Kaiser;
+    for (int i = 3; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--format" && i + 1 < argc) {
+            const std::string_view name = argv[++i];
+            format = nullptr;
+            for (const auto& entry : Formats) {
+                if (entry.name == name) {
+                    format = &entry;
+                }
+            }
+            if (!format)
+                return Usage();
+        } else if (argument == "--srgb") {
+            srgb = true;
+        } else if (argument == "--no-mips") {
+            mips = false;
+        } else if (argument == "--box") {
+            filter = Graphics::MipFilter::Box;
+        } else if (argument == "--threads" && i + 1 < argc) {
+            threads = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            return Usage();
+        }
+    }
+
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels = stbi_load(input, &width, &height, &channels, STBI_rgb_alpha);
+    if (!pixels) {
+        fprintf(stderr, "Failed to load %s: %s\n", input, stbi_failure_reason());
+        return 1;
+    }
+
+    // Single and two channel formats hold data rather than color, so they never get the sRGB treatment
+    srgb = srgb && format->srgb != format->linear;
+
+    const auto start = std::chrono::steady_clock::now();
+    Tools::JobSystem jobs(threads);
+    const auto layout = Graphics::GetMipChainLayout(static_cast<u32>(width), static_cast<u32>(height), mips ? 0 : 1);
+    std::vector<u8> chain(layout.size);
+    std::memcpy(chain.data(), pixels, static_cast<u64>(width) * static_cast<u64>(height) * 4);
+    stbi_image_free(pixels);
+    Graphics::GenerateMips(chain, layout, {.filter = filter, .srgb = srgb, .jobs = &jobs});
+
+    Graphics::DDSTexture texture;
+    texture.format = srgb ? format->srgb : format->linear;
+    texture.layout = Graphics::GetMipChainLayout(
+        static_cast<u32>(width), static_cast<u32>(height), static_cast<u32>(layout.levels.size()), texture.format
+    );
+    texture.data = Graphics::CompressTexture(chain, layout, {.format = texture.format, .jobs = &jobs});
+    if (!Graphics::WriteDDS(output, texture)) {
+        fprintf(stderr, "Failed to write %s\n", output);
+        return 1;
+    }
+
+    const auto milliseconds =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    printf(
+        "%s: %dx%d, %zu levels, %llu -> %llu bytes in %lld ms\n", output, width, height, layout.levels.size(),
+        static_cast<unsigned long long>(layout.size), static_cast<unsigned long long>(texture.layout.size),
+        static_cast<long long>(milliseconds)
+    );
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include "../graphics/core/texture_loader.h"
+#include "../vulkan/core/render_device_impl.h"
+
+using namespace Cocoa;
+
+namespace {
+    int Usage()
+    {
+        fprintf(
+            stderr,
+            "Usage: CocoaTextureDecodeBench <image>... [--threads N] [--repeat N] [--no-mips] [--srgb]\n"
+        );
+        return 1;
+    }
+} // namespace
+
+/// @brief Loads a set of images through TextureLoader with 1, 2, 4... up to N decode threads and reports throughput
+/// @note Wall time covers decoding, mip generation and upload until every texture is ready, the decode column only
+/// counts the time workers spent decoding
+int main(const int argc, char** argv)
+{
+    std::vector<std::filesystem::path> images;
+    u32 maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    u32 repeat = 4;
+    Graphics::TextureLoaderDesc loaderDesc;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--threads" && i + 1 < argc) {
+            maxThreads = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--repeat" && i + 1 < argc) {
+            repeat = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--no-mips") {
+            loaderDesc.generateMips = false;
+        } else if (argument == "--srgb") {
+            loaderDesc.srgb = true;
+        } else if (argument.starts_with("--")) {
+            return Usage();
+        } else {
+            images.emplace_back(argument);
+        }
+    }
+    if (images.empty() || maxThreads == 0 || repeat == 0)
+        return Usage();
+
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        PANIC("Failed to start SDL3");
+    }
+    SDL_Window* window = SDL_CreateWindow("CocoaTextureDecodeBench", 64, 64, SDL_WINDOW_HIDDEN | SDL_WINDOW_VULKAN);
+
+    {
+        Vulkan::RenderDeviceImpl device({
+            .window = window,
+            .desiredQueues = {Graphics::GPUQueueType::Graphics},
+            .pipelineCachePath = "",
+        });
+
+        printf("%zu images x %u\n", images.size(), repeat);
+        printf("threads   wall ms   images/s       MB/s   decode ms   decode MB/s\n");
+        double singleThreadMs = 0.0;
+        for (u32 threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+            loaderDesc.threadCount = threads;
+            Graphics::TextureLoader loader(device, loaderDesc);
+
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<Graphics::TextureLoadTicket> tickets;
+            for (u32 i = 0; i < repeat; i++) {
+                for (const auto& image : images) {
+                    tickets.push_back(loader.Load(image));
+                }
+            }
+            loader.WaitForAll();
+            const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                                      .count();
+
+            for (const auto ticket : tickets) {
+                if (loader.GetState(ticket) != Graphics::TextureLoadState::Ready)
+                    continue;
+                auto loaded = loader.GetTexture(ticket);
+                device.DestroyTextureView(loaded.view);
+                device.DestroyTexture(loaded.texture);
+            }
+
+            const auto stats = loader.GetStats();
+            const double megabytes = static_cast<double>(stats.decodedBytes) / (1024.0 * 1024.0);
+            const double decodeMs = std::chrono::duration<double, std::milli>(stats.decodeTime).count();
+            if (threads == 1) {
+                singleThreadMs = wallMs;
+            }
+            printf(
+                "%7u %9.1f %10.1f %10.1f %11.1f %13.1f  %.2fx%s\n", threads, wallMs, stats.uploaded * 1000.0 / wallMs,
+                megabytes * 1000.0 / wallMs, decodeMs, decodeMs > 0.0 ? megabytes * 1000.0 / decodeMs : 0.0,
+                singleThreadMs / wallMs, stats.failed ? "  (some images failed)" : ""
+            );
+
+            if (threads == maxThreads)
+                break;
+        }
+        device.WaitForIdle();
+    }
+
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace Cocoa::Tools {
+    ThreadPool::ThreadPool(u32 threadCount)
+    {
+        if (threadCount == 0) {
+            threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        }
+
+        _workers.reserve(threadCount);
+        for (u32 i = 0; i < threadCount; i++) {
+            _workers.emplace_back(&ThreadPool::WorkerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_all();
+
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::WaitForIdle()
+    {
+        std::unique_lock lock(_mutex);
+        _idle.wait(lock, [this] { return _tasks.empty() && _running == 0; });
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(_mutex);
+                _wake.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+                if (_tasks.empty())
+                    return;
+
+                task = std::move(_tasks.front());
+                _tasks.pop();
+                _running++;
+            }
+
+            task();
+
+            {
+                std::lock_guard lock(_mutex);
+                _running--;
+                if (_tasks.empty() && _running == 0) {
+                    _idle.notify_all();
+                }
+            }
+        }
+    }
+} // namespace Cocoa::Tools
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../common.h"
+
+namespace Cocoa::Tools {
+    /// @brief A fixed set of worker threads running submitted tasks
+    /// @note Tasks start in the order they were submitted, but with more than one worker they may finish in any order
+    class ThreadPool
+    {
+      public:
+        /// @param threadCount Number of workers to start, 0 picks one less than the hardware thread count
+        explicit ThreadPool(u32 threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// @brief Queues a task to run on a worker thread
+        /// @return A future holding the task's result, or the exception it threw
+        template <typename F> auto Submit(F&& task) -> std::future<std::invoke_result_t<F>>
+        {
+            using Result = std::invoke_result_t<F>;
+
+            // std::function needs a copyable target, so the move-only task lives behind a shared pointer
+            auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            auto future = packagedTask->get_future();
+            {
+                std::lock_guard lock(_mutex);
+                _tasks.emplace([packagedTask] { (*packagedTask)(); });
+            }
+            _wake.notify_one();
+            return future;
+        }
+
+        /// @brief Blocks until every queued task has finished
+        void WaitForIdle();
+
+        [[nodiscard]] u32 GetThreadCount() const { return static_cast<u32>(_workers.size()); }
+
+      private:
+        std::vector<std::thread> _workers;
+        std::queue<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _idle;
+        u32 _running = 0;
+        bool _stopping = false;
+
+        void WorkerLoop();
+    };
+} // namespace Cocoa::Tools
@@ -0,0 +1,166 @@
+#include "bindless_table.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Cocoa::Vulkan {
+    namespace {
+        // Upper bounds for each array, clamped further by what the device reports
+        constexpr uint32_t MaxTextures = 65536;
+        constexpr uint32_t MaxSamplers = 2048;
+        constexpr uint32_t MaxBuffers = 65536;
+    } // namespace
+
+    BindlessTable::BindlessTable(
+        const vk::Device device, const vk::PhysicalDeviceVulkan12Properties& properties, const uint32_t framesInFlight
+    )
+        : _device(device)
+    {
+        GetSlots(BindlessResourceType::Texture).capacity = std::min(
+            {MaxTextures, properties.maxDescriptorSetUpdateAfterBindSampledImages,
+             properties.maxPerStageDescriptorUpdateAfterBindSampledImages}
+        );
+        GetSlots(BindlessResourceType::Sampler).capacity = std::min(
+            {MaxSamplers, properties.maxDescriptorSetUpdateAfterBindSamplers,
+             properties.maxPerStageDescriptorUpdateAfterBindSamplers}
+        );
+        GetSlots(BindlessResourceType::Buffer).capacity = std::min(
+            {MaxBuffers, properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+             properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers}
+        );
+        for (auto& slots : _slots) {
+            slots.retired.resize(framesInFlight);
+        }
+
+        const auto textureCapacity = GetSlots(BindlessResourceType::Texture).capacity;
+        const auto samplerCapacity = GetSlots(BindlessResourceType::Sampler).capacity;
+        const auto bufferCapacity = GetSlots(BindlessResourceType::Buffer).capacity;
+
+        std::array bindings = {
+            vk::DescriptorSetLayoutBinding(
+                TextureBinding, vk::DescriptorType::eSampledImage, textureCapacity, vk::ShaderStageFlagBits::eAll
+            ),
+            vk::DescriptorSetLayoutBinding(
+                SamplerBinding, vk::DescriptorType::eSampler, samplerCapacity, vk::ShaderStageFlagBits::eAll
+            ),
+            vk::DescriptorSetLayoutBinding(
+                BufferBinding, vk::DescriptorType::eStorageBuffer, bufferCapacity, vk::ShaderStageFlagBits::eAll
+            ),
+        };
+
+        // Partially bound lets most of each array stay empty, update after bind lets new
+        // resources be written while earlier frames that don't use them are still in flight
+        constexpr vk::DescriptorBindingFlags bindingFlags = vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                                            vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                            vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+        std::array allBindingFlags = {bindingFlags, bindingFlags, bindingFlags};
+
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsDescriptor{};
+        bindingFlagsDescriptor.setBindingFlags(allBindingFlags);
+
+        vk::DescriptorSetLayoutCreateInfo layoutDescriptor{};
+        layoutDescriptor.setPNext(&bindingFlagsDescriptor)
+            .setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool)
+            .setBindings(bindings);
+        _layout = _device.createDescriptorSetLayoutUnique(layoutDescriptor);
+
+        std::array poolSizes = {
+            vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, textureCapacity),
+            vk::DescriptorPoolSize(vk::DescriptorType::eSampler, samplerCapacity),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, bufferCapacity),
+        };
+
+        vk::DescriptorPoolCreateInfo poolDescriptor{};
+        poolDescriptor.setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind)
+            .setMaxSets(1)
+            .setPoolSizes(poolSizes);
+        _pool = _device.createDescriptorPoolUnique(poolDescriptor);
+
+        const auto layout = _layout.get();
+        vk::DescriptorSetAllocateInfo allocateDescriptor{};
+        allocateDescriptor.setDescriptorPool(_pool.get()).setSetLayouts(layout);
+        _set = _device.allocateDescriptorSets(allocateDescriptor).front();
+    }
+
+    uint32_t BindlessTable::Add(const vk::ImageView view)
+    {
+        const auto index = Allocate(BindlessResourceType::Texture);
+
+        vk::DescriptorImageInfo imageDescriptor{};
+        imageDescriptor.setImageView(view).setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+
+        vk::WriteDescriptorSet write{};
+        write.setDstSet(_set)
+            .setDstBinding(TextureBinding)
+            .setDstArrayElement(index)
+            .setDescriptorType(vk::DescriptorType::eSampledImage)
+            .setImageInfo(imageDescriptor);
+        _device.updateDescriptorSets(write, nullptr);
+        return index;
+    }
+
+    uint32_t BindlessTable::Add(const vk::Sampler sampler)
+    {
+        const auto index = Allocate(BindlessResourceType::Sampler);
+
+        vk::DescriptorImageInfo samplerDescriptor{};
+        samplerDescriptor.setSampler(sampler);
+
+        vk::WriteDescriptorSet write{};
+        write.setDstSet(_set)
+            .setDstBinding(SamplerBinding)
+            .setDstArrayElement(index)
+            .setDescriptorType(vk::DescriptorType::eSampler)
+            .setImageInfo(samplerDescriptor);
+        _device.updateDescriptorSets(write, nullptr);
+        return index;
+    }
+
+    uint32_t BindlessTable::Add(const vk::Buffer buffer)
+    {
+        const auto index = Allocate(BindlessResourceType::Buffer);
+
+        vk::DescriptorBufferInfo bufferDescriptor{};
+        bufferDescriptor.setBuffer(buffer).setOffset(0).setRange(vk::WholeSize);
+
+        vk::WriteDescriptorSet write{};
+        write.setDstSet(_set)
+            .setDstBinding(BufferBinding)
+            .setDstArrayElement(index)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(bufferDescriptor);
+        _device.updateDescriptorSets(write, nullptr);
+        return index;
+    }
+
+    void BindlessTable::Remove(const BindlessResourceType type, const uint32_t index)
+    {
+        // The descriptor is left as is, partially bound arrays only require that shaders never read it
+        GetSlots(type).retired[_frame].push_back(index);
+    }
+
+    void BindlessTable::NextFrame(const uint32_t frame)
+    {
+        _frame = frame;
+        for (auto& slots : _slots) {
+            auto& retired = slots.retired[frame];
+            slots.free.insert(slots.free.end(), retired.begin(), retired.end());
+            retired.clear();
+        }
+    }
+
+    uint32_t BindlessTable::Allocate(const BindlessResourceType type)
+    {
+        auto& slots = GetSlots(type);
+        if (!slots.free.empty()) {
+            const auto index = slots.free.back();
+            slots.free.pop_back();
+            return index;
+        }
+
+        if (slots.next >= slots.capacity) {
+            PANIC("Bindless table ran out of slots, %u are in use", slots.capacity);
+        }
+        return slots.next++;
+    }
+} // namespace Cocoa::Vulkan
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include "../../macros.h"
+#include "../utils/common.h"
+
+namespace Cocoa::Vulkan {
+    enum class BindlessResourceType : uint32_t
+    {
+        Texture,
+        Sampler,
+        Buffer
+    };
+
+    /// @brief A single descriptor set holding every sampled texture, sampler and storage buffer in arrays
+    /// @note Shaders index the arrays directly, so the set only has to be bound once per pipeline layout
+    class BindlessTable
+    {
+      public:
+        static constexpr uint32_t TextureBinding = 0;
+        static constexpr uint32_t SamplerBinding = 1;
+        static constexpr uint32_t BufferBinding = 2;
+
+        BindlessTable(
+            vk::Device device, const vk::PhysicalDeviceVulkan12Properties& properties, uint32_t framesInFlight
+        );
+
+        BindlessTable(const BindlessTable&) = delete;
+        BindlessTable& operator=(const BindlessTable&) = delete;
+
+        /// @return The index shaders use to find the resource, stable until it's removed
+        uint32_t Add(vk::ImageView view);
+        uint32_t Add(vk::Sampler sampler);
+        uint32_t Add(vk::Buffer buffer);
+
+        /// @brief Frees an index once the frames that could still be reading it have finished
+        void Remove(BindlessResourceType type, uint32_t index);
+
+        /// @brief Recycles the indices that were removed the last time this frame slot was recorded
+        void NextFrame(uint32_t frame);
+
+        [[nodiscard]] vk::DescriptorSetLayout GetLayout() const { return _layout.get(); }
+        [[nodiscard]] vk::DescriptorSet GetSet() const { return _set; }
+
+      private:
+        struct Slots
+        {
+            uint32_t capacity = 0;
+            uint32_t next = 0;
+            std::vector<uint32_t> free;
+            std::vector<std::vector<uint32_t>> retired;
+        };
+
+        vk::Device _device;
+        vk::UniqueDescriptorPool _pool;
+        vk::UniqueDescriptorSetLayout _layout;
+        vk::DescriptorSet _set;
+        Slots _slots[3];
+        uint32_t _frame = 0;
+
+        uint32_t Allocate(BindlessResourceType type);
+        Slots& GetSlots(BindlessResourceType type) { return _slots[static_cast<uint32_t>(type)]; }
+    };
+} // namespace Cocoa::Vulkan
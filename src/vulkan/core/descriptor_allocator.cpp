@@ -0,0 +1,127 @@
+#include "descriptor_allocator.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Cocoa::Vulkan {
+    namespace {
+        constexpr uint32_t InitialPoolSets = 256;
+        constexpr uint32_t MaxPoolSets = 4096;
+
+        struct PoolRatio
+        {
+            vk::DescriptorType type;
+            float perSet;
+        };
+
+        // Descriptors reserved per set, sized for the bind group layouts this renderer uses
+        constexpr std::array PoolRatios = {
+            PoolRatio{vk::DescriptorType::eUniformBuffer, 2.0f},
+            PoolRatio{vk::DescriptorType::eStorageBuffer, 1.0f},
+            PoolRatio{vk::DescriptorType::eSampledImage, 4.0f},
+            PoolRatio{vk::DescriptorType::eSampler, 2.0f},
+        };
+    } // namespace
+
+    DescriptorAllocator::DescriptorAllocator(const vk::Device device, const uint32_t framesInFlight)
+        : _device(device), _nextPersistentPoolSets(InitialPoolSets), _nextTransientPoolSets(InitialPoolSets)
+    {
+        _retiredSets.resize(framesInFlight);
+        _framePools.resize(framesInFlight);
+    }
+
+    vk::DescriptorSet DescriptorAllocator::AllocatePersistent(const vk::DescriptorSetLayout layout)
+    {
+        if (auto recycled = _recycledSets.find(layout); recycled != _recycledSets.end() && !recycled->second.empty()) {
+            const auto set = recycled->second.back();
+            recycled->second.pop_back();
+            return set;
+        }
+
+        vk::DescriptorSet set;
+        if (!_persistentPools.empty() && TryAllocate(_persistentPools.back().get(), layout, set))
+            return set;
+
+        _persistentPools.push_back(CreatePool(_nextPersistentPoolSets));
+        _nextPersistentPoolSets = std::min(_nextPersistentPoolSets * 2, MaxPoolSets);
+        if (!TryAllocate(_persistentPools.back().get(), layout, set)) {
+            PANIC("Failed to allocate a descriptor set from a fresh pool");
+        }
+        return set;
+    }
+
+    void DescriptorAllocator::ReleasePersistent(const vk::DescriptorSetLayout layout, const vk::DescriptorSet set)
+    {
+        _retiredSets[_frame].push_back({layout, set});
+    }
+
+    vk::DescriptorSet DescriptorAllocator::AllocateTransient(const vk::DescriptorSetLayout layout)
+    {
+        auto& pools = _framePools[_frame];
+
+        vk::DescriptorSet set;
+        if (!pools.empty() && TryAllocate(pools.back().get(), layout, set))
+            return set;
+
+        // Out of room, move on to a pool another frame already reset or grow with a larger one
+        if (!_readyPools.empty()) {
+            pools.push_back(std::move(_readyPools.back()));
+            _readyPools.pop_back();
+        } else {
+            pools.push_back(CreatePool(_nextTransientPoolSets));
+            _nextTransientPoolSets = std::min(_nextTransientPoolSets * 2, MaxPoolSets);
+        }
+
+        if (!TryAllocate(pools.back().get(), layout, set)) {
+            PANIC("Failed to allocate a descriptor set from a fresh pool");
+        }
+        return set;
+    }
+
+    void DescriptorAllocator::BeginFrame(const uint32_t frame)
+    {
+        _frame = frame;
+
+        for (auto& pool : _framePools[frame]) {
+            _device.resetDescriptorPool(pool.get());
+            _readyPools.push_back(std::move(pool));
+        }
+        _framePools[frame].clear();
+
+        for (const auto& [layout, set] : _retiredSets[frame]) {
+            _recycledSets[layout].push_back(set);
+        }
+        _retiredSets[frame].clear();
+    }
+
+    vk::UniqueDescriptorPool DescriptorAllocator::CreatePool(const uint32_t maxSets) const
+    {
+        std::vector<vk::DescriptorPoolSize> poolSizes;
+        poolSizes.reserve(PoolRatios.size());
+        for (const auto& [type, perSet] : PoolRatios) {
+            poolSizes.emplace_back(type, static_cast<uint32_t>(perSet * static_cast<float>(maxSets)));
+        }
+
+        // No free flag, sets are never freed individually which keeps the pools from fragmenting
+        vk::DescriptorPoolCreateInfo poolDescriptor{};
+        poolDescriptor.setMaxSets(maxSets).setPoolSizes(poolSizes);
+        return _device.createDescriptorPoolUnique(poolDescriptor);
+    }
+
+    bool DescriptorAllocator::TryAllocate(
+        const vk::DescriptorPool pool, const vk::DescriptorSetLayout layout, vk::DescriptorSet& set
+    ) const
+    {
+        vk::DescriptorSetAllocateInfo allocateDescriptor{};
+        allocateDescriptor.setDescriptorPool(pool).setSetLayouts(layout);
+
+        // The pointer overload reports exhaustion as a result instead of throwing
+        const auto result = _device.allocateDescriptorSets(&allocateDescriptor, &set);
+        if (result == vk::Result::eErrorOutOfPoolMemory || result == vk::Result::eErrorFragmentedPool)
+            return false;
+        if (result != vk::Result::eSuccess) {
+            PANIC("Failed to allocate a descriptor set");
+        }
+        return true;
+    }
+} // namespace Cocoa::Vulkan
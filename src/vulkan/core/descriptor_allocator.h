@@ -0,0 +1,56 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "../../macros.h"
+#include "../utils/common.h"
+
+namespace Cocoa::Vulkan {
+    /// @brief Hands out descriptor sets from growable pools without freeing sets one by one
+    /// @note Transient sets come from per-frame pools that are reset in bulk when the frame slot is reused,
+    /// persistent sets live in their own pools and are recycled per layout once no frame can still use them
+    class DescriptorAllocator
+    {
+      public:
+        DescriptorAllocator(vk::Device device, uint32_t framesInFlight);
+
+        DescriptorAllocator(const DescriptorAllocator&) = delete;
+        DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+        /// @brief Allocates a set that stays valid until it's released
+        vk::DescriptorSet AllocatePersistent(vk::DescriptorSetLayout layout);
+
+        /// @brief Hands a persistent set back, it's reused for the same layout after the current frame retires
+        void ReleasePersistent(vk::DescriptorSetLayout layout, vk::DescriptorSet set);
+
+        /// @brief Allocates a set that's only valid for the frame currently being recorded
+        vk::DescriptorSet AllocateTransient(vk::DescriptorSetLayout layout);
+
+        /// @brief Resets the transient pools of a frame slot whose previous work has finished on the GPU
+        void BeginFrame(uint32_t frame);
+
+      private:
+        struct RetiredSet
+        {
+            vk::DescriptorSetLayout layout;
+            vk::DescriptorSet set;
+        };
+
+        vk::Device _device;
+        uint32_t _frame = 0;
+
+        std::vector<vk::UniqueDescriptorPool> _persistentPools;
+        std::unordered_map<vk::DescriptorSetLayout, std::vector<vk::DescriptorSet>> _recycledSets;
+        std::vector<std::vector<RetiredSet>> _retiredSets;
+        uint32_t _nextPersistentPoolSets;
+
+        /// @brief Pools each frame slot allocated from, the last one is the one still being filled
+        std::vector<std::vector<vk::UniqueDescriptorPool>> _framePools;
+        std::vector<vk::UniqueDescriptorPool> _readyPools;
+        uint32_t _nextTransientPoolSets;
+
+        vk::UniqueDescriptorPool CreatePool(uint32_t maxSets) const;
+        bool TryAllocate(vk::DescriptorPool pool, vk::DescriptorSetLayout layout, vk::DescriptorSet& set) const;
+    };
+} // namespace Cocoa::Vulkan
@@ -0,0 +1,40 @@
+#include "descriptor_writer.h"
+
+namespace Cocoa::Vulkan {
+    namespace {
+        bool IsBufferDescriptor(const vk::DescriptorType type)
+        {
+            return type == vk::DescriptorType::eUniformBuffer || type == vk::DescriptorType::eStorageBuffer;
+        }
+    } // namespace
+
+    void DescriptorWriter::Write(
+        const vk::DescriptorSet set, const uint32_t binding, const vk::DescriptorType type, const DescriptorInfo& info
+    )
+    {
+        vk::WriteDescriptorSet write{};
+        write.setDstSet(set).setDstBinding(binding).setDescriptorCount(1).setDescriptorType(type);
+        _writes.push_back(write);
+        _infos.push_back(info);
+    }
+
+    void DescriptorWriter::Flush()
+    {
+        if (_writes.empty())
+            return;
+
+        // Infos can move while writes are queued, so the pointers are only filled in now
+        for (usize i = 0; i < _writes.size(); i++) {
+            auto& write = _writes[i];
+            if (IsBufferDescriptor(write.descriptorType)) {
+                write.setPBufferInfo(reinterpret_cast<const vk::DescriptorBufferInfo*>(&_infos[i].buffer));
+            } else {
+                write.setPImageInfo(reinterpret_cast<const vk::DescriptorImageInfo*>(&_infos[i].image));
+            }
+        }
+
+        _device.updateDescriptorSets(_writes, nullptr);
+        _writes.clear();
+        _infos.clear();
+    }
+} // namespace Cocoa::Vulkan
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "../utils/common.h"
+
+namespace Cocoa::Vulkan {
+    /// @brief What a single descriptor points at, packed the way descriptor update templates read it
+    union DescriptorInfo
+    {
+        VkDescriptorImageInfo image;
+        VkDescriptorBufferInfo buffer;
+    };
+
+    /// @brief Collects descriptor writes so they reach the driver in a single updateDescriptorSets call
+    class DescriptorWriter
+    {
+      public:
+        explicit DescriptorWriter(vk::Device device) : _device(device) {}
+
+        void Write(vk::DescriptorSet set, uint32_t binding, vk::DescriptorType type, const DescriptorInfo& info);
+
+        /// @brief Sends every queued write to the driver
+        /// @note Must happen before a written set is bound or its pool is reset
+        void Flush();
+
+        [[nodiscard]] bool HasPendingWrites() const { return !_writes.empty(); }
+
+      private:
+        vk::Device _device;
+        std::vector<vk::WriteDescriptorSet> _writes;
+        std::vector<DescriptorInfo> _infos;
+    };
+} // namespace Cocoa::Vulkan
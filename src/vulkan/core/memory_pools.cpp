@@ -0,0 +1,110 @@
+#include "memory_pools.h"
+
+namespace Cocoa::Vulkan {
+    namespace {
+        constexpr vk::DeviceSize UniformBlockSize = 4ull * 1024 * 1024;
+        constexpr vk::DeviceSize GeometryBlockSize = 64ull * 1024 * 1024;
+        constexpr vk::DeviceSize RenderTargetBlockSize = 128ull * 1024 * 1024;
+
+        const auto GeometryUsage = Graphics::GPUBufferUsage::Vertex | Graphics::GPUBufferUsage::Index |
+                                   Graphics::GPUBufferUsage::TransferSrc | Graphics::GPUBufferUsage::TransferDst;
+    } // namespace
+
+    MemoryPools::MemoryPools(const VmaAllocator allocator) : _allocator(allocator)
+    {
+        // Pools are tied to one memory type, found by asking VMA where a representative resource would go
+        uint32_t memoryTypeIndex = 0;
+
+        vk::BufferCreateInfo uniformDescriptor{};
+        uniformDescriptor.setSize(MaxPooledUniformSize).setUsage(vk::BufferUsageFlagBits::eUniformBuffer);
+        const VkBufferCreateInfo rawUniformDescriptor = uniformDescriptor;
+        VmaAllocationCreateInfo uniformAllocationDescriptor{};
+        uniformAllocationDescriptor.usage = VMA_MEMORY_USAGE_AUTO;
+        uniformAllocationDescriptor.flags = GPUMemoryAccessToVma(Graphics::GPUMemoryAccess::CPUToGPU);
+        if (vmaFindMemoryTypeIndexForBufferInfo(
+                _allocator, &rawUniformDescriptor, &uniformAllocationDescriptor, &memoryTypeIndex
+            ) == VK_SUCCESS) {
+            _pools[static_cast<uint32_t>(MemoryPoolType::Uniform)] = CreatePool(memoryTypeIndex, UniformBlockSize);
+        }
+
+        vk::BufferCreateInfo geometryDescriptor{};
+        geometryDescriptor.setSize(GeometryBlockSize).setUsage(GPUBufferUsageToVk(GeometryUsage));
+        const VkBufferCreateInfo rawGeometryDescriptor = geometryDescriptor;
+        VmaAllocationCreateInfo geometryAllocationDescriptor{};
+        geometryAllocationDescriptor.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        if (vmaFindMemoryTypeIndexForBufferInfo(
+                _allocator, &rawGeometryDescriptor, &geometryAllocationDescriptor, &memoryTypeIndex
+            ) == VK_SUCCESS) {
+            _pools[static_cast<uint32_t>(MemoryPoolType::Geometry)] = CreatePool(memoryTypeIndex, GeometryBlockSize);
+        }
+
+        vk::ImageCreateInfo renderTargetDescriptor{};
+        renderTargetDescriptor.setImageType(vk::ImageType::e2D)
+            .setFormat(vk::Format::eR8G8B8A8Unorm)
+            .setExtent(vk::Extent3D(1024, 1024, 1))
+            .setMipLevels(1)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled);
+        const VkImageCreateInfo rawRenderTargetDescriptor = renderTargetDescriptor;
+        VmaAllocationCreateInfo renderTargetAllocationDescriptor{};
+        renderTargetAllocationDescriptor.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        if (vmaFindMemoryTypeIndexForImageInfo(
+                _allocator, &rawRenderTargetDescriptor, &renderTargetAllocationDescriptor, &memoryTypeIndex
+            ) == VK_SUCCESS) {
+            _pools[static_cast<uint32_t>(MemoryPoolType::RenderTarget)] =
+                CreatePool(memoryTypeIndex, RenderTargetBlockSize);
+        }
+    }
+
+    MemoryPools::~MemoryPools()
+    {
+        for (const auto pool : _pools) {
+            if (pool) {
+                vmaDestroyPool(_allocator, pool);
+            }
+        }
+    }
+
+    VmaPool MemoryPools::SelectBufferPool(const Graphics::GPUBufferDesc& desc) const
+    {
+        const auto usage = static_cast<uint32_t>(desc.usage);
+
+        if (desc.access == Graphics::GPUMemoryAccess::CPUToGPU && desc.size <= MaxPooledUniformSize &&
+            (usage & ~static_cast<uint32_t>(Graphics::GPUBufferUsage::Uniform)) == 0) {
+            return GetPool(MemoryPoolType::Uniform);
+        }
+
+        // Only buffers that are never written into descriptors can be moved by defragmentation
+        if (desc.access == Graphics::GPUMemoryAccess::GPUOnly &&
+            (usage & ~static_cast<uint32_t>(GeometryUsage)) == 0 &&
+            desc.usage & (Graphics::GPUBufferUsage::Vertex | Graphics::GPUBufferUsage::Index)) {
+            return GetPool(MemoryPoolType::Geometry);
+        }
+        return nullptr;
+    }
+
+    VmaPool MemoryPools::SelectTexturePool(const Graphics::GPUTextureDesc& desc, const vk::DeviceSize size) const
+    {
+        if (size >= DedicatedImageSize)
+            return nullptr;
+        if (desc.usage & (Graphics::GPUTextureUsage::RenderTarget | Graphics::GPUTextureUsage::DepthStencil))
+            return GetPool(MemoryPoolType::RenderTarget);
+        return nullptr;
+    }
+
+    VmaPool MemoryPools::CreatePool(const uint32_t memoryTypeIndex, const vk::DeviceSize blockSize) const
+    {
+        VmaPoolCreateInfo poolDescriptor{};
+        poolDescriptor.memoryTypeIndex = memoryTypeIndex;
+        poolDescriptor.blockSize = blockSize;
+
+        VmaPool pool = nullptr;
+        if (vmaCreatePool(_allocator, &poolDescriptor, &pool) != VK_SUCCESS) {
+            PUSH_WARN("Failed to create a memory pool, its resources fall back to the default pools");
+            return nullptr;
+        }
+        return pool;
+    }
+} // namespace Cocoa::Vulkan
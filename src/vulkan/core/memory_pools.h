@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+
+#include "../../graphics/utils/descriptors.h"
+#include "../../macros.h"
+#include "../utils/common.h"
+
+namespace Cocoa::Vulkan {
+    enum class MemoryPoolType : uint32_t
+    {
+        /// @brief Small CPU-written uniform buffers, packed into a few host visible blocks
+        Uniform,
+        /// @brief GPU-only vertex and index buffers, the only pool that gets defragmented
+        Geometry,
+        /// @brief Color and depth attachments
+        RenderTarget,
+        Count
+    };
+
+    /// @brief Custom VMA pools that keep allocations with similar lifetimes and memory types together
+    class MemoryPools
+    {
+      public:
+        /// @brief Buffers at or under this size qualify for the uniform pool
+        static constexpr vk::DeviceSize MaxPooledUniformSize = 64 * 1024;
+        /// @brief Images at or above this size get their own VkDeviceMemory
+        static constexpr vk::DeviceSize DedicatedImageSize = 16 * 1024 * 1024;
+
+        explicit MemoryPools(VmaAllocator allocator);
+        ~MemoryPools();
+
+        MemoryPools(const MemoryPools&) = delete;
+        MemoryPools& operator=(const MemoryPools&) = delete;
+
+        /// @return The pool a buffer belongs in, or nullptr for VMA's default pools
+        [[nodiscard]] VmaPool SelectBufferPool(const Graphics::GPUBufferDesc& desc) const;
+
+        /// @return The pool a texture belongs in, or nullptr for VMA's default pools
+        [[nodiscard]] VmaPool SelectTexturePool(const Graphics::GPUTextureDesc& desc, vk::DeviceSize size) const;
+
+        [[nodiscard]] VmaPool GetPool(MemoryPoolType type) const { return _pools[static_cast<uint32_t>(type)]; }
+
+      private:
+        VmaAllocator _allocator;
+        std::array<VmaPool, static_cast<uint32_t>(MemoryPoolType::Count)> _pools{};
+
+        VmaPool CreatePool(uint32_t memoryTypeIndex, vk::DeviceSize blockSize) const;
+    };
+} // namespace Cocoa::Vulkan
@@ -3,18 +3,30 @@
 //
 
 #include "render_device_impl.h"
+#include "render_encoder_impl.h"
 
 #include <SDL3/SDL_vulkan.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <map>
 #include <ranges>
+#include <span>
+#include <string_view>
 
 namespace Cocoa::Vulkan {
     RenderDeviceImpl::RenderDeviceImpl(const Graphics::RenderDeviceDesc& desc)
+        : _bindless(desc.bindless), _pipelineCachePath(desc.pipelineCachePath)
     {
         AddManager<Buffer>();
         AddManager<Texture>();
         AddManager<TextureView>();
         AddManager<BindGroup>();
+        AddManager<BindGroupLayout>();
+        AddManager<MemoryHeap>();
+        AddManager<ShaderModule>();
+        AddManager<Sampler>();
         AddManager<Pipeline>();
         AddManager<PipelineLayout>();
 
@@ -26,21 +38,44 @@ namespace Cocoa::Vulkan {
         CreateCommandPool();
         CreateCommandBuffers();
         CreateImmediateResources();
-        CreateDescriptorPool();
+        CreateDescriptorAllocator();
+        CreateBindlessTable();
+        CreatePipelineCache();
+
+        _pipelineCompiler = std::make_unique<Tools::ThreadPool>(desc.pipelineCompileThreads);
     }
 
     RenderDeviceImpl::~RenderDeviceImpl()
     {
+        // Joining the compiler first guarantees no worker touches the device while it's torn down
+        _pipelineCompiler.reset();
         _device->waitIdle();
 
+        if (_defragmentation.context) {
+            if (_defragmentation.passPending) {
+                EndDefragmentationPass();
+            }
+            vmaEndDefragmentation(_allocator, _defragmentation.context, nullptr);
+        }
+
         _resourceManagers.clear();
+        for (auto& retired : _retiredPipelines) {
+            retired.clear();
+        }
 
-        _descriptorPool.reset();
+        SavePipelineCache();
+        _pipelineCache.reset();
+
+        _bindlessTable.reset();
+        _descriptorWriter.reset();
+        _descriptorAllocator.reset();
         _commandBuffers.clear();
+        _frameFences.clear();
         _immediateCommandBuffer.reset();
         _immediateFence.reset();
         _commandPool.reset();
 
+        _memoryPools.reset();
         vmaDestroyAllocator(_allocator);
         _allocator = nullptr;
 
@@ -51,64 +86,787 @@ namespace Cocoa::Vulkan {
 
     Graphics::RenderWindowHandle RenderDeviceImpl::ConnectWindow(const Graphics::RenderWindowDesc& desc) {}
 
-    Graphics::GPUBufferHandle RenderDeviceImpl::CreateBuffer(const Graphics::GPUBufferDesc& desc) {}
+    Graphics::GPUBufferHandle RenderDeviceImpl::CreateBuffer(const Graphics::GPUBufferDesc& desc)
+    {
+        const auto pool = _memoryPools->SelectBufferPool(desc);
+
+        // Defragmentation copies geometry buffers around, so they need to be both copy source and destination
+        auto usage = GPUBufferUsageToVk(desc.usage);
+        if (pool && pool == _memoryPools->GetPool(MemoryPoolType::Geometry)) {
+            usage |= vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst;
+        }
+
+        vk::BufferCreateInfo bufferDescriptor{};
+        bufferDescriptor.setSize(desc.size).setUsage(usage).setSharingMode(vk::SharingMode::eExclusive);
+        const VkBufferCreateInfo rawBufferDescriptor = bufferDescriptor;
+
+        VmaAllocationCreateInfo allocationDescriptor{};
+        allocationDescriptor.usage = VMA_MEMORY_USAGE_AUTO;
+        allocationDescriptor.flags = GPUMemoryAccessToVma(desc.access);
+        allocationDescriptor.pool = pool;
+
+        Buffer buffer{};
+        VkBuffer rawBuffer = VK_NULL_HANDLE;
+        VmaAllocationInfo allocationInfo{};
+        VkResult createBuffer = vmaCreateBuffer(
+            _allocator, &rawBufferDescriptor, &allocationDescriptor, &rawBuffer, &buffer.allocation, &allocationInfo
+        );
+        if (createBuffer != VK_SUCCESS && pool) {
+            allocationDescriptor.pool = nullptr;
+            createBuffer = vmaCreateBuffer(
+                _allocator, &rawBufferDescriptor, &allocationDescriptor, &rawBuffer, &buffer.allocation,
+                &allocationInfo
+            );
+        }
+        if (createBuffer != VK_SUCCESS) {
+            PANIC("Failed to create buffer");
+        }
+        buffer.buffer = rawBuffer;
+        buffer.mapped = allocationInfo.pMappedData;
+        buffer.size = desc.size;
+        buffer.usage = usage;
+        if (_bindlessTable && desc.usage & Graphics::GPUBufferUsage::Storage) {
+            buffer.bindlessIndex = _bindlessTable->Add(buffer.buffer);
+        }
+
+        // Initial contents can only be written directly when the CPU can see the buffer
+        if (desc.mapped) {
+            if (!buffer.mapped) {
+                PANIC("Initial data was given for a buffer that the CPU cannot write to");
+            }
+            memcpy(buffer.mapped, desc.mapped, desc.size);
+        }
+
+        // Defragmentation finds the buffer that owns a moved allocation through its user data
+        const auto allocation = buffer.allocation;
+        const auto handle = GetManager<Buffer>()->Create(std::move(buffer));
+        vmaSetAllocationUserData(_allocator, allocation, reinterpret_cast<void*>(static_cast<uintptr_t>(handle.id)));
+        return handle;
+    }
+
+    Graphics::GPUTextureHandle RenderDeviceImpl::CreateTexture(const Graphics::GPUTextureDesc& desc)
+    {
+        Texture texture{};
+        texture.format = desc.format;
+        texture.extent = {desc.scale.w, desc.scale.h, std::max(desc.scale.d, 1u)};
+        texture.levels = desc.levels;
+        texture.layers = desc.layers;
+        texture.usage = desc.usage;
+
+        if (desc.external) {
+            // Externally owned images (e.g. swapchain images) are only wrapped, never allocated
+            texture.image = static_cast<VkImage>(desc.external);
+            texture.states.assign(desc.levels * desc.layers, desc.initialLayout);
+            return GetManager<Texture>()->Create(std::move(texture));
+        }
+
+        if (!_blockCompressionSupported && std::holds_alternative<Graphics::GPUColorFormat>(desc.format) &&
+            Graphics::IsBlockCompressedFormat(std::get<Graphics::GPUColorFormat>(desc.format))) {
+            PANIC("Tried to create a block compressed texture on a GPU without BC support");
+        }
+
+        const VkImageCreateInfo rawImageDescriptor = GetImageDescriptor(desc);
+        const auto size = GetTextureMemoryRequirements(desc).size;
+        const auto pool = _memoryPools->SelectTexturePool(desc, size);
+
+        VmaAllocationCreateInfo allocationDescriptor{};
+        allocationDescriptor.usage = VMA_MEMORY_USAGE_AUTO;
+        allocationDescriptor.flags = GPUMemoryAccessToVma(desc.access);
+        allocationDescriptor.pool = pool;
+        if (pool) {
+            // Attachments are never touched by the CPU, the pool already picked device local memory
+            allocationDescriptor.flags = 0;
+        } else if (size >= MemoryPools::DedicatedImageSize) {
+            // Large images would pin whole shared blocks and fragment them, they get memory of their own
+            allocationDescriptor.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        }
+
+        VkImage rawImage = VK_NULL_HANDLE;
+        VkResult createImage = vmaCreateImage(
+            _allocator, &rawImageDescriptor, &allocationDescriptor, &rawImage, &texture.allocation, nullptr
+        );
+        if (createImage != VK_SUCCESS && pool) {
+            // Some formats (depth on certain GPUs) can't live in the pool's memory type
+            allocationDescriptor.pool = nullptr;
+            createImage = vmaCreateImage(
+                _allocator, &rawImageDescriptor, &allocationDescriptor, &rawImage, &texture.allocation, nullptr
+            );
+        }
+        if (createImage != VK_SUCCESS) {
+            PANIC("Failed to create texture");
+        }
+        texture.image = rawImage;
+        texture.allocatedImage = true;
+        texture.states.assign(desc.levels * desc.layers, Graphics::GPUTextureState::Unknown);
+
+        return GetManager<Texture>()->Create(std::move(texture));
+    }
+
+    Graphics::GPUTextureViewHandle RenderDeviceImpl::CreateTextureView(const Graphics::GPUTextureViewDesc& desc)
+    {
+        auto textureHandle = desc.texture;
+        const auto texture = GetTexture(textureHandle);
+        if (!texture) {
+            PANIC("Tried to create a view of an invalid texture");
+        }
+
+        // Views without a format inherit the texture's format
+        auto format = desc.format;
+        if (std::holds_alternative<Graphics::GPUColorFormat>(format) &&
+            std::get<Graphics::GPUColorFormat>(format) == Graphics::GPUColorFormat::Unknown) {
+            format = texture->format;
+        }
+
+        vk::ImageSubresourceRange viewSubresourceRange{};
+        viewSubresourceRange.setAspectMask(GPUTextureAspectToVk(desc.aspect))
+            .setBaseMipLevel(desc.firstLevel)
+            .setLevelCount(desc.levels)
+            .setBaseArrayLayer(desc.firstLayer)
+            .setLayerCount(desc.layers);
+
+        vk::ImageViewCreateInfo viewDescriptor{};
+        viewDescriptor.setImage(texture->image)
+            .setViewType(GPUTextureViewTypeToVk(desc.type))
+            .setFormat(GPUTextureFormatToVk(format))
+            .setSubresourceRange(viewSubresourceRange);
+
+        TextureView textureView{.view = _device->createImageViewUnique(viewDescriptor), .aspect = desc.aspect};
+
+        // Shaders declare the bindless texture array as texture2D, so only 2D views can be placed in it
+        if (_bindlessTable && texture->usage & Graphics::GPUTextureUsage::ShaderUsage &&
+            desc.type == Graphics::GPUTextureViewType::TwoDimensional) {
+            textureView.bindlessIndex = _bindlessTable->Add(textureView.view.get());
+        }
+        return GetManager<TextureView>()->Create(std::move(textureView));
+    }
+
+    Graphics::GPUSamplerHandle RenderDeviceImpl::CreateSampler(const Graphics::GPUSamplerDesc& desc)
+    {
+        if (const auto shared = _sharedSamplers.Acquire(desc))
+            return *shared;
+
+        vk::SamplerCreateInfo samplerDescriptor{};
+        samplerDescriptor.setMagFilter(GPUFilterToVk(desc.magnification))
+            .setMinFilter(GPUFilterToVk(desc.minification))
+            .setMipmapMode(GPUMipMapModeToVk(desc.mipmapMode))
+            .setAddressModeU(GPUWrappingModeToVk(desc.horizontalWrapping))
+            .setAddressModeV(GPUWrappingModeToVk(desc.verticalWrapping))
+            .setAddressModeW(GPUWrappingModeToVk(desc.depthWrapping))
+            .setMinLod(desc.minLevel)
+            .setMaxLod(desc.maxLevel)
+            .setMipLodBias(desc.levelBias);
+
+        Sampler sampler{.sampler = _device->createSamplerUnique(samplerDescriptor)};
+        if (_bindlessTable) {
+            sampler.bindlessIndex = _bindlessTable->Add(sampler.sampler.get());
+        }
+        const auto handle = GetManager<Sampler>()->Create(std::move(sampler));
+        _sharedSamplers.Insert(desc, handle);
+        return handle;
+    }
+
+    Graphics::GPUBindGroupHandle RenderDeviceImpl::CreateBindGroup(const Graphics::GPUBindGroupDesc& desc)
+    {
+        auto layoutHandle = desc.layout;
+        const auto bindGroupLayout = GetBindGroupLayout(layoutHandle);
+        if (!bindGroupLayout) {
+            PANIC("Bind group references an invalid bind group layout");
+        }
+
+        const auto layout = bindGroupLayout->layout.get();
+        BindGroup bindGroup{
+            .set = desc.transient ? _descriptorAllocator->AllocateTransient(layout)
+                                  : _descriptorAllocator->AllocatePersistent(layout),
+            .layout = layout,
+            .transient = desc.transient
+        };
+
+        WriteBindGroup(bindGroup.set, *bindGroupLayout, desc.entries);
+
+        const auto handle = GetManager<BindGroup>()->Create(std::move(bindGroup));
+        if (desc.transient) {
+            _transientBindGroups[_frame].push_back(handle);
+        }
+        return handle;
+    }
 
-    Graphics::GPUTextureHandle RenderDeviceImpl::CreateTexture(const Graphics::GPUTextureDesc& desc) {}
+    void RenderDeviceImpl::UpdateBindGroup(Graphics::GPUBindGroupHandle& handle, const Graphics::GPUBindGroupDesc& desc)
+    {
+        const auto bindGroup = GetBindGroup(handle);
+        if (!bindGroup) {
+            PANIC("Tried to update an invalid bind group");
+        }
+        auto layoutHandle = desc.layout;
+        const auto bindGroupLayout = GetBindGroupLayout(layoutHandle);
+        if (!bindGroupLayout || bindGroupLayout->layout.get() != bindGroup->layout) {
+            PANIC("Bind group update references a different bind group layout than the group");
+        }
+        WriteBindGroup(bindGroup->set, *bindGroupLayout, desc.entries);
+    }
 
-    Graphics::GPUTextureViewHandle RenderDeviceImpl::CreateTextureView(const Graphics::GPUTextureViewDesc& desc) {}
+    void RenderDeviceImpl::WriteBindGroup(
+        const vk::DescriptorSet set, const BindGroupLayout& layout,
+        const std::vector<Graphics::GPUBindGroupEntry>& entries
+    )
+    {
+        const auto& layoutEntries = layout.entries;
+        std::vector<usize> layoutIndices;
+        layoutIndices.reserve(entries.size());
+        std::vector<bool> written(layoutEntries.size(), false);
+        bool writesEveryBindingOnce = entries.size() == layoutEntries.size();
+        for (const auto& entry : entries) {
+            const auto layoutEntry =
+                std::ranges::find(layoutEntries, entry.binding, &Graphics::GPUBindGroupLayoutEntry::binding);
+            if (layoutEntry == layoutEntries.end()) {
+                PANIC("Bind group writes binding %u which its layout doesn't declare", entry.binding);
+            }
 
-    Graphics::GPUSamplerHandle RenderDeviceImpl::CreateSampler(const Graphics::GPUSamplerDesc& desc) {}
+            const auto index = static_cast<usize>(layoutEntry - layoutEntries.begin());
+            writesEveryBindingOnce &= !written[index];
+            written[index] = true;
+            layoutIndices.push_back(index);
+        }
 
-    Graphics::GPUBindGroupHandle RenderDeviceImpl::CreateBindGroup(const Graphics::GPUBindGroupDesc& desc) {}
+        // A layout's template covers every binding, so it can only be used when the group writes each exactly once,
+        // a duplicate would otherwise hide a binding left unwritten
+        const bool useTemplate = layout.updateTemplate && writesEveryBindingOnce;
+
+        std::vector<DescriptorInfo> templateData(useTemplate ? layoutEntries.size() : 0);
+        for (usize i = 0; i < entries.size(); i++) {
+            const auto& entry = entries[i];
+            const auto& layoutEntry = layoutEntries[layoutIndices[i]];
+
+            const auto info = GetDescriptorInfo(layoutEntry, entry);
+            if (useTemplate) {
+                templateData[layoutIndices[i]] = info;
+            } else {
+                _descriptorWriter->Write(set, entry.binding, BindGroupTypeToVk(layoutEntry.type), info);
+            }
+        }
+
+        if (useTemplate) {
+            // Writes queued for the same set would otherwise land afterwards and undo the template's
+            if (_descriptorWriter->HasPendingWrites()) {
+                _descriptorWriter->Flush();
+            }
+            _device->updateDescriptorSetWithTemplate(set, layout.updateTemplate.get(), templateData.data());
+        }
+    }
+
+    DescriptorInfo RenderDeviceImpl::GetDescriptorInfo(
+        const Graphics::GPUBindGroupLayoutEntry& layoutEntry, Graphics::GPUBindGroupEntry entry
+    )
+    {
+        DescriptorInfo info{};
+        switch (layoutEntry.type) {
+        case Graphics::GPUBindGroupType::UniformBuffer:
+        case Graphics::GPUBindGroupType::StorageBuffer: {
+            const auto buffer = GetBuffer(entry.resource);
+            if (!buffer) {
+                PANIC("Bind group binding %u references an invalid buffer", entry.binding);
+            }
+            info.buffer = vk::DescriptorBufferInfo(
+                buffer->buffer, entry.offset, entry.size == u64Max ? vk::WholeSize : entry.size
+            );
+            break;
+        }
+        case Graphics::GPUBindGroupType::Texture: {
+            const auto textureView = GetTextureView(entry.resource);
+            if (!textureView) {
+                PANIC("Bind group binding %u references an invalid texture view", entry.binding);
+            }
+            info.image =
+                vk::DescriptorImageInfo(nullptr, textureView->view.get(), vk::ImageLayout::eShaderReadOnlyOptimal);
+            break;
+        }
+        case Graphics::GPUBindGroupType::Sampler: {
+            const auto sampler = GetSampler(entry.resource);
+            if (!sampler) {
+                PANIC("Bind group binding %u references an invalid sampler", entry.binding);
+            }
+            info.image = vk::DescriptorImageInfo(sampler->sampler.get());
+            break;
+        }
+        }
+        return info;
+    }
 
     Graphics::GPUBindGroupLayoutHandle
     RenderDeviceImpl::CreateBindGroupLayout(const Graphics::GPUBindGroupLayoutDesc& desc)
     {
+        if (const auto shared = _sharedBindGroupLayouts.Acquire(desc))
+            return *shared;
+
+        std::vector<vk::DescriptorSetLayoutBinding> bindings;
+        bindings.reserve(desc.entries.size());
+        for (const auto& [binding, visibility, type] : desc.entries) {
+            vk::DescriptorSetLayoutBinding layoutBinding{};
+            layoutBinding.setBinding(binding)
+                .setDescriptorType(BindGroupTypeToVk(type))
+                .setDescriptorCount(1)
+                .setStageFlags(GPUShaderStageToVk(visibility));
+            bindings.push_back(layoutBinding);
+        }
+
+        vk::DescriptorSetLayoutCreateInfo layoutDescriptor{};
+        layoutDescriptor.setBindings(bindings);
+
+        BindGroupLayout bindGroupLayout{
+            .layout = _device->createDescriptorSetLayoutUnique(layoutDescriptor), .entries = desc.entries
+        };
+
+        // Entry i of the template reads the i-th DescriptorInfo, matching the order of the layout's entries
+        if (!desc.entries.empty()) {
+            std::vector<vk::DescriptorUpdateTemplateEntry> templateEntries;
+            templateEntries.reserve(desc.entries.size());
+            for (usize i = 0; i < desc.entries.size(); i++) {
+                templateEntries.emplace_back(
+                    desc.entries[i].binding, 0, 1, BindGroupTypeToVk(desc.entries[i].type), i * sizeof(DescriptorInfo),
+                    sizeof(DescriptorInfo)
+                );
+            }
+
+            vk::DescriptorUpdateTemplateCreateInfo templateDescriptor{};
+            templateDescriptor.setDescriptorUpdateEntries(templateEntries)
+                .setTemplateType(vk::DescriptorUpdateTemplateType::eDescriptorSet)
+                .setDescriptorSetLayout(bindGroupLayout.layout.get());
+            bindGroupLayout.updateTemplate = _device->createDescriptorUpdateTemplateUnique(templateDescriptor);
+        }
+        const auto handle = GetManager<BindGroupLayout>()->Create(std::move(bindGroupLayout));
+        _sharedBindGroupLayouts.Insert(desc, handle);
+        return handle;
+    }
+
+    Graphics::GFXRenderPipelineHandle RenderDeviceImpl::CreateRenderPipeline(const Graphics::GFXPipelineDesc& desc)
+    {
+        if (const auto shared = _sharedPipelines.Acquire(desc))
+            return *shared;
+
+        const auto state = BuildPipelineState(desc);
+        Pipeline pipeline{
+            .renderPipeline = CompilePipeline(*state), .pipelineLayout = desc.pipelineLayout, .desc = desc
+        };
+        const auto handle = GetManager<Pipeline>()->Create(std::move(pipeline));
+        _sharedPipelines.Insert(desc, handle);
+        return handle;
+    }
+
+    Graphics::GFXRenderPipelineHandle RenderDeviceImpl::CreateRenderPipelineAsync(
+        const Graphics::GFXPipelineDesc& desc, const Graphics::GFXRenderPipelineHandle placeholder
+    )
+    {
+        if (const auto shared = _sharedPipelines.Acquire(desc))
+            return *shared;
+
+        // Resolving handles and validating the description stays on this thread, only the driver compile moves
+        auto pendingPipeline = _pipelineCompiler->Submit([this, state = BuildPipelineState(desc)] {
+            return CompilePipeline(*state);
+        });
+
+        Pipeline pipeline{
+            .pipelineLayout = desc.pipelineLayout,
+            .pendingPipeline = std::move(pendingPipeline),
+            .placeholder = placeholder,
+            .desc = desc
+        };
+        const auto handle = GetManager<Pipeline>()->Create(std::move(pipeline));
+        _sharedPipelines.Insert(desc, handle);
+        return handle;
     }
 
-    Graphics::GFXRenderPipelineHandle RenderDeviceImpl::CreateRenderPipeline(const Graphics::GFXPipelineDesc& desc) {}
+    void RenderDeviceImpl::RebuildRenderPipeline(Graphics::GFXRenderPipelineHandle& handle)
+    {
+        const auto pipeline = GetPipeline(handle);
+        if (!pipeline) {
+            PANIC("Tried to rebuild an invalid render pipeline");
+        }
+
+        // Settle an earlier compile first, so there's only ever one result waiting to be swapped in
+        if (pipeline->pendingPipeline.valid()) {
+            pipeline->pendingPipeline.wait();
+            static_cast<void>(IsRenderPipelineReady(handle));
+        }
+        pipeline->pendingPipeline = _pipelineCompiler->Submit([this, state = BuildPipelineState(pipeline->desc)] {
+            return CompilePipeline(*state);
+        });
+    }
+
+    std::unique_ptr<PipelineBuildState> RenderDeviceImpl::BuildPipelineState(const Graphics::GFXPipelineDesc& desc)
+    {
+        // The create infos point into each other, so the state is built in place and never moved afterwards
+        auto state = std::make_unique<PipelineBuildState>();
+
+        state->shaderStages.reserve(desc.shaders.size());
+        for (auto [stage, module] : desc.shaders) {
+            const auto shaderModule = GetShaderModule(module);
+            if (!shaderModule) {
+                PANIC("Render pipeline references an invalid shader module");
+            }
+
+            vk::PipelineShaderStageCreateInfo shaderStageDescriptor{};
+            shaderStageDescriptor.setStage(GPUShaderStageToVkBit(stage))
+                .setModule(shaderModule->module.get())
+                .setPName("main");
+            state->shaderStages.push_back(shaderStageDescriptor);
+        }
+
+        // Attribute locations follow declaration order across all bindings
+        uint32_t location = 0;
+        for (const auto& [binding, stride, attributes] : desc.vertexLayout) {
+            state->vertexBindings.emplace_back(binding, stride, vk::VertexInputRate::eVertex);
+            for (const auto& [format, offset] : attributes) {
+                state->vertexAttributes.emplace_back(location++, binding, GPUColorFormatToVk(format), offset);
+            }
+        }
+
+        state->vertexInput.setVertexBindingDescriptions(state->vertexBindings)
+            .setVertexAttributeDescriptions(state->vertexAttributes);
+
+        state->inputAssembly.setTopology(GPUTopologyToVk(desc.topology)).setPrimitiveRestartEnable(false);
+
+        state->viewport.setViewportCount(1).setScissorCount(1);
+
+        state->rasterization.setPolygonMode(GPUPolygonModeToVk(desc.polygonMode))
+            .setCullMode(GPUCullModeToVk(desc.cullMode))
+            .setFrontFace(GPUFrontFaceToVk(desc.frontFace))
+            .setLineWidth(1.0f);
+
+        state->multisample.setRasterizationSamples(vk::SampleCountFlagBits::e1);
+
+        const auto toStencilOpState = [](const Graphics::GFXPipelineStencilOpState& stencilState) {
+            vk::StencilOpState stencilOpState{};
+            stencilOpState.setFailOp(GPUStencilOpToVk(stencilState.failOp))
+                .setPassOp(GPUStencilOpToVk(stencilState.passOp))
+                .setDepthFailOp(GPUStencilOpToVk(stencilState.depthFailOp))
+                .setCompareOp(GPUCompareOpToVk(stencilState.compareOp))
+                .setCompareMask(stencilState.compareMask)
+                .setWriteMask(stencilState.writeMask)
+                .setReference(stencilState.reference);
+            return stencilOpState;
+        };
+
+        state->depthStencil.setDepthTestEnable(desc.depthTest)
+            .setDepthWriteEnable(desc.depthWrite)
+            .setDepthCompareOp(GPUCompareOpToVk(desc.depthCompareOp))
+            .setStencilTestEnable(desc.stencilTest)
+            .setFront(toStencilOpState(desc.stencilFrontFace))
+            .setBack(toStencilOpState(desc.stencilBackFace));
+
+        state->colorBlendAttachment.setBlendEnable(false).setColorWriteMask(
+            vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB |
+            vk::ColorComponentFlagBits::eA
+        );
+        state->colorBlend.setAttachments(state->colorBlendAttachment);
+
+        state->dynamicState.setDynamicStates(state->dynamicStates);
+
+        state->colorFormat = GPUColorFormatToVk(desc.colorFormat);
+        const auto depthStencilFormat = GPUDepthStencilFormatToVk(desc.depthStencilFormat);
+        const bool hasStencil = IsDepthStencilFormat(desc.depthStencilFormat);
+
+        state->creationFeedbackDescriptor.setPPipelineCreationFeedback(&state->creationFeedback);
+
+        state->rendering.setPNext(&state->creationFeedbackDescriptor)
+            .setColorAttachmentFormats(state->colorFormat)
+            .setDepthAttachmentFormat(depthStencilFormat)
+            .setStencilAttachmentFormat(hasStencil ? depthStencilFormat : vk::Format::eUndefined);
+
+        auto pipelineLayoutHandle = desc.pipelineLayout;
+        const auto pipelineLayout = GetPipelineLayout(pipelineLayoutHandle);
+        if (!pipelineLayout) {
+            PANIC("Render pipeline references an invalid pipeline layout");
+        }
+
+        state->pipeline.setPNext(&state->rendering)
+            .setStages(state->shaderStages)
+            .setPVertexInputState(&state->vertexInput)
+            .setPInputAssemblyState(&state->inputAssembly)
+            .setPViewportState(&state->viewport)
+            .setPRasterizationState(&state->rasterization)
+            .setPMultisampleState(&state->multisample)
+            .setPDepthStencilState(&state->depthStencil)
+            .setPColorBlendState(&state->colorBlend)
+            .setPDynamicState(&state->dynamicState)
+            .setLayout(pipelineLayout->pipelineLayout.get());
+        return state;
+    }
+
+    vk::UniquePipeline RenderDeviceImpl::CompilePipeline(PipelineBuildState& state)
+    {
+        // The pipeline cache is internally synchronized, so workers can compile into it concurrently
+        const auto creationStart = std::chrono::steady_clock::now();
+        auto [result, renderPipeline] = _device->createGraphicsPipelineUnique(_pipelineCache.get(), state.pipeline);
+        const std::chrono::duration<double, std::milli> creationTime = std::chrono::steady_clock::now() - creationStart;
+        if (result != vk::Result::eSuccess) {
+            PANIC("Failed to create render pipeline");
+        }
+
+        std::lock_guard lock(_pipelineCacheStatsMutex);
+        _pipelineCacheStats.pipelinesCreated++;
+        _pipelineCacheStats.totalCreationMs += creationTime.count();
+        _pipelineCacheStats.slowestCreationMs = std::max(_pipelineCacheStats.slowestCreationMs, creationTime.count());
+        if (state.creationFeedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit) {
+            _pipelineCacheStats.cacheHits++;
+        }
+        return std::move(renderPipeline);
+    }
 
     Graphics::GFXPipelineLayoutHandle
     RenderDeviceImpl::CreatePipelineLayout(const Graphics::GFXPipelineLayoutDesc& desc)
     {
+        if (const auto shared = _sharedPipelineLayouts.Acquire(desc))
+            return *shared;
+
+        // The bindless table always sits at set 0, bind groups follow it
+        std::vector<vk::DescriptorSetLayout> setLayouts;
+        setLayouts.reserve(desc.groupLayouts.size() + 1);
+        if (_bindlessTable) {
+            setLayouts.push_back(_bindlessTable->GetLayout());
+        }
+        for (auto groupLayout : desc.groupLayouts) {
+            const auto bindGroupLayout = GetBindGroupLayout(groupLayout);
+            if (!bindGroupLayout) {
+                PANIC("Pipeline layout references an invalid bind group layout");
+            }
+            setLayouts.push_back(bindGroupLayout->layout.get());
+        }
+
+        std::vector<vk::PushConstantRange> pushConstantRanges;
+        pushConstantRanges.reserve(desc.pushConstantRanges.size());
+        for (const auto& [visibility, offset, size] : desc.pushConstantRanges) {
+            pushConstantRanges.emplace_back(GPUShaderStageToVk(visibility), offset, size);
+        }
+
+        vk::PipelineLayoutCreateInfo pipelineLayoutDescriptor{};
+        pipelineLayoutDescriptor.setSetLayouts(setLayouts).setPushConstantRanges(pushConstantRanges);
+
+        PipelineLayout pipelineLayout{.pipelineLayout = _device->createPipelineLayoutUnique(pipelineLayoutDescriptor)};
+        const auto handle = GetManager<PipelineLayout>()->Create(std::move(pipelineLayout));
+        _sharedPipelineLayouts.Insert(desc, handle);
+        return handle;
+    }
+
+    Graphics::GFXShaderModuleHandle RenderDeviceImpl::CreateShaderModule(const Graphics::GFXShaderModuleDesc& desc)
+    {
+        ShaderModule shaderModule{.module = LoadShaderModule(desc), .path = desc.shaderPath};
+        return GetManager<ShaderModule>()->Create(std::move(shaderModule));
+    }
+
+    void RenderDeviceImpl::ReloadShaderModule(
+        Graphics::GFXShaderModuleHandle& handle, const Graphics::GFXShaderModuleDesc& desc
+    )
+    {
+        const auto shaderModule = GetShaderModule(handle);
+        if (!shaderModule) {
+            PANIC("Tried to reload an invalid shader module");
+        }
+
+        // Loading first keeps the old module when the new code is rejected
+        auto module = LoadShaderModule(desc);
+        _pipelineCompiler->WaitForIdle();
+        shaderModule->module = std::move(module);
+        shaderModule->path = desc.shaderPath;
+    }
+
+    vk::UniqueShaderModule RenderDeviceImpl::LoadShaderModule(const Graphics::GFXShaderModuleDesc& desc)
+    {
+        std::vector<uint32_t> code;
+        if (!desc.code.empty()) {
+            if (desc.code.size() % sizeof(uint32_t) != 0) {
+                PANIC("Shader %s is not valid SPIR-V", desc.shaderPath.c_str());
+            }
+            code.resize(desc.code.size() / sizeof(uint32_t));
+            std::memcpy(code.data(), desc.code.data(), desc.code.size());
+        } else {
+            std::ifstream file(desc.shaderPath, std::ios::binary | std::ios::ate);
+            if (!file) {
+                PANIC("Failed to open shader %s", desc.shaderPath.c_str());
+            }
+
+            const auto size = static_cast<usize>(file.tellg());
+            if (size == 0 || size % sizeof(uint32_t) != 0) {
+                PANIC("Shader %s is not valid SPIR-V", desc.shaderPath.c_str());
+            }
+
+            code.resize(size / sizeof(uint32_t));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(code.data()), static_cast<std::streamsize>(size));
+        }
+
+        vk::ShaderModuleCreateInfo shaderModuleDescriptor{};
+        shaderModuleDescriptor.setCode(code);
+        return _device->createShaderModuleUnique(shaderModuleDescriptor);
+    }
+
+    Graphics::GPUMemoryHeapHandle
+    RenderDeviceImpl::CreateMemoryHeap(const Graphics::GPUMemoryRequirements& requirements)
+    {
+        const VkMemoryRequirements memoryRequirements = {
+            .size = requirements.size,
+            .alignment = requirements.alignment,
+            .memoryTypeBits = requirements.memoryTypeBits
+        };
+
+        VmaAllocationCreateInfo allocationDescriptor{};
+        allocationDescriptor.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        MemoryHeap heap{.allocation = nullptr, .size = requirements.size};
+        if (vmaAllocateMemory(_allocator, &memoryRequirements, &allocationDescriptor, &heap.allocation, nullptr) !=
+            VK_SUCCESS) {
+            PANIC("Failed to allocate a memory heap of %llu bytes", static_cast<unsigned long long>(requirements.size));
+        }
+        return GetManager<MemoryHeap>()->Create(std::move(heap));
     }
 
-    Graphics::GFXShaderModuleHandle RenderDeviceImpl::CreateShaderModule(const Graphics::GFXShaderModuleDesc& desc) {}
+    Graphics::GPUTextureHandle RenderDeviceImpl::CreateAliasedTexture(
+        const Graphics::GPUTextureDesc& desc, Graphics::GPUMemoryHeapHandle& heap, const u64 offset
+    )
+    {
+        const auto heapInstance = GetManager<MemoryHeap>()->Get(heap);
+        if (!heapInstance) {
+            PANIC("Tried to place a texture in an invalid memory heap");
+        }
+
+        const VkImageCreateInfo rawImageDescriptor = GetImageDescriptor(desc);
+        VkImage rawImage = VK_NULL_HANDLE;
+        if (vmaCreateAliasingImage2(_allocator, heapInstance->allocation, offset, &rawImageDescriptor, &rawImage) !=
+            VK_SUCCESS) {
+            PANIC("Failed to create aliased texture");
+        }
+
+        Texture texture{};
+        texture.image = rawImage;
+        texture.format = desc.format;
+        texture.extent = {desc.scale.w, desc.scale.h, std::max(desc.scale.d, 1u)};
+        texture.levels = desc.levels;
+        texture.layers = desc.layers;
+        texture.usage = desc.usage;
+        texture.aliased = true;
+        texture.states.assign(desc.levels * desc.layers, Graphics::GPUTextureState::Unknown);
+        return GetManager<Texture>()->Create(std::move(texture));
+    }
+
+    Graphics::GPUMemoryRequirements
+    RenderDeviceImpl::GetTextureMemoryRequirements(const Graphics::GPUTextureDesc& desc)
+    {
+        const vk::ImageCreateInfo imageDescriptor = GetImageDescriptor(desc);
+
+        vk::DeviceImageMemoryRequirements requirementsDescriptor{};
+        requirementsDescriptor.setPCreateInfo(&imageDescriptor);
+        const auto requirements = _device->getImageMemoryRequirements(requirementsDescriptor).memoryRequirements;
+        return {
+            .size = requirements.size,
+            .alignment = requirements.alignment,
+            .memoryTypeBits = requirements.memoryTypeBits
+        };
+    }
 
     void RenderDeviceImpl::DisconnectWindow(Graphics::RenderWindowHandle& handle) {}
 
-    void RenderDeviceImpl::DestroyBuffer(Graphics::GPUBufferHandle& handle) { GetManager<Buffer>()->Destroy(handle); }
+    void RenderDeviceImpl::DestroyBuffer(Graphics::GPUBufferHandle& handle)
+    {
+        if (const auto buffer = GetBuffer(handle)) {
+            if (buffer->bindlessIndex != u32Max) {
+                _bindlessTable->Remove(BindlessResourceType::Buffer, buffer->bindlessIndex);
+            }
+
+            // An allocation being moved can't be freed mid-pass, VMA releases it when the pass ends instead. The
+            // buffer is already the copy's destination by then, so it has to outlive the copy as well
+            if (const auto move = FindDefragmentationMove(buffer->allocation)) {
+                move->operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_DESTROY;
+                _defragmentation.retiredBuffers.push_back(buffer->buffer);
+            } else {
+                vmaDestroyBuffer(_allocator, buffer->buffer, buffer->allocation);
+            }
+        }
+        GetManager<Buffer>()->Destroy(handle);
+    }
 
     void RenderDeviceImpl::DestroyTexture(Graphics::GPUTextureHandle& handle)
     {
+        if (const auto texture = GetTexture(handle)) {
+            if (texture->allocatedImage) {
+                vmaDestroyImage(_allocator, texture->image, texture->allocation);
+            } else if (texture->aliased) {
+                _device->destroyImage(texture->image);
+            }
+        }
         GetManager<Texture>()->Destroy(handle);
     }
 
     void RenderDeviceImpl::DestroyTextureView(Graphics::GPUTextureViewHandle& handle)
     {
+        if (const auto textureView = GetTextureView(handle); textureView && textureView->bindlessIndex != u32Max) {
+            _bindlessTable->Remove(BindlessResourceType::Texture, textureView->bindlessIndex);
+        }
         GetManager<TextureView>()->Destroy(handle);
     }
 
-    void RenderDeviceImpl::DestroySampler(Graphics::GPUSamplerHandle& handle) {}
+    void RenderDeviceImpl::DestroySampler(Graphics::GPUSamplerHandle& handle)
+    {
+        if (!_sharedSamplers.Release(handle)) {
+            handle.Invalidate();
+            return;
+        }
+
+        if (const auto sampler = GetSampler(handle); sampler && sampler->bindlessIndex != u32Max) {
+            _bindlessTable->Remove(BindlessResourceType::Sampler, sampler->bindlessIndex);
+        }
+        GetManager<Sampler>()->Destroy(handle);
+    }
 
     void RenderDeviceImpl::DestroyBindGroup(Graphics::GPUBindGroupHandle& handle)
     {
+        if (const auto bindGroup = GetBindGroup(handle); bindGroup && !bindGroup->transient) {
+            _descriptorAllocator->ReleasePersistent(bindGroup->layout, bindGroup->set);
+        }
         GetManager<BindGroup>()->Destroy(handle);
     }
 
-    void RenderDeviceImpl::DestroyBindGroupLayout(Graphics::GPUBindGroupLayoutHandle& handle) {}
+    void RenderDeviceImpl::DestroyBindGroupLayout(Graphics::GPUBindGroupLayoutHandle& handle)
+    {
+        if (!_sharedBindGroupLayouts.Release(handle)) {
+            handle.Invalidate();
+            return;
+        }
+        GetManager<BindGroupLayout>()->Destroy(handle);
+    }
 
     void RenderDeviceImpl::DestroyRenderPipeline(Graphics::GFXRenderPipelineHandle& handle)
     {
+        if (!_sharedPipelines.Release(handle)) {
+            handle.Invalidate();
+            return;
+        }
+
+        // A pipeline still compiling has to finish before its result can be destroyed here
+        if (const auto pipeline = GetPipeline(handle); pipeline && pipeline->pendingPipeline.valid()) {
+            pipeline->pendingPipeline.wait();
+        }
         GetManager<Pipeline>()->Destroy(handle);
     }
 
     void RenderDeviceImpl::DestroyPipelineLayout(Graphics::GFXPipelineLayoutHandle& handle)
     {
+        if (!_sharedPipelineLayouts.Release(handle)) {
+            handle.Invalidate();
+            return;
+        }
         GetManager<PipelineLayout>()->Destroy(handle);
     }
 
-    void RenderDeviceImpl::DestroyShaderModule(Graphics::GFXShaderModuleHandle& handle) {}
+    void RenderDeviceImpl::DestroyShaderModule(Graphics::GFXShaderModuleHandle& handle)
+    {
+        GetManager<ShaderModule>()->Destroy(handle);
+    }
+
+    void RenderDeviceImpl::DestroyMemoryHeap(Graphics::GPUMemoryHeapHandle& handle)
+    {
+        if (const auto heap = GetManager<MemoryHeap>()->Get(handle)) {
+            vmaFreeMemory(_allocator, heap->allocation);
+        }
+        GetManager<MemoryHeap>()->Destroy(handle);
+    }
 
     Buffer* RenderDeviceImpl::GetBuffer(Graphics::GPUBufferHandle& handle) { return GetManager<Buffer>()->Get(handle); }
 
@@ -127,6 +885,79 @@ namespace Cocoa::Vulkan {
         return GetManager<BindGroup>()->Get(handle);
     }
 
+    BindGroupLayout* RenderDeviceImpl::GetBindGroupLayout(Graphics::GPUBindGroupLayoutHandle& handle)
+    {
+        return GetManager<BindGroupLayout>()->Get(handle);
+    }
+
+    void RenderDeviceImpl::FlushDescriptorWrites() { _descriptorWriter->Flush(); }
+
+    u32 RenderDeviceImpl::GetTextureViewBindlessIndex(Graphics::GPUTextureViewHandle& handle)
+    {
+        const auto textureView = GetTextureView(handle);
+        return textureView ? textureView->bindlessIndex : u32Max;
+    }
+
+    u32 RenderDeviceImpl::GetSamplerBindlessIndex(Graphics::GPUSamplerHandle& handle)
+    {
+        const auto sampler = GetSampler(handle);
+        return sampler ? sampler->bindlessIndex : u32Max;
+    }
+
+    u32 RenderDeviceImpl::GetBufferBindlessIndex(Graphics::GPUBufferHandle& handle)
+    {
+        const auto buffer = GetBuffer(handle);
+        return buffer ? buffer->bindlessIndex : u32Max;
+    }
+
+    void* RenderDeviceImpl::GetBufferMappedData(Graphics::GPUBufferHandle& handle)
+    {
+        const auto buffer = GetBuffer(handle);
+        return buffer ? buffer->mapped : nullptr;
+    }
+
+    bool RenderDeviceImpl::IsRenderPipelineReady(Graphics::GFXRenderPipelineHandle& handle)
+    {
+        const auto pipeline = GetPipeline(handle);
+        if (!pipeline)
+            return false;
+        // Only a failed first compile leaves nothing to bind once the result is taken
+        if (!pipeline->pendingPipeline.valid())
+            return static_cast<bool>(pipeline->renderPipeline);
+        // A rebuilding pipeline keeps drawing with its previous version until the new one is ready
+        if (pipeline->pendingPipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return static_cast<bool>(pipeline->renderPipeline);
+
+        // A failed compile isn't rethrown into whoever is recording, the encoder falls back to the placeholder instead
+        if (!pipeline->renderPipeline) {
+            try {
+                pipeline->renderPipeline = pipeline->pendingPipeline.get();
+            } catch (const std::exception&) {
+                PUSH_WARN("Failed to compile a render pipeline, it's never going to be ready");
+                return false;
+            }
+            return true;
+        }
+
+        // Frames already recorded may still use the previous version. While recording, the current frame is the newest
+        // one that can, between frames it's the one submitted last, and the version lives until that slot comes around.
+        try {
+            auto rebuilt = pipeline->pendingPipeline.get();
+            const u32 slot = _encoding ? _frame : (_frame + FramesInFlight - 1) % FramesInFlight;
+            _retiredPipelines[slot].push_back(std::move(pipeline->renderPipeline));
+            pipeline->renderPipeline = std::move(rebuilt);
+        } catch (const std::exception&) {
+            PUSH_WARN("Failed to rebuild a render pipeline, keeping the previous version");
+        }
+        return true;
+    }
+
+    PipelineCacheStats RenderDeviceImpl::GetPipelineCacheStats()
+    {
+        std::lock_guard lock(_pipelineCacheStatsMutex);
+        return _pipelineCacheStats;
+    }
+
     Pipeline* RenderDeviceImpl::GetPipeline(Graphics::GFXRenderPipelineHandle& handle)
     {
         return GetManager<Pipeline>()->Get(handle);
@@ -137,25 +968,73 @@ namespace Cocoa::Vulkan {
         return GetManager<PipelineLayout>()->Get(handle);
     }
 
+    Sampler* RenderDeviceImpl::GetSampler(Graphics::GPUSamplerHandle& handle)
+    {
+        return GetManager<Sampler>()->Get(handle);
+    }
+
+    ShaderModule* RenderDeviceImpl::GetShaderModule(Graphics::GFXShaderModuleHandle& handle)
+    {
+        return GetManager<ShaderModule>()->Get(handle);
+    }
+
     void RenderDeviceImpl::WaitForIdle() { _device->waitIdle(); }
 
     std::unique_ptr<Graphics::RenderEncoder> RenderDeviceImpl::Encode(const Graphics::RenderEncoderDesc& encoderDesc)
     {
-        std::unique_ptr<Graphics::RenderEncoder> encoder = nullptr;
-        return encoder;
+        // Queued writes may target transient sets whose pool is about to be reset
+        FlushDescriptorWrites();
+
+        // Everything this frame slot used last time is only reclaimed once the GPU is done with it
+        const auto result = _device->waitForFences(_frameFences[_frame].get(), VK_TRUE, UINT64_MAX);
+        if (result != vk::Result::eSuccess) {
+            PANIC("Failed to wait for the GPU to finish a previous frame");
+        }
+
+        for (auto& bindGroup : _transientBindGroups[_frame]) {
+            GetManager<BindGroup>()->Destroy(bindGroup);
+        }
+        _transientBindGroups[_frame].clear();
+        _retiredPipelines[_frame].clear();
+        _descriptorAllocator->BeginFrame(_frame);
+        if (_bindlessTable) {
+            _bindlessTable->NextFrame(_frame);
+        }
+
+        const auto commandBuffer = _commandBuffers[_frame].get();
+        commandBuffer.reset();
+        commandBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        StepDefragmentation(commandBuffer);
+        _encoding = true;
+        return std::make_unique<RenderEncoderImpl>(*this, commandBuffer, encoderDesc);
     }
 
     void RenderDeviceImpl::EndEncoding(const std::unique_ptr<Graphics::RenderEncoder> encoder)
     {
+        const auto encoderImpl = static_cast<RenderEncoderImpl*>(encoder.get());
+        const auto commandBuffer = encoderImpl->GetCommandBuffer();
+        const auto submitQueue = encoderImpl->GetSubmitQueueType();
         encoder->Stop();
-        _frame = (_frame + 1) % 2;
+
+        vk::CommandBufferSubmitInfo commandSubmitDescriptor{};
+        commandSubmitDescriptor.setCommandBuffer(commandBuffer);
+
+        vk::SubmitInfo2 submitDescriptor{};
+        submitDescriptor.setCommandBufferInfos(commandSubmitDescriptor);
+
+        _device->resetFences(_frameFences[_frame].get());
+        GetQueue(submitQueue)->queue.submit2(submitDescriptor, _frameFences[_frame].get());
+        _frame = (_frame + 1) % FramesInFlight;
+        _encoding = false;
     }
 
     void RenderDeviceImpl::EncodeImmediateCommands(
         const Graphics::EncodeImmediateFun encodeFun, const Graphics::RenderEncoderDesc& encoderDesc
     )
     {
-        auto encoder = Encode(encoderDesc);
+        FlushDescriptorWrites();
+        _immediateCommandBuffer->begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        auto encoder = std::make_unique<RenderEncoderImpl>(*this, _immediateCommandBuffer.get(), encoderDesc);
         encodeFun(encoder.get());
         encoder->Stop();
         encoder.reset();
@@ -361,14 +1240,52 @@ namespace Cocoa::Vulkan {
             "VK_KHR_synchronization2"
         };
 
+        // The budget extension lets VMA report real per-process heap usage instead of guessing
+        const auto availableExtensions = _gpu.enumerateDeviceExtensionProperties();
+        _memoryBudgetSupported = std::ranges::any_of(availableExtensions, [](const vk::ExtensionProperties& extension) {
+            return std::string_view(extension.extensionName) == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+        });
+        if (_memoryBudgetSupported) {
+            deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
+        _blockCompressionSupported = _gpu.getFeatures().textureCompressionBC;
+
         vk::PhysicalDeviceFeatures vkFeatures{};
-        vkFeatures.setFillModeNonSolid(true);
+        vkFeatures.setFillModeNonSolid(true).setTextureCompressionBC(_blockCompressionSupported);
 
         vk::PhysicalDeviceFeatures2 vkFeatures2{};
         vkFeatures2.setFeatures(vkFeatures);
 
+        vk::PhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.setPNext(&vkFeatures2);
+        if (_bindless) {
+            const auto supported = _gpu.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+            const auto& supported12 = supported.get<vk::PhysicalDeviceVulkan12Features>();
+            _bindless = supported12.descriptorIndexing && supported12.runtimeDescriptorArray &&
+                        supported12.descriptorBindingPartiallyBound &&
+                        supported12.descriptorBindingUpdateUnusedWhilePending &&
+                        supported12.descriptorBindingSampledImageUpdateAfterBind &&
+                        supported12.descriptorBindingStorageBufferUpdateAfterBind &&
+                        supported12.shaderSampledImageArrayNonUniformIndexing &&
+                        supported12.shaderStorageBufferArrayNonUniformIndexing;
+            if (!_bindless) {
+                PUSH_WARN("GPU lacks the descriptor indexing features bindless needs, falling back to bind groups");
+            }
+        }
+        if (_bindless) {
+            vulkan12Features.setDescriptorIndexing(true)
+                .setRuntimeDescriptorArray(true)
+                .setDescriptorBindingPartiallyBound(true)
+                .setDescriptorBindingUpdateUnusedWhilePending(true)
+                .setDescriptorBindingSampledImageUpdateAfterBind(true)
+                .setDescriptorBindingStorageBufferUpdateAfterBind(true)
+                .setShaderSampledImageArrayNonUniformIndexing(true)
+                .setShaderStorageBufferArrayNonUniformIndexing(true);
+        }
+
         vk::PhysicalDeviceVulkan13Features vulkan13Features{};
-        vulkan13Features.setPNext(&vkFeatures2).setDynamicRendering(true).setSynchronization2(true);
+        vulkan13Features.setPNext(&vulkan12Features).setDynamicRendering(true).setSynchronization2(true);
 
         vk::DeviceCreateInfo deviceDescriptor{};
         deviceDescriptor.setPNext(&vulkan13Features)
@@ -383,7 +1300,7 @@ namespace Cocoa::Vulkan {
     void RenderDeviceImpl::CreateAllocator()
     {
         VmaAllocatorCreateInfo vmaAllocatorDescriptor = {
-            .flags = 0,
+            .flags = _memoryBudgetSupported ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u,
             .physicalDevice = _gpu,
             .device = _device.get(),
             .preferredLargeHeapBlockSize = 0,
@@ -400,6 +1317,8 @@ namespace Cocoa::Vulkan {
         if (createAllocator != VK_SUCCESS) {
             PANIC("Failed to create device");
         }
+
+        _memoryPools = std::make_unique<MemoryPools>(_allocator);
     }
     void RenderDeviceImpl::CreateCommandPool()
     {
@@ -411,7 +1330,7 @@ namespace Cocoa::Vulkan {
     void RenderDeviceImpl::CreateCommandBuffers()
     {
         vk::CommandBufferAllocateInfo commandBufferDescriptor{};
-        commandBufferDescriptor.setCommandBufferCount(2)
+        commandBufferDescriptor.setCommandBufferCount(FramesInFlight)
             .setCommandPool(_commandPool.get())
             .setLevel(vk::CommandBufferLevel::ePrimary);
         _commandBuffers = _device->allocateCommandBuffersUnique(commandBufferDescriptor);
@@ -427,24 +1346,261 @@ namespace Cocoa::Vulkan {
 
         constexpr vk::FenceCreateInfo fenceDescriptor{};
         _immediateFence = _device->createFenceUnique(fenceDescriptor);
+
+        // Frame fences start signaled so the first Encode of each slot doesn't wait
+        constexpr vk::FenceCreateInfo frameFenceDescriptor(vk::FenceCreateFlagBits::eSignaled);
+        for (uint32_t i = 0; i < FramesInFlight; i++) {
+            _frameFences.push_back(_device->createFenceUnique(frameFenceDescriptor));
+        }
     }
-    void RenderDeviceImpl::CreateDescriptorPool()
+    void RenderDeviceImpl::CreateDescriptorAllocator()
     {
-        vk::DescriptorPoolSize bufferPoolSize{};
-        bufferPoolSize.setType(vk::DescriptorType::eUniformBuffer).setDescriptorCount(1000);
+        _descriptorAllocator = std::make_unique<DescriptorAllocator>(_device.get(), FramesInFlight);
+        _descriptorWriter = std::make_unique<DescriptorWriter>(_device.get());
+    }
+    void RenderDeviceImpl::CreateBindlessTable()
+    {
+        if (!_bindless)
+            return;
+
+        const auto properties =
+            _gpu.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+        _bindlessTable = std::make_unique<BindlessTable>(
+            _device.get(), properties.get<vk::PhysicalDeviceVulkan12Properties>(), FramesInFlight
+        );
+    }
+    void RenderDeviceImpl::CreatePipelineCache()
+    {
+        std::vector<char> cacheData;
+        if (!_pipelineCachePath.empty()) {
+            if (std::ifstream file(_pipelineCachePath, std::ios::binary | std::ios::ate); file) {
+                cacheData.resize(static_cast<usize>(file.tellg()));
+                file.seekg(0);
+                file.read(cacheData.data(), static_cast<std::streamsize>(cacheData.size()));
+            }
+        }
 
-        vk::DescriptorPoolSize imagePoolSize{};
-        imagePoolSize.setType(vk::DescriptorType::eSampledImage).setDescriptorCount(1000);
+        if (!cacheData.empty() && !IsPipelineCacheCompatible(cacheData)) {
+            PUSH_WARN("Pipeline cache %s belongs to another GPU or driver, rebuilding it", _pipelineCachePath.c_str());
+            cacheData.clear();
+        } else if (!cacheData.empty()) {
+            PUSH_INFO("Loaded %zu bytes of pipeline cache from %s", cacheData.size(), _pipelineCachePath.c_str());
+        }
 
-        vk::DescriptorPoolSize samplerPoolSize{};
-        samplerPoolSize.setType(vk::DescriptorType::eSampler).setDescriptorCount(1000);
+        vk::PipelineCacheCreateInfo pipelineCacheDescriptor{};
+        pipelineCacheDescriptor.setInitialDataSize(cacheData.size()).setPInitialData(cacheData.data());
+        _pipelineCache = _device->createPipelineCacheUnique(pipelineCacheDescriptor);
+    }
+    void RenderDeviceImpl::SavePipelineCache()
+    {
+        if (!_pipelineCache || _pipelineCachePath.empty())
+            return;
+
+        const auto cacheData = _device->getPipelineCacheData(_pipelineCache.get());
+        if (cacheData.empty())
+            return;
+
+        // Write next to the real file first so a crash mid-write never leaves a truncated cache behind
+        const std::string tempPath = _pipelineCachePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                PUSH_WARN("Failed to write pipeline cache to %s", tempPath.c_str());
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(cacheData.data()), static_cast<std::streamsize>(cacheData.size()));
+        }
 
-        std::vector poolSizes = {bufferPoolSize, imagePoolSize, samplerPoolSize};
+        std::error_code error;
+        std::filesystem::rename(tempPath, _pipelineCachePath, error);
+        if (error) {
+            PUSH_WARN("Failed to replace pipeline cache %s: %s", _pipelineCachePath.c_str(), error.message().c_str());
+            return;
+        }
 
-        vk::DescriptorPoolCreateInfo descriptorPoolDescriptor{};
-        descriptorPoolDescriptor.setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet)
-            .setMaxSets(1000)
-            .setPoolSizes(poolSizes);
-        _descriptorPool = _device->createDescriptorPoolUnique(descriptorPoolDescriptor);
+        PUSH_INFO(
+            "Saved %zu bytes of pipeline cache (%u pipelines, %u cache hits, %.2fms total creation time)",
+            cacheData.size(), _pipelineCacheStats.pipelinesCreated, _pipelineCacheStats.cacheHits,
+            _pipelineCacheStats.totalCreationMs
+        );
+    }
+    bool RenderDeviceImpl::IsPipelineCacheCompatible(const std::vector<char>& cacheData) const
+    {
+        VkPipelineCacheHeaderVersionOne header{};
+        if (cacheData.size() < sizeof(header))
+            return false;
+        memcpy(&header, cacheData.data(), sizeof(header));
+
+        const auto properties = _gpu.getProperties();
+        return header.headerSize >= sizeof(header) && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+               header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+               memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+    }
+    void RenderDeviceImpl::BeginDefragmentation()
+    {
+        const auto geometryPool = _memoryPools->GetPool(MemoryPoolType::Geometry);
+        if (_defragmentation.context || !geometryPool)
+            return;
+
+        // Capping each pass keeps the copies recorded at the start of a frame small
+        VmaDefragmentationInfo defragmentationDescriptor{};
+        defragmentationDescriptor.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+        defragmentationDescriptor.pool = geometryPool;
+        defragmentationDescriptor.maxBytesPerPass = MaxDefragmentationBytesPerPass;
+        defragmentationDescriptor.maxAllocationsPerPass = MaxDefragmentationMovesPerPass;
+        if (vmaBeginDefragmentation(_allocator, &defragmentationDescriptor, &_defragmentation.context) !=
+            VK_SUCCESS) {
+            PUSH_WARN("Failed to start defragmentation");
+            _defragmentation.context = nullptr;
+        }
+    }
+
+    Graphics::GPUMemoryStats RenderDeviceImpl::GetMemoryStats()
+    {
+        Graphics::GPUMemoryStats stats{};
+        stats.budgetExact = _memoryBudgetSupported;
+        stats.defragmenting = _defragmentation.context != nullptr;
+        stats.defragmentationMoves = _defragmentation.moves;
+        stats.defragmentationBytesMoved = _defragmentation.bytesMoved;
+
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(_allocator, &memoryProperties);
+
+        std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+        vmaGetHeapBudgets(_allocator, budgets.data());
+
+        for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; i++) {
+            const auto& budget = budgets[i];
+            stats.heaps.push_back({
+                .budget = budget.budget,
+                .usage = budget.usage,
+                .allocatedBytes = budget.statistics.allocationBytes,
+                .blockBytes = budget.statistics.blockBytes,
+                .allocations = budget.statistics.allocationCount,
+                .blocks = budget.statistics.blockCount,
+                .deviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+            });
+            stats.allocatedBytes += budget.statistics.allocationBytes;
+            stats.blockBytes += budget.statistics.blockBytes;
+            stats.allocations += budget.statistics.allocationCount;
+            stats.blocks += budget.statistics.blockCount;
+        }
+        return stats;
+    }
+
+    void RenderDeviceImpl::StepDefragmentation(const vk::CommandBuffer commandBuffer)
+    {
+        // The copies of a pass were recorded into this frame slot, so its fence covers them
+        if (_defragmentation.passPending && _defragmentation.passFrame == _frame) {
+            EndDefragmentationPass();
+        }
+        if (!_defragmentation.context || _defragmentation.passPending)
+            return;
+
+        auto& pass = _defragmentation.pass;
+        if (vmaBeginDefragmentationPass(_allocator, _defragmentation.context, &pass) == VK_SUCCESS) {
+            VmaDefragmentationStats defragmentationStats{};
+            vmaEndDefragmentation(_allocator, _defragmentation.context, &defragmentationStats);
+            _defragmentation.context = nullptr;
+            PUSH_INFO(
+                "Defragmentation finished, freed %llu bytes",
+                static_cast<unsigned long long>(defragmentationStats.bytesFreed)
+            );
+            return;
+        }
+
+        for (uint32_t i = 0; i < pass.moveCount; i++) {
+            auto& move = pass.pMoves[i];
+
+            VmaAllocationInfo allocationInfo{};
+            vmaGetAllocationInfo(_allocator, move.srcAllocation, &allocationInfo);
+            Graphics::GPUBufferHandle handle(reinterpret_cast<uintptr_t>(allocationInfo.pUserData));
+            const auto buffer = GetBuffer(handle);
+            if (!buffer) {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            vk::BufferCreateInfo bufferDescriptor{};
+            bufferDescriptor.setSize(buffer->size).setUsage(buffer->usage).setSharingMode(vk::SharingMode::eExclusive);
+            const auto newBuffer = _device->createBuffer(bufferDescriptor);
+            if (vmaBindBufferMemory(_allocator, move.dstTmpAllocation, newBuffer) != VK_SUCCESS) {
+                _device->destroyBuffer(newBuffer);
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            const vk::BufferCopy2 copy(0, 0, buffer->size);
+            vk::CopyBufferInfo2 copyDescriptor{};
+            copyDescriptor.setSrcBuffer(buffer->buffer).setDstBuffer(newBuffer).setRegions(copy);
+            commandBuffer.copyBuffer2(copyDescriptor);
+
+            // Draws recorded from here on already read the new copy, the old one is kept until the pass ends
+            _defragmentation.retiredBuffers.push_back(buffer->buffer);
+            buffer->buffer = newBuffer;
+            _defragmentation.moves++;
+            _defragmentation.bytesMoved += buffer->size;
+        }
+
+        vk::MemoryBarrier2 copyBarrier{};
+        copyBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eCopy)
+            .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+            .setDstStageMask(
+                vk::PipelineStageFlagBits2::eVertexAttributeInput | vk::PipelineStageFlagBits2::eIndexInput |
+                vk::PipelineStageFlagBits2::eCopy
+            )
+            .setDstAccessMask(
+                vk::AccessFlagBits2::eVertexAttributeRead | vk::AccessFlagBits2::eIndexRead |
+                vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite
+            );
+        vk::DependencyInfo dependencyDescriptor{};
+        dependencyDescriptor.setMemoryBarriers(copyBarrier);
+        commandBuffer.pipelineBarrier2(dependencyDescriptor);
+
+        _defragmentation.passPending = true;
+        _defragmentation.passFrame = _frame;
+    }
+
+    void RenderDeviceImpl::EndDefragmentationPass()
+    {
+        for (const auto buffer : _defragmentation.retiredBuffers) {
+            _device->destroyBuffer(buffer);
+        }
+        _defragmentation.retiredBuffers.clear();
+
+        // Past this point each moved allocation describes its new memory
+        if (vmaEndDefragmentationPass(_allocator, _defragmentation.context, &_defragmentation.pass) == VK_SUCCESS) {
+            vmaEndDefragmentation(_allocator, _defragmentation.context, nullptr);
+            _defragmentation.context = nullptr;
+        }
+        _defragmentation.pass = {};
+        _defragmentation.passPending = false;
+    }
+
+    VmaDefragmentationMove* RenderDeviceImpl::FindDefragmentationMove(const VmaAllocation allocation)
+    {
+        if (!_defragmentation.passPending)
+            return nullptr;
+
+        const auto& pass = _defragmentation.pass;
+        const auto moves = std::span(pass.pMoves, pass.moveCount);
+        const auto move = std::ranges::find(moves, allocation, &VmaDefragmentationMove::srcAllocation);
+        return move == moves.end() ? nullptr : &*move;
+    }
+
+    vk::ImageCreateInfo RenderDeviceImpl::GetImageDescriptor(const Graphics::GPUTextureDesc& desc)
+    {
+        vk::ImageCreateInfo imageDescriptor{};
+        imageDescriptor.setImageType(GPUTextureDimensionToVk(desc.dimension))
+            .setFormat(GPUTextureFormatToVk(desc.format))
+            .setExtent(vk::Extent3D(desc.scale.w, desc.scale.h, std::max(desc.scale.d, 1u)))
+            .setMipLevels(desc.levels)
+            .setArrayLayers(desc.layers)
+            .setSamples(GPUSamplingCountToVk(desc.samples))
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(GPUTextureUsageToVk(desc.usage))
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined);
+        return imageDescriptor;
     }
 } // namespace Cocoa::Vulkan
@@ -5,13 +5,24 @@
 #pragma once
 
 #include "../../graphics/core/render_device.h"
+#include "../../graphics/core/resource_cache.h"
+#include "../../graphics/utils/hashing.h"
+#include "../../tools/thread_pool.h"
 #include "../resources/bind_group.h"
+#include "../resources/bind_group_layout.h"
 #include "../resources/buffer.h"
+#include "../resources/memory_heap.h"
 #include "../resources/pipeline.h"
 #include "../resources/pipeline_layout.h"
+#include "../resources/sampler.h"
+#include "../resources/shader_module.h"
 #include "../resources/texture.h"
 #include "../resources/texture_view.h"
 #include "../utils/common.h"
+#include "bindless_table.h"
+#include "descriptor_allocator.h"
+#include "descriptor_writer.h"
+#include "memory_pools.h"
 
 namespace Cocoa::Vulkan {
     struct GPUQueue {
@@ -20,9 +31,46 @@ namespace Cocoa::Vulkan {
         vk::Queue queue;
     };
 
-    class RenderDeviceImpl final : Graphics::RenderDevice
+    struct PipelineCacheStats
+    {
+        uint32_t pipelinesCreated = 0;
+        /// @brief Pipelines the driver could build straight from the pipeline cache
+        uint32_t cacheHits = 0;
+        double totalCreationMs = 0.0;
+        double slowestCreationMs = 0.0;
+    };
+
+    /// @brief Everything vkCreateGraphicsPipelines reads, kept alive until a worker thread is done compiling
+    struct PipelineBuildState
+    {
+        std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
+        std::vector<vk::VertexInputBindingDescription> vertexBindings;
+        std::vector<vk::VertexInputAttributeDescription> vertexAttributes;
+        vk::PipelineVertexInputStateCreateInfo vertexInput;
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly;
+        vk::PipelineViewportStateCreateInfo viewport;
+        vk::PipelineRasterizationStateCreateInfo rasterization;
+        vk::PipelineMultisampleStateCreateInfo multisample;
+        vk::PipelineDepthStencilStateCreateInfo depthStencil;
+        vk::PipelineColorBlendAttachmentState colorBlendAttachment;
+        vk::PipelineColorBlendStateCreateInfo colorBlend;
+        std::array<vk::DynamicState, 2> dynamicStates = {vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+        vk::PipelineDynamicStateCreateInfo dynamicState;
+        vk::Format colorFormat = vk::Format::eUndefined;
+        vk::PipelineCreationFeedback creationFeedback;
+        vk::PipelineCreationFeedbackCreateInfo creationFeedbackDescriptor;
+        vk::PipelineRenderingCreateInfo rendering;
+        vk::GraphicsPipelineCreateInfo pipeline;
+    };
+
+    class RenderDeviceImpl final : public Graphics::RenderDevice
     {
       public:
+        /// @brief Frames the CPU may record ahead of the GPU
+        static constexpr uint32_t FramesInFlight = 2;
+        static constexpr vk::DeviceSize MaxDefragmentationBytesPerPass = 16 * 1024 * 1024;
+        static constexpr uint32_t MaxDefragmentationMovesPerPass = 64;
+
         explicit RenderDeviceImpl(const Graphics::RenderDeviceDesc& desc);
         ~RenderDeviceImpl() override;
 
@@ -38,14 +86,47 @@ namespace Cocoa::Vulkan {
 
         Graphics::GPUBindGroupHandle CreateBindGroup(const Graphics::GPUBindGroupDesc& desc) override;
 
+        void UpdateBindGroup(Graphics::GPUBindGroupHandle& handle, const Graphics::GPUBindGroupDesc& desc) override;
+
         Graphics::GPUBindGroupLayoutHandle CreateBindGroupLayout(const Graphics::GPUBindGroupLayoutDesc& desc) override;
 
         Graphics::GFXRenderPipelineHandle CreateRenderPipeline(const Graphics::GFXPipelineDesc& desc) override;
 
+        Graphics::GFXRenderPipelineHandle CreateRenderPipelineAsync(
+            const Graphics::GFXPipelineDesc& desc, Graphics::GFXRenderPipelineHandle placeholder
+        ) override;
+
+        [[nodiscard]] bool IsRenderPipelineReady(Graphics::GFXRenderPipelineHandle& handle) override;
+
+        [[nodiscard]] u32 GetTextureViewBindlessIndex(Graphics::GPUTextureViewHandle& handle) override;
+
+        [[nodiscard]] u32 GetSamplerBindlessIndex(Graphics::GPUSamplerHandle& handle) override;
+
+        [[nodiscard]] u32 GetBufferBindlessIndex(Graphics::GPUBufferHandle& handle) override;
+        [[nodiscard]] void* GetBufferMappedData(Graphics::GPUBufferHandle& handle) override;
+        [[nodiscard]] u32 GetFramesInFlight() const override { return FramesInFlight; }
+        [[nodiscard]] bool IsBlockCompressionSupported() override { return _blockCompressionSupported; }
+
         Graphics::GFXPipelineLayoutHandle CreatePipelineLayout(const Graphics::GFXPipelineLayoutDesc& desc) override;
 
         Graphics::GFXShaderModuleHandle CreateShaderModule(const Graphics::GFXShaderModuleDesc& desc) override;
 
+        void ReloadShaderModule(
+            Graphics::GFXShaderModuleHandle& handle, const Graphics::GFXShaderModuleDesc& desc
+        ) override;
+
+        void RebuildRenderPipeline(Graphics::GFXRenderPipelineHandle& handle) override;
+
+        Graphics::GPUMemoryHeapHandle CreateMemoryHeap(const Graphics::GPUMemoryRequirements& requirements) override;
+
+        Graphics::GPUTextureHandle CreateAliasedTexture(
+            const Graphics::GPUTextureDesc& desc, Graphics::GPUMemoryHeapHandle& heap, u64 offset
+        ) override;
+
+        [[nodiscard]] Graphics::GPUMemoryRequirements GetTextureMemoryRequirements(
+            const Graphics::GPUTextureDesc& desc
+        ) override;
+
         void DisconnectWindow(Graphics::RenderWindowHandle& handle) override;
 
         void DestroyBuffer(Graphics::GPUBufferHandle& handle) override;
@@ -66,6 +147,8 @@ namespace Cocoa::Vulkan {
 
         void DestroyShaderModule(Graphics::GFXShaderModuleHandle& handle) override;
 
+        void DestroyMemoryHeap(Graphics::GPUMemoryHeapHandle& handle) override;
+
         Buffer* GetBuffer(Graphics::GPUBufferHandle& handle);
 
         Texture* GetTexture(Graphics::GPUTextureHandle& handle);
@@ -74,10 +157,20 @@ namespace Cocoa::Vulkan {
 
         BindGroup* GetBindGroup(Graphics::GPUBindGroupHandle& handle);
 
+        BindGroupLayout* GetBindGroupLayout(Graphics::GPUBindGroupLayoutHandle& handle);
+
         Pipeline* GetPipeline(Graphics::GFXRenderPipelineHandle& handle);
 
         PipelineLayout* GetPipelineLayout(Graphics::GFXPipelineLayoutHandle& handle);
 
+        ShaderModule* GetShaderModule(Graphics::GFXShaderModuleHandle& handle);
+
+        Sampler* GetSampler(Graphics::GPUSamplerHandle& handle);
+
+        void BeginDefragmentation() override;
+
+        [[nodiscard]] Graphics::GPUMemoryStats GetMemoryStats() override;
+
         void WaitForIdle() override;
 
         std::unique_ptr<Graphics::RenderEncoder> Encode(const Graphics::RenderEncoderDesc& encoderDesc) override;
@@ -92,19 +185,64 @@ namespace Cocoa::Vulkan {
         [[nodiscard]] vk::PhysicalDevice GetGPU() const { return _gpu; }
         [[nodiscard]] vk::Device GetDevice() { return _device.get(); }
         [[nodiscard]] VmaAllocator GetAllocator() const { return _allocator; }
-        [[nodiscard]] vk::DescriptorPool GetDescriptorPool() { return _descriptorPool.get(); }
+        [[nodiscard]] DescriptorAllocator* GetDescriptorAllocator() const { return _descriptorAllocator.get(); }
+
+        /// @brief Sends bind group writes queued since the last flush to the driver in one call
+        void FlushDescriptorWrites();
+        [[nodiscard]] vk::PipelineCache GetPipelineCache() { return _pipelineCache.get(); }
+        [[nodiscard]] BindlessTable* GetBindlessTable() const { return _bindlessTable.get(); }
+        /// @brief The set index bind groups start at, the bindless table takes set 0 when it's enabled
+        [[nodiscard]] uint32_t GetFirstBindGroupSet() const { return _bindlessTable ? 1 : 0; }
+        [[nodiscard]] PipelineCacheStats GetPipelineCacheStats();
       private:
         vk::UniqueInstance _instance;
         vk::PhysicalDevice _gpu;
         vk::UniqueDevice _device;
         std::unordered_map<Graphics::GPUQueueType, GPUQueue> _queues;
         VmaAllocator _allocator{};
+        std::unique_ptr<MemoryPools> _memoryPools;
+        bool _memoryBudgetSupported = false;
+        bool _blockCompressionSupported = false;
+
+        struct DefragmentationState
+        {
+            VmaDefragmentationContext context = nullptr;
+            VmaDefragmentationPassMoveInfo pass{};
+            bool passPending = false;
+            uint32_t passFrame = 0;
+            /// @brief Buffers replaced during the pending pass, destroyed once its copies have finished
+            std::vector<vk::Buffer> retiredBuffers;
+            uint32_t moves = 0;
+            u64 bytesMoved = 0;
+        } _defragmentation;
         vk::UniqueCommandPool _commandPool;
         std::vector<vk::UniqueCommandBuffer> _commandBuffers;
+        std::vector<vk::UniqueFence> _frameFences;
         vk::UniqueFence _immediateFence;
         vk::UniqueCommandBuffer _immediateCommandBuffer;
-        vk::UniqueDescriptorPool _descriptorPool;
+        std::unique_ptr<DescriptorAllocator> _descriptorAllocator;
+        std::unique_ptr<DescriptorWriter> _descriptorWriter;
+        std::vector<std::vector<Graphics::GPUBindGroupHandle>> _transientBindGroups =
+            std::vector<std::vector<Graphics::GPUBindGroupHandle>>(FramesInFlight);
+        /// @brief Pipelines replaced by a rebuild, destroyed once the frame slot they were last used in comes around
+        std::vector<std::vector<vk::UniquePipeline>> _retiredPipelines =
+            std::vector<std::vector<vk::UniquePipeline>>(FramesInFlight);
+        bool _bindless = false;
+        std::unique_ptr<BindlessTable> _bindlessTable;
+        vk::UniquePipelineCache _pipelineCache;
+        std::string _pipelineCachePath;
+        PipelineCacheStats _pipelineCacheStats;
+        std::mutex _pipelineCacheStatsMutex;
+        std::unique_ptr<Tools::ThreadPool> _pipelineCompiler;
+
+        // Identical descriptions share one reference counted resource
+        Graphics::ResourceCache<Graphics::GFXPipelineDesc> _sharedPipelines;
+        Graphics::ResourceCache<Graphics::GFXPipelineLayoutDesc> _sharedPipelineLayouts;
+        Graphics::ResourceCache<Graphics::GPUBindGroupLayoutDesc> _sharedBindGroupLayouts;
+        Graphics::ResourceCache<Graphics::GPUSamplerDesc> _sharedSamplers;
         uint32_t _frame = 0;
+        /// @brief Set from Encode to EndEncoding, between frames _frame is already the slot of the next frame
+        bool _encoding = false;
 
         void CreateInstance();
         void GetPhysicalDevice(const Graphics::RenderDeviceDesc& desc);
@@ -115,6 +253,26 @@ namespace Cocoa::Vulkan {
         void CreateCommandPool();
         void CreateCommandBuffers();
         void CreateImmediateResources();
-        void CreateDescriptorPool();
+        void CreateDescriptorAllocator();
+        void CreateBindlessTable();
+        void CreatePipelineCache();
+        void SavePipelineCache();
+        [[nodiscard]] bool IsPipelineCacheCompatible(const std::vector<char>& cacheData) const;
+        [[nodiscard]] std::unique_ptr<PipelineBuildState> BuildPipelineState(const Graphics::GFXPipelineDesc& desc);
+        vk::UniquePipeline CompilePipeline(PipelineBuildState& state);
+        [[nodiscard]] vk::UniqueShaderModule LoadShaderModule(const Graphics::GFXShaderModuleDesc& desc);
+
+        DescriptorInfo
+        GetDescriptorInfo(const Graphics::GPUBindGroupLayoutEntry& layoutEntry, Graphics::GPUBindGroupEntry entry);
+        void WriteBindGroup(
+            vk::DescriptorSet set, const BindGroupLayout& layout,
+            const std::vector<Graphics::GPUBindGroupEntry>& entries
+        );
+
+        void StepDefragmentation(vk::CommandBuffer commandBuffer);
+        void EndDefragmentationPass();
+        [[nodiscard]] VmaDefragmentationMove* FindDefragmentationMove(VmaAllocation allocation);
+
+        static vk::ImageCreateInfo GetImageDescriptor(const Graphics::GPUTextureDesc& desc);
     };
 } // namespace Cocoa::Vulkan
@@ -15,68 +15,218 @@ namespace Cocoa::Vulkan {
     }
 
     void RenderEncoderImpl::TransitionTextureState(
-        Graphics::GPUTextureHandle& texture, const Graphics::GPUTextureState newState
+        Graphics::GPUTextureHandle& texture, const Graphics::GPUTextureState newState,
+        const Graphics::GPUTextureSubresourceRange& range
     )
     {
         const auto textureInstance = _device.GetTexture(texture);
-        const auto oldLayout = GPUTextureLayoutToVk(textureInstance->layout);
-        const auto newLayout = GPUTextureLayoutToVk(newState);
-        const auto [oldStage, oldAccess] = GetLayoutInfo(oldLayout);
-        const auto [newStage, newAccess] = GetLayoutInfo(newLayout);
-
-        vk::ImageSubresourceRange transitionSubresourceRange{};
-        transitionSubresourceRange.setAspectMask(InferAspectMasks(textureInstance->format))
-            .setBaseArrayLayer(0)
-            .setLayerCount(textureInstance->layers)
-            .setBaseMipLevel(0)
-            .setLevelCount(textureInstance->levels);
-        vk::ImageMemoryBarrier2 transition{};
-        transition.setImage(textureInstance->image)
-            .setSrcStageMask(oldStage)
-            .setSrcAccessMask(oldAccess)
-            .setDstStageMask(newStage)
-            .setDstAccessMask(newAccess)
-            .setOldLayout(oldLayout)
-            .setNewLayout(newLayout)
-            .setSubresourceRange(transitionSubresourceRange);
-        vk::DependencyInfo dependencyDescriptor{};
-        dependencyDescriptor.setImageMemoryBarriers(transition);
-        _cmd.pipelineBarrier2(dependencyDescriptor);
-        textureInstance->layout = newState;
+        if (!textureInstance) {
+            PUSH_WARN("Tried to transition an invalid texture");
+            return;
+        }
+        QueueTextureTransition(*textureInstance, newState, range);
     }
 
     void RenderEncoderImpl::UploadBufferDataToTexture(
         Graphics::GPUBufferHandle& srcBuffer, Graphics::GPUTextureHandle& dstTexture
     )
     {
-        const auto buffer = _device.GetBuffer(srcBuffer);
-        const auto texture = _device.GetTexture(dstTexture);
+        UploadBufferDataToTextures({{.srcBuffer = srcBuffer, .dstTexture = dstTexture}});
+    }
+
+    void RenderEncoderImpl::UploadBufferDataToTextures(const std::vector<Graphics::GPUTextureUpload>& uploads)
+    {
+        struct ResolvedUpload
+        {
+            Buffer* buffer;
+            Texture* texture;
+            Graphics::GPUTextureState finalState;
+        };
+
+        // Resolve everything and remember where each subresource has to end up before any state changes,
+        // so uploads that share a texture still see its original state
+        std::vector<ResolvedUpload> resolvedUploads;
+        resolvedUploads.reserve(uploads.size());
+        for (auto upload : uploads) {
+            const auto buffer = _device.GetBuffer(upload.srcBuffer);
+            const auto texture = _device.GetTexture(upload.dstTexture);
+            if (!buffer || !texture) {
+                PANIC("Tried to upload with an invalid buffer or texture");
+            }
+
+            // Copies address whole blocks of compressed formats, so every level has to start on a block
+            if (std::holds_alternative<Graphics::GPUColorFormat>(texture->format)) {
+                const auto block = Graphics::GetColorFormatBlock(std::get<Graphics::GPUColorFormat>(texture->format));
+                if (block.bytes != 0 && upload.bufferOffset % block.bytes != 0) {
+                    PANIC(
+                        "Texture upload offset %llu isn't aligned to the %u byte format block",
+                        static_cast<unsigned long long>(upload.bufferOffset), block.bytes
+                    );
+                }
+            }
+
+            auto finalState = texture->GetState(upload.level, upload.layer);
+            if (finalState == Graphics::GPUTextureState::Unknown ||
+                finalState == Graphics::GPUTextureState::TransferDst) {
+                finalState = Graphics::GPUTextureState::ShaderReadOnly;
+            }
+            resolvedUploads.push_back({buffer, texture, finalState});
+        }
 
-        const auto oldTextureLayout = texture->layout;
-        TransitionTextureState(dstTexture, Graphics::GPUTextureState::TransferDst);
+        for (usize i = 0; i < uploads.size(); i++) {
+            const auto& upload = uploads[i];
+            QueueTextureTransition(
+                *resolvedUploads[i].texture, Graphics::GPUTextureState::TransferDst,
+                {.firstLevel = upload.level, .levels = 1, .firstLayer = upload.layer, .layers = 1}
+            );
+        }
+        FlushBarriers();
 
-        vk::ImageSubresourceLayers uploadSubresourceLayers{};
-        uploadSubresourceLayers.setAspectMask(InferAspectMasks(texture->format))
-            .setMipLevel(0)
-            .setBaseArrayLayer(0)
-            .setLayerCount(1);
+        // Consecutive uploads between the same buffer and texture (e.g. a whole mip chain) share one copy
+        std::vector<vk::BufferImageCopy> regions;
+        for (usize i = 0; i < uploads.size(); i++) {
+            const auto& upload = uploads[i];
+            const auto& [buffer, texture, finalState] = resolvedUploads[i];
 
-        vk::BufferImageCopy region{};
-        region.setBufferOffset(0)
-            .setBufferRowLength(0)
-            .setBufferImageHeight(0)
-            .setImageOffset(vk::Offset3D(0, 0, 0))
-            .setImageExtent(vk::Extent3D(texture->extent.w, texture->extent.h, texture->extent.d))
-            .setImageSubresource(uploadSubresourceLayers);
+            vk::ImageSubresourceLayers uploadSubresourceLayers{};
+            uploadSubresourceLayers.setAspectMask(InferAspectMasks(texture->format))
+                .setMipLevel(upload.level)
+                .setBaseArrayLayer(upload.layer)
+                .setLayerCount(1);
 
-        _cmd.copyBufferToImage(buffer->buffer, texture->image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
+            // Level extents that aren't a multiple of the block size are allowed since they reach the image edge,
+            // the rows in the buffer are then packed in whole blocks
+            vk::BufferImageCopy region{};
+            region.setBufferOffset(upload.bufferOffset)
+                .setBufferRowLength(0)
+                .setBufferImageHeight(0)
+                .setImageOffset(vk::Offset3D(0, 0, 0))
+                .setImageExtent(
+                    vk::Extent3D(
+                        std::max(texture->extent.w >> upload.level, 1u),
+                        std::max(texture->extent.h >> upload.level, 1u),
+                        std::max(texture->extent.d >> upload.level, 1u)
+                    )
+                )
+                .setImageSubresource(uploadSubresourceLayers);
+            regions.push_back(region);
 
-        auto finalLayout = oldTextureLayout;
-        if (finalLayout == Graphics::GPUTextureState::Unknown) {
-            finalLayout = Graphics::GPUTextureState::ShaderReadOnly;
+            const bool lastForPair = i + 1 == uploads.size() || resolvedUploads[i + 1].buffer != buffer ||
+                                     resolvedUploads[i + 1].texture != texture;
+            if (lastForPair) {
+                _cmd.copyBufferToImage(buffer->buffer, texture->image, vk::ImageLayout::eTransferDstOptimal, regions);
+                regions.clear();
+            }
         }
 
-        TransitionTextureState(dstTexture, finalLayout);
+        for (usize i = 0; i < uploads.size(); i++) {
+            const auto& upload = uploads[i];
+            QueueTextureTransition(
+                *resolvedUploads[i].texture, resolvedUploads[i].finalState,
+                {.firstLevel = upload.level, .levels = 1, .firstLayer = upload.layer, .layers = 1}
+            );
+        }
+    }
+
+    void RenderEncoderImpl::GenerateMipmaps(
+        Graphics::GPUTextureHandle& texture, const Graphics::GPUTextureState finalState
+    )
+    {
+        const auto textureInstance = _device.GetTexture(texture);
+        if (!textureInstance) {
+            PUSH_WARN("Tried to generate mipmaps for an invalid texture");
+            return;
+        }
+        auto& target = *textureInstance;
+        if (!std::holds_alternative<Graphics::GPUColorFormat>(target.format)) {
+            PANIC("Mipmaps can only be generated for color textures");
+        }
+        if (!(target.usage & Graphics::GPUTextureUsage::TransferSrc) ||
+            !(target.usage & Graphics::GPUTextureUsage::TransferDst)) {
+            PANIC("Generating mipmaps needs a texture with TransferSrc and TransferDst usage");
+        }
+
+        const auto format = GPUColorFormatToVk(std::get<Graphics::GPUColorFormat>(target.format));
+        const auto features = _device.GetGPU().getFormatProperties(format).optimalTilingFeatures;
+        if (!(features & vk::FormatFeatureFlagBits::eBlitSrc) || !(features & vk::FormatFeatureFlagBits::eBlitDst)) {
+            PANIC("Texture format %d can't be blitted", static_cast<int>(format));
+        }
+        const bool linear = static_cast<bool>(features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear);
+        const auto filter = linear ? vk::Filter::eLinear : vk::Filter::eNearest;
+
+        if (target.levels < 2) {
+            QueueTextureTransition(target, finalState, {});
+            return;
+        }
+
+        // Level 0 is only read and the rest are written before they are read, so every level changes state
+        // once up front, once between its blits and once at the end
+        QueueTextureTransition(target, Graphics::GPUTextureState::TransferSrc, {.firstLevel = 0, .levels = 1});
+        QueueTextureTransition(target, Graphics::GPUTextureState::TransferDst, {.firstLevel = 1});
+        FlushBarriers();
+
+        auto levelOffset = [&](const u32 level) {
+            return vk::Offset3D(
+                static_cast<int32_t>(std::max(target.extent.w >> level, 1u)),
+                static_cast<int32_t>(std::max(target.extent.h >> level, 1u)),
+                static_cast<int32_t>(std::max(target.extent.d >> level, 1u))
+            );
+        };
+
+        for (u32 level = 1; level < target.levels; level++) {
+            vk::ImageSubresourceLayers srcSubresource{};
+            srcSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor)
+                .setMipLevel(level - 1)
+                .setBaseArrayLayer(0)
+                .setLayerCount(target.layers);
+            vk::ImageSubresourceLayers dstSubresource = srcSubresource;
+            dstSubresource.setMipLevel(level);
+
+            vk::ImageBlit2 blitRegion{};
+            blitRegion.setSrcSubresource(srcSubresource)
+                .setSrcOffsets({vk::Offset3D(0, 0, 0), levelOffset(level - 1)})
+                .setDstSubresource(dstSubresource)
+                .setDstOffsets({vk::Offset3D(0, 0, 0), levelOffset(level)});
+
+            vk::BlitImageInfo2 blitDescriptor{};
+            blitDescriptor.setSrcImage(target.image)
+                .setSrcImageLayout(vk::ImageLayout::eTransferSrcOptimal)
+                .setDstImage(target.image)
+                .setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
+                .setRegions(blitRegion)
+                .setFilter(filter);
+            _cmd.blitImage2(blitDescriptor);
+
+            // The last level is never read from, it goes straight to the final state below
+            if (level + 1 < target.levels) {
+                QueueTextureTransition(
+                    target, Graphics::GPUTextureState::TransferSrc, {.firstLevel = level, .levels = 1}
+                );
+                FlushBarriers();
+            }
+        }
+
+        // Leaves two barriers, one for the levels that were read and one for the last level
+        QueueTextureTransition(target, finalState, {});
+    }
+
+    void RenderEncoderImpl::CopyBufferToBuffer(
+        Graphics::GPUBufferHandle& srcBuffer, Graphics::GPUBufferHandle& dstBuffer, const u64 size,
+        const u64 srcOffset, const u64 dstOffset
+    )
+    {
+        const auto src = _device.GetBuffer(srcBuffer);
+        const auto dst = _device.GetBuffer(dstBuffer);
+        if (!src || !dst) {
+            PANIC("Tried to copy with an invalid buffer");
+        }
+        if (srcOffset + size > src->size || dstOffset + size > dst->size) {
+            PANIC("Tried to copy %llu bytes outside of a buffer", static_cast<unsigned long long>(size));
+        }
+
+        // Back to back copies share one barrier, which is fine as long as they write different ranges
+        _cmd.copyBuffer(src->buffer, dst->buffer, vk::BufferCopy(srcOffset, dstOffset, size));
+        _pendingCopyBarrier = true;
     }
 
     void RenderEncoderImpl::StartRenderPass(const Graphics::GPUPassDesc& renderPassDescriptor)
@@ -139,12 +289,37 @@ namespace Cocoa::Vulkan {
             .setViewMask(renderPassDescriptor.viewMask)
             .setLayerCount(renderPassDescriptor.layerCount);
 
+        FlushBarriers();
         _cmd.beginRendering(renderDescriptor);
     }
     void RenderEncoderImpl::SetRenderPipeline(Graphics::GFXRenderPipelineHandle& renderPipeline)
     {
-        _cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, _device.GetPipeline(renderPipeline)->renderPipeline.get());
-        _state.currentPipeline = &renderPipeline;
+        _state.currentPipeline = renderPipeline;
+        _state.skipDraws = false;
+
+        if (!_device.IsRenderPipelineReady(renderPipeline)) {
+            // Fall back to the placeholder while the real pipeline compiles, or drop draws if there isn't one
+            auto placeholder = _device.GetPipeline(renderPipeline)->placeholder;
+            if (!placeholder.IsValid() || !_device.IsRenderPipelineReady(placeholder)) {
+                _state.skipDraws = true;
+                return;
+            }
+            _state.currentPipeline = placeholder;
+        }
+
+        const auto pipeline = _device.GetPipeline(_state.currentPipeline);
+        _cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->renderPipeline.get());
+
+        // The table stays bound across pipelines sharing a layout, so it's only rebound when the layout changes
+        if (const auto bindlessTable = _device.GetBindlessTable()) {
+            const auto pipelineLayout = _device.GetPipelineLayout(pipeline->pipelineLayout)->pipelineLayout.get();
+            if (pipelineLayout != _bindlessLayout) {
+                _cmd.bindDescriptorSets(
+                    vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, bindlessTable->GetSet(), nullptr
+                );
+                _bindlessLayout = pipelineLayout;
+            }
+        }
     }
     void RenderEncoderImpl::SetOutputTransform(const Graphics::OutputTransform& outputTransform)
     {
@@ -161,25 +336,57 @@ namespace Cocoa::Vulkan {
             0, vk::Rect2D({renderArea.offset.x, renderArea.offset.y}, {renderArea.scale.w, renderArea.scale.h})
         );
     }
-    void RenderEncoderImpl::SetVertexBuffer(Graphics::GPUBufferHandle& vertexBuffer)
+    void RenderEncoderImpl::SetVertexBuffer(Graphics::GPUBufferHandle& vertexBuffer, const u64 offset)
     {
         const vk::Buffer buffers[] = {_device.GetBuffer(vertexBuffer)->buffer};
-        constexpr vk::DeviceSize offsets[] = {0};
+        const vk::DeviceSize offsets[] = {offset};
         _cmd.bindVertexBuffers(0, 1, buffers, offsets);
     }
-    void RenderEncoderImpl::SetIndexBuffer(Graphics::GPUBufferHandle& indexBuffer)
+    void RenderEncoderImpl::SetIndexBuffer(
+        Graphics::GPUBufferHandle& indexBuffer, const u64 offset, const Graphics::GPUIndexFormat format
+    )
     {
-        _cmd.bindIndexBuffer(_device.GetBuffer(indexBuffer)->buffer, 0, vk::IndexType::eUint16);
+        _cmd.bindIndexBuffer(_device.GetBuffer(indexBuffer)->buffer, offset, GPUIndexFormatToVk(format));
     }
     void RenderEncoderImpl::SetBindGroup(Graphics::GPUBindGroupHandle& bindGroup)
     {
-        const auto currentPipeline = _device.GetPipeline(*_state.currentPipeline);
+        // A set has to be fully written before it's bound
+        _device.FlushDescriptorWrites();
+        const auto currentPipeline = _device.GetPipeline(_state.currentPipeline);
         const auto set = _device.GetBindGroup(bindGroup);
         _cmd.bindDescriptorSets(
             vk::PipelineBindPoint::eGraphics,
-            _device.GetPipelineLayout(currentPipeline->pipelineLayout)->pipelineLayout.get(), 0, set->set.get(), nullptr
+            _device.GetPipelineLayout(currentPipeline->pipelineLayout)->pipelineLayout.get(),
+            _device.GetFirstBindGroupSet(), set->set, nullptr
+        );
+    }
+    void RenderEncoderImpl::SetPushConstants(
+        const Graphics::GPUShaderStage visibility, const void* data, const u32 size, const u32 offset
+    )
+    {
+        const auto currentPipeline = _device.GetPipeline(_state.currentPipeline);
+        _cmd.pushConstants(
+            _device.GetPipelineLayout(currentPipeline->pipelineLayout)->pipelineLayout.get(),
+            GPUShaderStageToVk(visibility), offset, size, data
         );
     }
+    void RenderEncoderImpl::Draw(
+        const u32 vertexCount, const u32 instanceCount, const u32 firstVertex, const u32 firstInstance
+    )
+    {
+        if (_state.skipDraws)
+            return;
+        _cmd.draw(vertexCount, instanceCount, firstVertex, firstInstance);
+    }
+    void RenderEncoderImpl::DrawIndexed(
+        const u32 indexCount, const u32 instanceCount, const u32 firstIndex, const i32 vertexOffset,
+        const u32 firstInstance
+    )
+    {
+        if (_state.skipDraws)
+            return;
+        _cmd.drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    }
     void RenderEncoderImpl::EndRenderPass()
     {
         _cmd.endRendering();
@@ -187,8 +394,146 @@ namespace Cocoa::Vulkan {
     }
     void RenderEncoderImpl::Stop()
     {
+        FlushBarriers();
         _cmd.end();
         _cmd = nullptr;
         _active = false;
     }
+
+    void RenderEncoderImpl::QueueTextureTransition(
+        Texture& texture, const Graphics::GPUTextureState newState, const Graphics::GPUTextureSubresourceRange& range
+    )
+    {
+        const uint32_t firstLevel = std::min(range.firstLevel, texture.levels);
+        const uint32_t lastLevel =
+            range.levels == u32Max ? texture.levels : std::min(firstLevel + range.levels, texture.levels);
+        const uint32_t firstLayer = std::min(range.firstLayer, texture.layers);
+        const uint32_t lastLayer =
+            range.layers == u32Max ? texture.layers : std::min(firstLayer + range.layers, texture.layers);
+        if (firstLevel >= lastLevel || firstLayer >= lastLayer)
+            return;
+
+        // Walk every layer and emit one barrier per run of mips that share a state,
+        // runs that line up across layers are merged in QueueImageBarrier
+        for (uint32_t layer = firstLayer; layer < lastLayer; layer++) {
+            uint32_t runStart = firstLevel;
+            for (uint32_t level = firstLevel; level <= lastLevel; level++) {
+                if (level < lastLevel && texture.GetState(level, layer) == texture.GetState(runStart, layer))
+                    continue;
+
+                const auto oldState = texture.GetState(runStart, layer);
+                if (oldState != newState || !IsReadOnlyTextureState(newState)) {
+                    QueueImageBarrier(texture, oldState, newState, runStart, level - runStart, layer);
+                }
+                runStart = level;
+            }
+
+            for (uint32_t level = firstLevel; level < lastLevel; level++) {
+                texture.SetState(level, layer, newState);
+            }
+        }
+    }
+
+    void RenderEncoderImpl::QueueImageBarrier(
+        const Texture& texture, const Graphics::GPUTextureState oldState, const Graphics::GPUTextureState newState,
+        const uint32_t level, const uint32_t levelCount, const uint32_t layer
+    )
+    {
+        const auto oldLayout = GPUTextureLayoutToVk(oldState);
+        const auto newLayout = GPUTextureLayoutToVk(newState);
+        const auto [newStage, newAccess] = GetLayoutInfo(newLayout);
+
+        // Barriers inside one dependency don't execute in order, so a subresource may only appear once per flush
+        bool overlapsPending = false;
+        for (auto& pending : _pendingImageBarriers) {
+            if (pending.image != texture.image)
+                continue;
+
+            auto& pendingRange = pending.subresourceRange;
+            const bool levelsOverlap = pendingRange.baseMipLevel < level + levelCount &&
+                                       level < pendingRange.baseMipLevel + pendingRange.levelCount;
+            const bool layersOverlap =
+                pendingRange.baseArrayLayer <= layer && layer < pendingRange.baseArrayLayer + pendingRange.layerCount;
+            if (!levelsOverlap || !layersOverlap)
+                continue;
+
+            // No command has run since this barrier was queued, so a second transition
+            // of the exact same subresources folds into the first one
+            if (pendingRange.baseMipLevel == level && pendingRange.levelCount == levelCount &&
+                pendingRange.layerCount == 1 && pending.newLayout == oldLayout) {
+                pending.setNewLayout(newLayout).setDstStageMask(newStage).setDstAccessMask(newAccess);
+                return;
+            }
+            overlapsPending = true;
+            break;
+        }
+
+        if (overlapsPending) {
+            FlushBarriers();
+        } else {
+            // Extend a barrier of the previous layer when it is doing the exact same transition
+            for (auto& pending : _pendingImageBarriers) {
+                auto& pendingRange = pending.subresourceRange;
+                if (pending.image == texture.image && pendingRange.baseMipLevel == level &&
+                    pendingRange.levelCount == levelCount &&
+                    pendingRange.baseArrayLayer + pendingRange.layerCount == layer && pending.oldLayout == oldLayout &&
+                    pending.newLayout == newLayout) {
+                    pendingRange.layerCount++;
+                    return;
+                }
+            }
+        }
+
+        auto [oldStage, oldAccess] = GetLayoutInfo(oldLayout);
+
+        // An aliased texture takes over memory that an earlier resource may still be writing to
+        if (texture.aliased && oldLayout == vk::ImageLayout::eUndefined) {
+            oldStage = vk::PipelineStageFlagBits2::eAllCommands;
+            oldAccess = vk::AccessFlagBits2::eMemoryWrite;
+        }
+
+        vk::ImageSubresourceRange transitionSubresourceRange{};
+        transitionSubresourceRange.setAspectMask(InferAspectMasks(texture.format))
+            .setBaseArrayLayer(layer)
+            .setLayerCount(1)
+            .setBaseMipLevel(level)
+            .setLevelCount(levelCount);
+        vk::ImageMemoryBarrier2 transition{};
+        transition.setImage(texture.image)
+            .setSrcStageMask(oldStage)
+            .setSrcAccessMask(oldAccess)
+            .setDstStageMask(newStage)
+            .setDstAccessMask(newAccess)
+            .setOldLayout(oldLayout)
+            .setNewLayout(newLayout)
+            .setSubresourceRange(transitionSubresourceRange);
+        _pendingImageBarriers.push_back(transition);
+    }
+
+    void RenderEncoderImpl::FlushBarriers()
+    {
+        if (_pendingImageBarriers.empty() && !_pendingCopyBarrier)
+            return;
+
+        vk::MemoryBarrier2 copyBarrier{};
+        copyBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eCopy)
+            .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+            .setDstStageMask(
+                vk::PipelineStageFlagBits2::eVertexAttributeInput | vk::PipelineStageFlagBits2::eIndexInput |
+                vk::PipelineStageFlagBits2::eCopy
+            )
+            .setDstAccessMask(
+                vk::AccessFlagBits2::eVertexAttributeRead | vk::AccessFlagBits2::eIndexRead |
+                vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite
+            );
+
+        vk::DependencyInfo dependencyDescriptor{};
+        dependencyDescriptor.setImageMemoryBarriers(_pendingImageBarriers);
+        if (_pendingCopyBarrier) {
+            dependencyDescriptor.setMemoryBarriers(copyBarrier);
+        }
+        _cmd.pipelineBarrier2(dependencyDescriptor);
+        _pendingImageBarriers.clear();
+        _pendingCopyBarrier = false;
+    }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "../../graphics/core/render_encoder.h"
+#include "../resources/texture.h"
 #include "../utils/common.h"
 
 namespace Cocoa::Vulkan {
@@ -17,17 +18,34 @@ namespace Cocoa::Vulkan {
             RenderDeviceImpl& device, vk::CommandBuffer commandBuffer, const Graphics::RenderEncoderDesc& desc
         );
         ~RenderEncoderImpl() override = default;
-        void TransitionTextureState(Graphics::GPUTextureHandle& texture, Graphics::GPUTextureState newState) override;
+        void TransitionTextureState(
+            Graphics::GPUTextureHandle& texture, Graphics::GPUTextureState newState,
+            const Graphics::GPUTextureSubresourceRange& range
+        ) override;
         void UploadBufferDataToTexture(
             Graphics::GPUBufferHandle& srcBuffer, Graphics::GPUTextureHandle& dstTexture
         ) override;
+        void UploadBufferDataToTextures(const std::vector<Graphics::GPUTextureUpload>& uploads) override;
+        void GenerateMipmaps(Graphics::GPUTextureHandle& texture, Graphics::GPUTextureState finalState) override;
+        void CopyBufferToBuffer(
+            Graphics::GPUBufferHandle& srcBuffer, Graphics::GPUBufferHandle& dstBuffer, u64 size, u64 srcOffset,
+            u64 dstOffset
+        ) override;
         void StartRenderPass(const Graphics::GPUPassDesc& renderPassDescriptor) override;
         void SetRenderPipeline(Graphics::GFXRenderPipelineHandle& renderPipeline) override;
         void SetOutputTransform(const Graphics::OutputTransform& outputTransform) override;
         void SetRenderArea(const Graphics::RenderArea& renderArea) override;
-        void SetVertexBuffer(Graphics::GPUBufferHandle& vertexBuffer) override;
-        void SetIndexBuffer(Graphics::GPUBufferHandle& indexBuffer) override;
+        void SetVertexBuffer(Graphics::GPUBufferHandle& vertexBuffer, u64 offset) override;
+        void SetIndexBuffer(
+            Graphics::GPUBufferHandle& indexBuffer, u64 offset, Graphics::GPUIndexFormat format
+        ) override;
         void SetBindGroup(Graphics::GPUBindGroupHandle& bindGroup) override;
+        using RenderEncoder::SetPushConstants;
+        void SetPushConstants(Graphics::GPUShaderStage visibility, const void* data, u32 size, u32 offset) override;
+        void Draw(u32 vertexCount, u32 instanceCount, u32 firstVertex, u32 firstInstance) override;
+        void DrawIndexed(
+            u32 indexCount, u32 instanceCount, u32 firstIndex, i32 vertexOffset, u32 firstInstance
+        ) override;
         void EndRenderPass() override;
         void Stop() override;
 
@@ -37,8 +55,22 @@ namespace Cocoa::Vulkan {
         RenderDeviceImpl& _device;
         vk::CommandBuffer _cmd;
         Graphics::GPUQueueType _submitQueueType;
+        std::vector<vk::ImageMemoryBarrier2> _pendingImageBarriers;
+        /// @brief Set after a buffer copy until a barrier makes it visible
+        bool _pendingCopyBarrier = false;
+        /// @brief Layout the bindless table was last bound with
+        vk::PipelineLayout _bindlessLayout;
 
         bool _active = false;
+
+        void QueueTextureTransition(
+            Texture& texture, Graphics::GPUTextureState newState, const Graphics::GPUTextureSubresourceRange& range
+        );
+        void QueueImageBarrier(
+            const Texture& texture, Graphics::GPUTextureState oldState, Graphics::GPUTextureState newState,
+            uint32_t level, uint32_t levelCount, uint32_t layer
+        );
+        void FlushBarriers();
     };
 
 } // namespace Cocoa::Vulkan
\ No newline at end of file
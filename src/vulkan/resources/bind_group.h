@@ -9,6 +9,9 @@
 namespace Cocoa::Vulkan {
     struct BindGroup
     {
-        vk::UniqueDescriptorSet set;
+        vk::DescriptorSet set;
+        vk::DescriptorSetLayout layout;
+        /// @brief Transient sets are reclaimed with their frame instead of being released on destroy
+        bool transient = false;
     };
 }
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../utils/common.h"
+
+namespace Cocoa::Vulkan {
+    struct BindGroupLayout
+    {
+        vk::UniqueDescriptorSetLayout layout;
+        std::vector<Graphics::GPUBindGroupLayoutEntry> entries;
+        /// @brief Writes a whole bind group from an array of DescriptorInfo, one per entry in declaration order
+        vk::UniqueDescriptorUpdateTemplate updateTemplate;
+    };
+}
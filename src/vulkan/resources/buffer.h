@@ -12,6 +12,9 @@ namespace Cocoa::Vulkan {
         vk::Buffer buffer;
         void* mapped = nullptr;
         uint64_t size;
+        vk::BufferUsageFlags usage;
         VmaAllocation allocation;
+        /// @brief Slot in the bindless buffer array, u32Max when the buffer isn't in the table
+        uint32_t bindlessIndex = u32Max;
     };
 }
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "../utils/common.h"
+
+namespace Cocoa::Vulkan {
+    struct MemoryHeap
+    {
+        VmaAllocation allocation;
+        uint64_t size;
+    };
+}
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <future>
+
+#include "../../graphics/utils/descriptors.h"
 #include "../utils/common.h"
 
 namespace Cocoa::Vulkan {
@@ -11,5 +14,11 @@ namespace Cocoa::Vulkan {
     {
         vk::UniquePipeline renderPipeline;
         Graphics::GFXPipelineLayoutHandle pipelineLayout;
+        /// @brief Valid while the pipeline is still compiling on a worker thread
+        std::future<vk::UniquePipeline> pendingPipeline;
+        /// @brief Bound in place of this pipeline until it's ready
+        Graphics::GFXRenderPipelineHandle placeholder = Graphics::GFXRenderPipelineHandle(u64Max);
+        /// @brief Kept so the pipeline can be rebuilt in place once its shaders are reloaded
+        Graphics::GFXPipelineDesc desc;
     };
 }
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../utils/common.h"
+
+namespace Cocoa::Vulkan {
+    struct Sampler
+    {
+        vk::UniqueSampler sampler;
+        /// @brief Slot in the bindless sampler array, u32Max when the sampler isn't in the table
+        uint32_t bindlessIndex = u32Max;
+    };
+}
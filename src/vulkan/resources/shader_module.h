@@ -0,0 +1,11 @@
+#pragma once
+
+#include "../utils/common.h"
+
+namespace Cocoa::Vulkan {
+    struct ShaderModule
+    {
+        vk::UniqueShaderModule module;
+        std::string path;
+    };
+}
@@ -13,10 +13,24 @@ namespace Cocoa::Vulkan {
         VmaAllocation allocation;
         vk::Image image;
         std::variant<Graphics::GPUColorFormat, Graphics::GPUDepthStencilFormat> format;
-        Graphics::GPUTextureState layout = Graphics::GPUTextureState::Unknown;
         Graphics::Scale3D extent;
         uint32_t levels;
         uint32_t layers;
+        Graphics::GPUTextureUsage usage = Graphics::GPUTextureUsage::Unknown;
         bool allocatedImage = false;
+        bool aliased = false;
+
+        /// @brief Current state of every subresource, indexed by layer * levels + level
+        std::vector<Graphics::GPUTextureState> states;
+
+        [[nodiscard]] Graphics::GPUTextureState GetState(const uint32_t level, const uint32_t layer) const
+        {
+            return states[layer * levels + level];
+        }
+
+        void SetState(const uint32_t level, const uint32_t layer, const Graphics::GPUTextureState state)
+        {
+            states[layer * levels + level] = state;
+        }
     };
-}
\ No newline at end of file
+}
@@ -11,5 +11,7 @@ namespace Cocoa::Vulkan {
     {
         vk::UniqueImageView view;
         Graphics::GPUTextureAspect aspect;
+        /// @brief Slot in the bindless texture array, u32Max when the view isn't in the table
+        uint32_t bindlessIndex = u32Max;
     };
 }
\ No newline at end of file
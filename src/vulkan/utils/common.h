@@ -98,14 +98,37 @@ namespace Cocoa::Vulkan {
         switch (format) {
         case Graphics::GPUColorFormat::Unknown:      return vk::Format::eUndefined;
         case Graphics::GPUColorFormat::BGRA8_SRGB:   return vk::Format::eB8G8R8A8Srgb;
+        case Graphics::GPUColorFormat::R32_Float:    return vk::Format::eR32Sfloat;
         case Graphics::GPUColorFormat::RG32_Float:   return vk::Format::eR32G32Sfloat;
         case Graphics::GPUColorFormat::RGB32_Float:  return vk::Format::eR32G32B32Sfloat;
         case Graphics::GPUColorFormat::RGBA32_Float: return vk::Format::eR32G32B32A32Sfloat;
         case Graphics::GPUColorFormat::RGBA8_Unorm:  return vk::Format::eR8G8B8A8Unorm;
+        case Graphics::GPUColorFormat::RGBA8_SRGB:   return vk::Format::eR8G8B8A8Srgb;
+        case Graphics::GPUColorFormat::RG16_Float:   return vk::Format::eR16G16Sfloat;
+        case Graphics::GPUColorFormat::RGBA16_Float: return vk::Format::eR16G16B16A16Sfloat;
+        case Graphics::GPUColorFormat::RG16_Snorm:   return vk::Format::eR16G16Snorm;
+        case Graphics::GPUColorFormat::RGBA16_Snorm: return vk::Format::eR16G16B16A16Snorm;
+        case Graphics::GPUColorFormat::BC1_Unorm:    return vk::Format::eBc1RgbaUnormBlock;
+        case Graphics::GPUColorFormat::BC1_SRGB:     return vk::Format::eBc1RgbaSrgbBlock;
+        case Graphics::GPUColorFormat::BC3_Unorm:    return vk::Format::eBc3UnormBlock;
+        case Graphics::GPUColorFormat::BC3_SRGB:     return vk::Format::eBc3SrgbBlock;
+        case Graphics::GPUColorFormat::BC4_Unorm:    return vk::Format::eBc4UnormBlock;
+        case Graphics::GPUColorFormat::BC5_Unorm:    return vk::Format::eBc5UnormBlock;
+        case Graphics::GPUColorFormat::BC7_Unorm:    return vk::Format::eBc7UnormBlock;
+        case Graphics::GPUColorFormat::BC7_SRGB:     return vk::Format::eBc7SrgbBlock;
         default:                                     return vk::Format::eUndefined;
         }
     }
 
+    inline vk::IndexType GPUIndexFormatToVk(const Graphics::GPUIndexFormat format)
+    {
+        switch (format) {
+        case Graphics::GPUIndexFormat::Uint16: return vk::IndexType::eUint16;
+        case Graphics::GPUIndexFormat::Uint32: return vk::IndexType::eUint32;
+        default:                               return vk::IndexType::eUint16;
+        }
+    }
+
     inline vk::Format GPUDepthStencilFormatToVk(const Graphics::GPUDepthStencilFormat format)
     {
         switch (format) {
@@ -119,6 +142,15 @@ namespace Cocoa::Vulkan {
         }
     }
 
+    inline vk::Format GPUTextureFormatToVk(
+        const std::variant<Graphics::GPUColorFormat, Graphics::GPUDepthStencilFormat>& format
+    )
+    {
+        if (std::holds_alternative<Graphics::GPUDepthStencilFormat>(format))
+            return GPUDepthStencilFormatToVk(std::get<Graphics::GPUDepthStencilFormat>(format));
+        return GPUColorFormatToVk(std::get<Graphics::GPUColorFormat>(format));
+    }
+
     inline vk::Filter GPUFilterToVk(const Graphics::GPUFilter filter)
     {
         switch (filter) {
@@ -183,10 +215,42 @@ namespace Cocoa::Vulkan {
         case vk::Format::eR32G32B32Sfloat:    return Graphics::GPUColorFormat::RGB32_Float;
         case vk::Format::eR32G32B32A32Sfloat: return Graphics::GPUColorFormat::RGBA32_Float;
         case vk::Format::eR8G8B8A8Unorm:      return Graphics::GPUColorFormat::RGBA8_Unorm;
+        case vk::Format::eR8G8B8A8Srgb:       return Graphics::GPUColorFormat::RGBA8_SRGB;
+        case vk::Format::eR16G16Sfloat:       return Graphics::GPUColorFormat::RG16_Float;
+        case vk::Format::eR16G16B16A16Sfloat: return Graphics::GPUColorFormat::RGBA16_Float;
+        case vk::Format::eR16G16Snorm:        return Graphics::GPUColorFormat::RG16_Snorm;
+        case vk::Format::eR16G16B16A16Snorm:  return Graphics::GPUColorFormat::RGBA16_Snorm;
+        case vk::Format::eBc1RgbaUnormBlock:  return Graphics::GPUColorFormat::BC1_Unorm;
+        case vk::Format::eBc1RgbaSrgbBlock:   return Graphics::GPUColorFormat::BC1_SRGB;
+        case vk::Format::eBc3UnormBlock:      return Graphics::GPUColorFormat::BC3_Unorm;
+        case vk::Format::eBc3SrgbBlock:       return Graphics::GPUColorFormat::BC3_SRGB;
+        case vk::Format::eBc4UnormBlock:      return Graphics::GPUColorFormat::BC4_Unorm;
+        case vk::Format::eBc5UnormBlock:      return Graphics::GPUColorFormat::BC5_Unorm;
+        case vk::Format::eBc7UnormBlock:      return Graphics::GPUColorFormat::BC7_Unorm;
+        case vk::Format::eBc7SrgbBlock:       return Graphics::GPUColorFormat::BC7_SRGB;
         default:                              return Graphics::GPUColorFormat::Unknown;
         }
     }
 
+    /// @brief States that are only ever read from, moving between two of these needs no barrier
+    inline bool IsReadOnlyTextureState(const Graphics::GPUTextureState state)
+    {
+        switch (state) {
+        case Graphics::GPUTextureState::DepthStencilReadOnly:
+        case Graphics::GPUTextureState::ShaderReadOnly:
+        case Graphics::GPUTextureState::TransferSrc:
+        case Graphics::GPUTextureState::Present:              return true;
+        default:                                              return false;
+        }
+    }
+
+    inline vk::SampleCountFlagBits GPUSamplingCountToVk(const Graphics::GPUSamplingCount samples)
+    {
+        if (samples == Graphics::GPUSamplingCount::None)
+            return vk::SampleCountFlagBits::e1;
+        return static_cast<vk::SampleCountFlagBits>(static_cast<uint32_t>(samples));
+    }
+
     inline vk::PrimitiveTopology GPUTopologyToVk(const Graphics::GPUTopology topology)
     {
         switch (topology) {